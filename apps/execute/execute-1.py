@@ -35,7 +35,7 @@
 #
 ##########################################################################
 
-import os, sys, traceback
+import os, sys, json, traceback
 
 import IECore
 
@@ -94,6 +94,19 @@ class execute( Gaffer.Application ) :
 					allowEmptyList = False,
 				),
 
+				IECore.BoolParameter(
+					name = "worker",
+					description = "Runs as a persistent worker process, loading the script "
+						"once and then executing batches of tasks as they are requested "
+						"on stdin. Each request is a single line containing a JSON object "
+						"with \"nodes\", \"frames\" and \"context\" items, "
+						"equivalent to the parameters of the same name. After each request "
+						"has been executed, the result code is written to stdout as a single "
+						"line. This is used by the LocalDispatcher to avoid the cost of "
+						"launching a new process for each batch.",
+					defaultValue = False,
+				),
+
 				IECore.StringVectorParameter(
 					name = "context",
 					description = "The context used during execution. Note that the frames "
@@ -128,9 +141,21 @@ class execute( Gaffer.Application ) :
 
 		self.root()["scripts"].addChild( scriptNode )
 
+		if args["worker"].value :
+			return self.__serve( scriptNode )
+
+		return self.__execute(
+			scriptNode,
+			args["nodes"],
+			self.parameters()["frames"].getFrameListValue().asList(),
+			args["context"],
+		)
+
+	def __execute( self, scriptNode, nodeNames, frames, contextArgs ) :
+
 		nodes = []
-		if len( args["nodes"] ) :
-			for nodeName in args["nodes"] :
+		if len( nodeNames ) :
+			for nodeName in nodeNames :
 				node = scriptNode.descendant( nodeName )
 				if node is None :
 					IECore.msg( IECore.Msg.Level.Error, "gaffer execute", "Node \"%s\" does not exist" % nodeName )
@@ -147,16 +172,14 @@ class execute( Gaffer.Application ) :
 				IECore.msg( IECore.Msg.Level.Error, "gaffer execute", "Script has no executable nodes" )
 				return 1
 
-		if len(args["context"]) % 2 :
+		if len( contextArgs ) % 2 :
 			IECore.msg( IECore.Msg.Level.Error, "gaffer execute", "Context parameter must have matching entry/value pairs" )
 			return 1
 
 		context = Gaffer.Context( scriptNode.context() )
-		for i in range( 0, len(args["context"]), 2 ) :
-			entry = args["context"][i].lstrip( "-" )
-			context[entry] = eval( args["context"][i+1] )
-
-		frames = self.parameters()["frames"].getFrameListValue().asList()
+		for i in range( 0, len( contextArgs ), 2 ) :
+			entry = contextArgs[i].lstrip( "-" )
+			context[entry] = eval( contextArgs[i+1] )
 
 		with context :
 			for node in nodes :
@@ -177,4 +200,37 @@ class execute( Gaffer.Application ) :
 
 		return 0
 
+	def __serve( self, scriptNode ) :
+
+		# Results are written to the original stdout, and anything
+		# the tasks themselves output is redirected to stderr so that
+		# it can't be mistaken for a result.
+		sys.stdout.flush()
+		results = os.fdopen( os.dup( sys.stdout.fileno() ), "w" )
+		os.dup2( sys.stderr.fileno(), sys.stdout.fileno() )
+
+		# The script remains loaded between requests, so the
+		# caches stay warm from one batch to the next.
+		for line in iter( sys.stdin.readline, "" ) :
+
+			# Requests are JSON, so that each one is framed as a
+			# single line. Note that the context values are still
+			# Python expressions, which `__execute()` evaluates
+			# exactly as it does for the `-context` parameter, so
+			# requests must only come from a trusted dispatcher.
+			# We convert the strings back from unicode for the
+			# benefit of the Gaffer bindings.
+			request = json.loads( line )
+			result = self.__execute(
+				scriptNode,
+				[ str( n ) for n in request["nodes"] ],
+				IECore.FrameList.parse( str( request["frames"] ) ).asList(),
+				[ str( c ) for c in request["context"] ],
+			)
+
+			results.write( "%d\n" % result )
+			results.flush()
+
+		return 0
+
 IECore.registerRunTimeTyped( execute )
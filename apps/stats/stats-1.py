@@ -70,11 +70,25 @@ class stats( Gaffer.Application ) :
 			gaffer stats fileName.gfr -scene NameOfNode -performanceMonitor
 			```
 
+			To measure the cost of outputting a scene to a renderer, without
+			the renderer itself doing any work :
+
+			```
+			gaffer stats fileName.gfr -scene NameOfNode -sceneRenderer Null
+			```
+
 			To run an image processing node using the performance monitor :
 
 			```
 			gaffer stats fileName.gfr -image NameOfNode -performanceMonitor
 			```
+
+			To write a trace of the processes performed while generating
+			a scene, for viewing in the `chrome://tracing` timeline viewer :
+
+			```
+			gaffer stats fileName.gfr -scene NameOfNode -traceFile trace.json
+			```
 			"""
 		)
 
@@ -102,6 +116,14 @@ class stats( Gaffer.Application ) :
 					defaultValue = "",
 				),
 
+				IECore.StringParameter(
+					name = "sceneRenderer",
+					description = "The name of a renderer to output the scene to, "
+						"in addition to traversing it. The \"Null\" renderer may be "
+						"used to measure the cost of scene output in isolation.",
+					defaultValue = "",
+				),
+
 				IECore.StringParameter(
 					name = "image",
 					description = "The name of an ImageNode or ImagePlug to examine.",
@@ -122,6 +144,17 @@ class stats( Gaffer.Application ) :
 					defaultValue = 50,
 				),
 
+				IECore.FileNameParameter(
+					name = "traceFile",
+					description = "Turns on a trace monitor, writing the start and end "
+						"time of every process on every thread to the specified file. "
+						"The file is in the Trace Event format, and may be viewed as "
+						"a timeline using the chrome://tracing viewer.",
+					defaultValue = "",
+					allowEmptyString = True,
+					extensions = "json",
+				),
+
 			]
 
 		)
@@ -139,6 +172,11 @@ class stats( Gaffer.Application ) :
 		else :
 			self.__performanceMonitor = None
 
+		if args["traceFile"].value :
+			self.__traceMonitor = Gaffer.TraceMonitor()
+		else :
+			self.__traceMonitor = None
+
 		self.__timers = collections.OrderedDict()
 		self.__memory = collections.OrderedDict()
 
@@ -185,10 +223,17 @@ class stats( Gaffer.Application ) :
 
 		print ""
 
+		self.__printCache()
+
+		print ""
+
 		self.__printPerformance( script, args )
 
 		print
 
+		if self.__traceMonitor is not None :
+			self.__traceMonitor.writeTrace( args["traceFile"].value )
+
 	def __printVersion( self, script ) :
 
 		numbers = [ Gaffer.Metadata.nodeValue( script, "serialiser:" + x + "Version" ) for x in ( "milestone", "major", "minor", "patch" ) ]
@@ -281,11 +326,24 @@ class stats( Gaffer.Application ) :
 
 		memory = _Memory.maxRSS()
 		with _Timer() as sceneTimer :
-			with self.__performanceMonitor or _NullContextManager() :
+			with self.__performanceMonitor or _NullContextManager(), self.__traceMonitor or _NullContextManager() :
 				GafferSceneTest.traverseScene( scene )
 		self.__timers["Scene generation"] = sceneTimer
 		self.__memory["Scene generation"] = _Memory.maxRSS() - memory
 
+		if args["sceneRenderer"].value :
+
+			render = GafferScene.Preview.Render()
+			render["in"].setInput( scene )
+			render["renderer"].setValue( args["sceneRenderer"].value )
+
+			memory = _Memory.maxRSS()
+			with _Timer() as outputTimer :
+				with self.__performanceMonitor or _NullContextManager(), self.__traceMonitor or _NullContextManager() :
+					render["task"].execute()
+			self.__timers["Scene output"] = outputTimer
+			self.__memory["Scene output"] = _Memory.maxRSS() - memory
+
 		## \todo Calculate and print scene stats
 		#  - Locations
 		#  - Unique objects, attributes etc
@@ -305,7 +363,7 @@ class stats( Gaffer.Application ) :
 
 		memory = _Memory.maxRSS()
 		with _Timer() as sceneTimer :
-			with self.__performanceMonitor or _NullContextManager() :
+			with self.__performanceMonitor or _NullContextManager(), self.__traceMonitor or _NullContextManager() :
 				GafferImageTest.processTiles( image )
 		self.__timers["Image generation"] = sceneTimer
 		self.__memory["Image generation"] = _Memory.maxRSS() - memory
@@ -339,6 +397,38 @@ class stats( Gaffer.Application ) :
 		print "Memory :\n"
 		self.__printItems( items )
 
+	def __printCache( self ) :
+
+		items = [
+			( "Compute cache limit", _Memory( Gaffer.ValuePlug.getCacheMemoryLimit() ) ),
+			( "Compute cache usage", _Memory( Gaffer.ValuePlug.cacheMemoryUsage() ) ),
+			( "Compute cache evictions", Gaffer.ValuePlug.cacheEvictions() ),
+			( "", "" ),
+			( "Hash cache limit", Gaffer.ValuePlug.getHashCacheSizeLimit() ),
+			( "Hash cache usage", Gaffer.ValuePlug.hashCacheTotalUsage() ),
+			( "Hash cache evictions", Gaffer.ValuePlug.hashCacheEvictions() ),
+		]
+
+		if self.__performanceMonitor is not None :
+
+			statistics = self.__performanceMonitor.allStatistics().values()
+			computeHits = sum( s.computeCacheHits for s in statistics )
+			computeMisses = sum( s.computeCount for s in statistics )
+			hashHits = sum( s.hashCacheHits for s in statistics )
+			hashMisses = sum( s.hashCount for s in statistics )
+
+			items[3:3] = [
+				( "Compute cache hits", computeHits ),
+				( "Compute cache misses", computeMisses ),
+			]
+			items.extend( [
+				( "Hash cache hits", hashHits ),
+				( "Hash cache misses", hashMisses ),
+			] )
+
+		print "Cache :\n"
+		self.__printItems( items )
+
 	def __printStatisticsItems( self, script, stats, key, n ) :
 
 		stats.sort( key = key, reverse = True )
@@ -80,6 +80,7 @@ class test( Gaffer.Application ) :
 	def _run( self, args ) :
 
 		import unittest
+		import GafferTest
 
 		testSuite = unittest.TestSuite()
 		if args["testCases"] :
@@ -90,7 +91,6 @@ class test( Gaffer.Application ) :
 
 		else :
 
-			import GafferTest
 			import GafferUITest
 			import GafferSceneTest
 			import GafferImageTest
@@ -102,7 +102,7 @@ class test( Gaffer.Application ) :
 				testSuite.addTest( moduleTestSuite )
 
 		for i in range( 0, args["repeat"].value ) :
-			testRunner = unittest.TextTestRunner( verbosity=2 )
+			testRunner = GafferTest.TestRunner( verbosity=2 )
 			testResult = testRunner.run( testSuite )
 			if not testResult.wasSuccessful() :
 				return 1
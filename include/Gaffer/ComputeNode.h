@@ -41,6 +41,7 @@
 #include "IECore/MurmurHash.h"
 
 #include "Gaffer/DependencyNode.h"
+#include "Gaffer/ValuePlug.h"
 
 namespace Gaffer
 {
@@ -77,6 +78,13 @@ class ComputeNode : public DependencyNode
 		/// Called to compute the values for output Plugs. Must be implemented to compute
 		/// an appropriate value and apply it using output->setValue().
 		virtual void compute( ValuePlug *output, const Context *context ) const = 0;
+		/// Called to determine how the result of compute() is cached for the specified
+		/// output. The default implementation returns ValuePlug::TaskCollaboration, which
+		/// is safe for all computes. Derived classes may return ValuePlug::Standard for
+		/// computes which are guaranteed not to spawn TBB tasks, or ValuePlug::Uncached
+		/// for computes which are cheap enough that caching is not worthwhile. Note that
+		/// outputs without the Plug::Cacheable flag are never cached, regardless of policy.
+		virtual ValuePlug::CachePolicy computeCachePolicy( const ValuePlug *output ) const;
 
 	private :
 
@@ -37,7 +37,10 @@
 #ifndef GAFFER_CONTEXT_H
 #define GAFFER_CONTEXT_H
 
+#include "tbb/spin_rw_mutex.h"
+
 #include "boost/container/flat_map.hpp"
+#include "boost/container/flat_set.hpp"
 #include "boost/signals.hpp"
 
 #include "IECore/InternedString.h"
@@ -104,7 +107,13 @@ class Context : public IECore::RefCounted
 		/// using Borrowed provides the best performance, and because the original
 		/// context is const and outlives the temporary context, the constraints
 		/// required of client code are met with little effort.
-		Context( const Context &other, Ownership ownership = Copied );
+		///
+		/// By default, reads from the new context are attributed to any computation
+		/// the original is being used for (see ReadRecorder). Copies which are stored
+		/// for use after that computation has completed, or which are only used to
+		/// inspect the context without affecting the result, should pass
+		/// `tracked = false` instead.
+		Context( const Context &other, Ownership ownership = Copied, bool tracked = true );
 		~Context();
 
 		IE_CORE_DECLAREMEMBERPTR( Context )
@@ -137,6 +146,9 @@ class Context : public IECore::RefCounted
 		void changed( const IECore::InternedString &name );
 
 		/// Fills the specified vector with the names of all items in the Context.
+		/// \note Because this exposes every variable to the caller, any computation
+		/// calling it is considered to depend on every variable in the context.
+		/// See ValuePlug::hash() for more details.
 		void names( std::vector<IECore::InternedString> &names ) const;
 
 		/// @name Time
@@ -171,6 +183,8 @@ class Context : public IECore::RefCounted
 		/// A signal emitted when an element of the context is changed.
 		ChangedSignal &changedSignal();
 
+		/// \note Any computation calling this is considered to depend on
+		/// every variable in the context. See ValuePlug::hash() for more details.
 		IECore::MurmurHash hash() const;
 
 		bool operator == ( const Context &other ) const;
@@ -234,8 +248,81 @@ class Context : public IECore::RefCounted
 		/// Returns the current context for the calling thread.
 		static const Context *current();
 
+		/// Records the variables read from a context, and from any copies
+		/// made of it, for as long as the ReadRecorder exists. This includes
+		/// reads made by upstream computations, and those implied by cache
+		/// hits, so may be used to determine whether or not a plug's value
+		/// depends on a particular variable.
+		class ReadRecorder;
+
 	private :
 
+		friend class ValuePlug;
+
+		// Records the names of the variables read from a context during a
+		// computation. ValuePlug uses this to determine which variables a hash
+		// actually depends on, so that cache entries may be shared between
+		// contexts which differ only in unrelated variables. Reads are recorded
+		// locally, and merged into the parent tracker in a single operation by
+		// mergeIntoParent() when the computation is complete, so that the
+		// variables read by an upstream computation are also recorded for the
+		// downstream computation which triggered it.
+		class DependencyTracker : public IECore::RefCounted
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( DependencyTracker )
+
+				typedef boost::container::flat_set<IECore::InternedString> Names;
+
+				DependencyTracker( DependencyTracker *parent );
+
+				// Clears everything read so far, and replaces the parent,
+				// so that the tracker may be reused for another computation.
+				void reset( DependencyTracker *parent );
+
+				void read( const IECore::InternedString &name );
+				void read( const Names &names );
+				// Records a dependency on every variable in the context.
+				void readAll();
+
+				// Fills names with the variables read so far, returning
+				// false if readAll() has been called.
+				bool names( Names &names ) const;
+				// Returns true if everything read so far is contained
+				// in names.
+				bool readOnly( const Names &names ) const;
+
+				// Records everything read so far with the parent tracker.
+				// Should be called once, after the computation is complete.
+				void mergeIntoParent() const;
+
+			private :
+
+				Ptr m_parent;
+				// Reads are typically of variables which have been read
+				// already, so we use a reader-writer lock to avoid
+				// contention between threads in that case.
+				typedef tbb::spin_rw_mutex Mutex;
+				mutable Mutex m_mutex;
+				Names m_names;
+				bool m_all;
+
+		};
+
+		// Reinitialises the context as a Borrowed copy of other, reusing
+		// the existing storage. This allows ValuePlug to reuse temporary
+		// contexts rather than allocate new ones for every computation.
+		void borrow( const Context &other );
+
+		// Returns a hash of only the specified variables, including the
+		// absence of any which don't exist. Unlike hash(), this does not
+		// record a dependency on the variables.
+		IECore::MurmurHash variablesHash( const DependencyTracker::Names &names ) const;
+		// Implementation of hash(), without dependency recording.
+		IECore::MurmurHash hashInternal() const;
+
 		void substituteInternal( const char *s, std::string &result, const int recursionDepth, unsigned substitutions ) const;
 
 		// Storage for each entry.
@@ -248,17 +335,47 @@ class Context : public IECore::RefCounted
 			// And use this ownership flag to tell us when we need to do explicit
 			// reference count management.
 			Ownership ownership;
+			// Hash of the data, computed lazily by Context::hash(). A default
+			// constructed hash means that it has not been computed yet. Storing
+			// this per entry means that when a single variable is changed, we
+			// don't need to rehash the data for all the others.
+			mutable IECore::MurmurHash hash;
 		};
 
 		typedef boost::container::flat_map<IECore::InternedString, Storage> Map;
 
 		Map m_map;
 		ChangedSignal *m_changedSignal;
+		// Inherited by copies, so that reads from the temporary contexts
+		// made during a computation are tracked too.
+		DependencyTracker::Ptr m_dependencyTracker;
 		mutable IECore::MurmurHash m_hash;
 		mutable bool m_hashValid;
 
 };
 
+class Context::ReadRecorder : boost::noncopyable
+{
+
+	public :
+
+		/// Modifies the context, so must not be constructed or
+		/// destroyed while other threads are using it.
+		ReadRecorder( Context *context );
+		~ReadRecorder();
+
+		/// Returns true if the variable has been read, or
+		/// if the whole context has been read (for instance
+		/// by a call to Context::hash()).
+		bool read( const IECore::InternedString &name ) const;
+
+	private :
+
+		Context *m_context;
+		DependencyTracker::Ptr m_previousTracker;
+
+};
+
 IE_CORE_DECLAREPTR( Context );
 
 } // namespace Gaffer
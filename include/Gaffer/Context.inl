@@ -181,6 +181,7 @@ void Context::set( const IECore::InternedString &name, const T &value )
 	Storage &s = m_map[name];
 	if( Accessor<T>().set( s, value ) )
 	{
+		s.hash = IECore::MurmurHash();
 		m_hashValid = false;
 		if( m_changedSignal )
 		{
@@ -192,6 +193,10 @@ void Context::set( const IECore::InternedString &name, const T &value )
 template<typename T>
 typename Context::Accessor<T>::ResultType Context::get( const IECore::InternedString &name ) const
 {
+	if( m_dependencyTracker )
+	{
+		m_dependencyTracker->read( name );
+	}
 	Map::const_iterator it = m_map.find( name );
 	if( it == m_map.end() )
 	{
@@ -203,6 +208,10 @@ typename Context::Accessor<T>::ResultType Context::get( const IECore::InternedSt
 template<typename T>
 typename Context::Accessor<T>::ResultType Context::get( const IECore::InternedString &name, typename Accessor<T>::ResultType defaultValue ) const
 {
+	if( m_dependencyTracker )
+	{
+		m_dependencyTracker->read( name );
+	}
 	Map::const_iterator it = m_map.find( name );
 	if( it == m_map.end() )
 	{
@@ -39,10 +39,13 @@
 
 #include "boost/noncopyable.hpp"
 
+#include "IECore/InternedString.h"
+
 namespace Gaffer
 {
 
 class Process;
+class Plug;
 
 /// Base class for monitoring node graph processes.
 class Monitor : boost::noncopyable
@@ -80,6 +83,11 @@ class Monitor : boost::noncopyable
 		virtual void processStarted( const Process *process ) = 0;
 		/// Implementations must be safe to call concurrently.
 		virtual void processFinished( const Process *process ) = 0;
+		/// Called when the result for a process of the specified type
+		/// is retrieved from a cache, so that the process itself need not
+		/// be performed. The default implementation does nothing.
+		/// Implementations must be safe to call concurrently.
+		virtual void cacheHit( const IECore::InternedString &processType, const Plug *plug );
 
 };
 
@@ -55,9 +55,11 @@ enum PerformanceMetric
 	PerHashDuration,
 	PerComputeDuration,
 	HashesPerCompute,
+	HashCacheHits,
+	ComputeCacheHits,
 
 	First = HashCount,
-	Last = HashesPerCompute
+	Last = ComputeCacheHits
 };
 
 std::string formatStatistics( const PerformanceMonitor &monitor, size_t maxLinesPerMetric = 50 );
@@ -54,7 +54,8 @@ namespace Gaffer
 IE_CORE_FORWARDDECLARE( Plug )
 
 /// A monitor which collects statistics about the frequency
-/// of hash and compute processes per plug.
+/// of hash and compute processes per plug, and the effectiveness
+/// of the caches which avoid them.
 class PerformanceMonitor : public Monitor
 {
 
@@ -70,13 +71,25 @@ class PerformanceMonitor : public Monitor
 				size_t hashCount = 0,
 				size_t computeCount = 0,
 				boost::chrono::nanoseconds hashDuration = boost::chrono::nanoseconds( 0 ),
-				boost::chrono::nanoseconds computeDuration = boost::chrono::nanoseconds( 0 )
+				boost::chrono::nanoseconds computeDuration = boost::chrono::nanoseconds( 0 ),
+				size_t hashCacheHits = 0,
+				size_t computeCacheHits = 0
 			);
 
+			/// The number of hash processes, which is also the number
+			/// of misses in the hash cache.
 			size_t hashCount;
+			/// The number of compute processes, which is also the number
+			/// of misses in the compute cache.
 			size_t computeCount;
 			boost::chrono::nanoseconds hashDuration;
 			boost::chrono::nanoseconds computeDuration;
+			/// The number of hashes retrieved from the hash cache.
+			size_t hashCacheHits;
+			/// The number of values retrieved from the compute cache,
+			/// including those shared with a concurrent compute on
+			/// another thread.
+			size_t computeCacheHits;
 
 			Statistics & operator += ( const Statistics &rhs );
 
@@ -94,6 +107,7 @@ class PerformanceMonitor : public Monitor
 
 		virtual void processStarted( const Process *process );
 		virtual void processFinished( const Process *process );
+		virtual void cacheHit( const IECore::InternedString &processType, const Plug *plug );
 
 	private :
 
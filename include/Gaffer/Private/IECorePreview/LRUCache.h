@@ -89,7 +89,8 @@ class LRUCache : private boost::noncopyable
 
 		/// Adds an item to the cache directly, bypassing the GetterFunction.
 		/// Returns true for success and false on failure - failure can occur
-		/// if the cost exceeds the maximum cost for the cache. Note that even
+		/// if the cost exceeds the maximum cost for the cache, in which case
+		/// any existing item for the key is removed. Note that even
 		/// when true is returned, the item may be removed from the cache by a
 		/// subsequent (or concurrent) operation.
 		bool set( const Key &key, const Value &value, Cost cost );
@@ -98,6 +99,11 @@ class LRUCache : private boost::noncopyable
 		/// return value may be invalidated immediately by operations performed
 		/// by another thread.
 		bool cached( const Key &key ) const;
+		/// As above, but also retrieves the value if it is cached, marking it
+		/// as recently used. Unlike get(), this never creates an entry for the
+		/// key or calls the GetterFunction, so it may be used to probe the cache
+		/// before deciding which key to set() a value with.
+		bool cached( const Key &key, Value &value );
 
 		/// Erases the item if it was cached. Returns true if it was cached
 		/// and false if it wasn't cached and therefore wasn't removed.
@@ -118,6 +124,13 @@ class LRUCache : private boost::noncopyable
 		/// Returns the current cost of all cached items.
 		Cost currentCost() const;
 
+		/// Returns the total number of items which have been discarded
+		/// in order to keep within the maximum cost. Items removed by
+		/// erase() and clear() are not counted. This is useful for
+		/// determining whether or not the maximum cost is large enough
+		/// to hold the working set.
+		size_t evictions() const;
+
 	private :
 
 		// Data
@@ -353,6 +366,7 @@ class LRUCache : private boost::noncopyable
 		typedef tbb::atomic<Cost> AtomicCost;
 		AtomicCost m_currentCost;
 		Cost m_maxCost;
+		tbb::atomic<size_t> m_evictions;
 
 		// These methods set/erase a cached value, updating the current
 		// cost appropriately. The caller must hold the lock for the bin
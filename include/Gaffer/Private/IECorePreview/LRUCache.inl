@@ -62,6 +62,7 @@ LRUCache<Key, Value>::LRUCache( GetterFunction getter, Cost maxCost )
 	:	m_getter( getter ), m_removalCallback( nullRemovalCallback ), m_maxCost( maxCost )
 {
 	m_currentCost = 0;
+	m_evictions = 0;
 	for( size_t i = 0, e = tbb::tbb_thread::hardware_concurrency(); i < e; ++i )
 	{
 		m_bins.push_back( boost::shared_ptr<Bin>( new Bin ) );
@@ -73,6 +74,7 @@ LRUCache<Key, Value>::LRUCache( GetterFunction getter, RemovalCallback removalCa
 	:	m_getter( getter ), m_removalCallback( removalCallback ), m_maxCost( maxCost )
 {
 	m_currentCost = 0;
+	m_evictions = 0;
 	for( size_t i = 0, e = tbb::tbb_thread::hardware_concurrency(); i < e; ++i )
 	{
 		m_bins.push_back( boost::shared_ptr<Bin>( new Bin ) );
@@ -115,6 +117,12 @@ typename LRUCache<Key, Value>::Cost LRUCache<Key, Value>::currentCost() const
 	return m_currentCost;
 }
 
+template<typename Key, typename Value>
+size_t LRUCache<Key, Value>::evictions() const
+{
+	return m_evictions;
+}
+
 template<typename Key, typename Value>
 Value LRUCache<Key, Value>::get( const Key& key )
 {
@@ -189,6 +197,19 @@ template<typename Key, typename Value>
 bool LRUCache<Key, Value>::set( const Key &key, const Value &value, Cost cost )
 {
 	Handle handle;
+	if( cost > m_maxCost )
+	{
+		// Don't leave an empty entry behind for an item we
+		// can't store, because nothing would ever remove it.
+		handle.acquire( this, key, /* write = */ true, /* createIfMissing = */ false );
+		if( handle.valid() )
+		{
+			eraseInternal( *handle );
+			handle.erase();
+		}
+		return false;
+	}
+
 	handle.acquire( this, key, /* write = */ true, /* createIfMissing = */ true );
 
 	const bool result = setInternal( *handle, value, cost );
@@ -207,6 +228,43 @@ bool LRUCache<Key, Value>::cached( const Key &key ) const
 	return handle.valid() && handle->second.status == Cached;
 }
 
+template<typename Key, typename Value>
+bool LRUCache<Key, Value>::cached( const Key &key, Value &value )
+{
+	Handle handle;
+	handle.acquire( this, key, /* write = */ false, /* createIfMissing = */ false );
+	if( !handle.valid() || handle->second.status != Cached )
+	{
+		return false;
+	}
+
+	if( handle->second.recentlyUsed )
+	{
+		value = handle->second.value;
+		return true;
+	}
+
+	// We need a write lock to update the recentlyUsed flag. If
+	// we had to give up our read lock to get it, another thread
+	// may have erased the item, and upgradeToWriter() will have
+	// created a new empty one in its place. We must remove that
+	// rather than leave it behind.
+	handle.upgradeToWriter();
+	CacheEntry &cacheEntry = handle->second;
+	if( cacheEntry.status != Cached )
+	{
+		if( cacheEntry.status == New )
+		{
+			handle.erase();
+		}
+		return false;
+	}
+
+	cacheEntry.recentlyUsed = true;
+	value = cacheEntry.value;
+	return true;
+}
+
 template<typename Key, typename Value>
 bool LRUCache<Key, Value>::erase( const Key &key )
 {
@@ -291,7 +349,10 @@ void LRUCache<Key, Value>::limitCost()
 	{
 		if( !handle->second.recentlyUsed )
 		{
-			eraseInternal( *handle );
+			if( eraseInternal( *handle ) )
+			{
+				m_evictions++;
+			}
 			handle.eraseAndIncrement();
 		}
 		else
@@ -94,6 +94,11 @@ class Process : public boost::noncopyable
 		/// we use C++11's current_exception() in our destructor perhaps?
 		void handleException();
 
+		/// Derived classes should call this when they are able
+		/// to retrieve a result from a cache rather than constructing
+		/// a process to compute it. Notifies any active monitors.
+		static void cacheHit( const IECore::InternedString &type, const Plug *plug );
+
 	private :
 
 		// Friendship allows monitors to register and deregister
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef GAFFER_TRACEMONITOR_H
+#define GAFFER_TRACEMONITOR_H
+
+#include <vector>
+#include <stack>
+#include <iosfwd>
+
+#include "tbb/enumerable_thread_specific.h"
+
+#include "boost/chrono.hpp"
+
+#include "IECore/RefCounted.h"
+#include "IECore/InternedString.h"
+
+#include "Gaffer/Monitor.h"
+
+namespace Gaffer
+{
+
+IE_CORE_FORWARDDECLARE( Plug )
+IE_CORE_FORWARDDECLARE( Context )
+
+/// A monitor which records the start and end time of every process
+/// on every thread, so that the evaluation of a graph can be
+/// inspected on a timeline. Whereas the PerformanceMonitor tells us
+/// where time is spent, the TraceMonitor tells us when and on
+/// which threads, revealing serialisation points and long tails.
+class TraceMonitor : public Monitor
+{
+
+	public :
+
+		TraceMonitor();
+		virtual ~TraceMonitor();
+
+		struct Event
+		{
+			/// The type of the process, for instance
+			/// "computeNode:hash" or "computeNode:compute".
+			IECore::InternedString type;
+			ConstPlugPtr plug;
+			/// A summary of the variables in the context the
+			/// process was performed in.
+			std::string context;
+			/// Times are relative to the construction
+			/// of the monitor.
+			boost::chrono::nanoseconds startTime;
+			boost::chrono::nanoseconds endTime;
+		};
+
+		typedef std::vector<Event> Events;
+
+		/// Returns the events recorded so far, with one
+		/// entry per thread that performed a process.
+		/// Must not be called while processes are running.
+		std::vector<Events> allEvents() const;
+
+		/// Writes the events recorded so far in the Trace Event
+		/// format, as used by the `chrome://tracing` viewer.
+		/// Must not be called while processes are running.
+		void writeTrace( std::ostream &stream ) const;
+		/// As above, but writing to the specified file.
+		void writeTrace( const std::string &fileName ) const;
+
+		/// Returns a human readable summary of the context.
+		/// This is used to fill Event::context. The variables
+		/// are read without being recorded as dependencies of
+		/// any hash in progress, so that tracing doesn't affect
+		/// the way hashes are cached.
+		static std::string contextSummary( const Context *context );
+
+	protected :
+
+		virtual void processStarted( const Process *process );
+		virtual void processFinished( const Process *process );
+
+	private :
+
+		// Events are recorded into thread local storage to
+		// avoid contention between threads.
+		struct ThreadData
+		{
+			Events events;
+			// Indices into events for the processes which
+			// are currently running.
+			std::stack<size_t> running;
+		};
+
+		tbb::enumerable_thread_specific<ThreadData, tbb::cache_aligned_allocator<ThreadData>, tbb::ets_key_per_instance> m_threadData;
+
+		const boost::chrono::high_resolution_clock::time_point m_startTime;
+
+};
+
+} // namespace Gaffer
+
+#endif // GAFFER_TRACEMONITOR_H
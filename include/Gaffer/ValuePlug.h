@@ -38,6 +38,8 @@
 #ifndef GAFFER_VALUEPLUG_H
 #define GAFFER_VALUEPLUG_H
 
+#include "tbb/spin_mutex.h"
+
 #include "IECore/Object.h"
 
 #include "Gaffer/Plug.h"
@@ -95,7 +97,12 @@ class ValuePlug : public Plug
 		virtual bool isSetToDefault() const;
 
 		/// Returns a hash to represent the value of this plug
-		/// in the current context.
+		/// in the current context. Hashes are cached, with the
+		/// cache being keyed only on the context variables that
+		/// ComputeNode::hash() has been observed to read (directly
+		/// or via upstream plugs). So a plug which doesn't depend
+		/// on "frame", for instance, is only hashed once for all
+		/// frames.
 		virtual IECore::MurmurHash hash() const;
 		/// Convenience function to append the hash to h.
 		void hash( IECore::MurmurHash &h ) const;
@@ -106,12 +113,61 @@ class ValuePlug : public Plug
 		/// of the cache.
 		////////////////////////////////////////////////////////////////////
 		//@{
+		/// Determines how the results of ComputeNode::compute() are cached,
+		/// and how concurrent requests for the same value are handled. The
+		/// policy for each output is specified by ComputeNode::computeCachePolicy().
+		enum CachePolicy
+		{
+			/// No caching is performed. Suitable for values which are
+			/// very cheap to compute, and which would otherwise evict more
+			/// expensive values from the cache.
+			Uncached,
+			/// Values are cached, and when several threads request the same
+			/// value concurrently, one thread computes it while the others
+			/// block until it is available. Suitable only for computes which
+			/// do not spawn TBB tasks directly - using it for a compute which
+			/// does may result in deadlock. Pulling on upstream values which use
+			/// the TaskCollaboration policy is fine, because those computes are
+			/// isolated from the tasks of the waiting threads.
+			Standard,
+			/// As for Standard, but waiting threads collaborate on any TBB
+			/// tasks spawned by the computing thread, and the compute is
+			/// isolated from unrelated tasks. Suitable for all computes, but
+			/// carries a small additional overhead.
+			TaskCollaboration,
+			/// Values are cached, but concurrent requests for the same value
+			/// each perform the compute independently.
+			Legacy
+		};
+
 		/// Returns the maximum amount of memory in bytes to use for the cache.
 		static size_t getCacheMemoryLimit();
 		/// Sets the maximum amount of memory the cache may use in bytes.
 		static void setCacheMemoryLimit( size_t bytes );
 		/// Returns the current memory usage of the cache in bytes.
 		static size_t cacheMemoryUsage();
+		/// Returns the number of values which have been evicted from the cache
+		/// to keep within the memory limit. If this is high relative to the
+		/// number of computes, then the limit may be too small.
+		static size_t cacheEvictions();
+		/// ValuePlug also maintains a cache of recently computed hashes,
+		/// shared between all threads. This avoids repeated calls to
+		/// ComputeNode::hash() when the same plug is queried many times
+		/// in the same context. Returns the maximum number of entries in
+		/// the hash cache.
+		static size_t getHashCacheSizeLimit();
+		/// Sets the maximum number of entries in the hash cache, discarding
+		/// the least recently used entries as necessary.
+		static void setHashCacheSizeLimit( size_t maxEntries );
+		/// Returns the number of entries currently in the hash cache.
+		static size_t hashCacheTotalUsage();
+		/// Returns the number of entries which have been evicted from the
+		/// hash cache to keep within the size limit.
+		static size_t hashCacheEvictions();
+		/// Clears the hash cache. Entries for dirtied plugs are invalidated
+		/// automatically, so this is only necessary when a hash depends on
+		/// some external resource which has changed.
+		static void clearHashCache();
 		//@}
 
 	protected :
@@ -162,6 +218,7 @@ class ValuePlug : public Plug
 		class HashProcess;
 		class ComputeProcess;
 		class SetValueAction;
+		struct HashDependencies;
 
 		void setValueInternal( IECore::ConstObjectPtr value, bool propagateDirtiness );
 		void childAddedOrRemoved();
@@ -169,9 +226,22 @@ class ValuePlug : public Plug
 		// ancestors, then does the same for its output plugs.
 		void emitPlugSet();
 
+		// Accessors for m_hashDependencies, for use by the HashProcess.
+		boost::intrusive_ptr<const HashDependencies> hashDependencies() const;
+		// Merges `dependencies` with the existing dependencies, returning the result.
+		boost::intrusive_ptr<const HashDependencies> addHashDependencies( boost::intrusive_ptr<HashDependencies> dependencies ) const;
+
 		IECore::ConstObjectPtr m_defaultValue;
 		// For holding the value of input plugs with no input connections.
 		IECore::ConstObjectPtr m_staticValue;
+		// Incremented by dirty(), and used to invalidate
+		// entries in the hash cache.
+		uint64_t m_dirtyCount;
+		// The context variables which have been found to affect
+		// our hash, used by the HashProcess to share hash cache
+		// entries between contexts. Reset by dirty().
+		mutable boost::intrusive_ptr<const HashDependencies> m_hashDependencies;
+		mutable tbb::spin_mutex m_hashDependenciesMutex;
 
 };
 
@@ -55,6 +55,18 @@ class Blur : public ImageProcessor
 
 		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( GafferImage::Blur, BlurTypeId, ImageProcessor );
 
+		enum Mode
+		{
+			/// Filters with a gaussian kernel, at a cost
+			/// per pixel proportional to the radius.
+			Accurate,
+			/// Approximates a gaussian using three successive
+			/// box filters, at a cost per pixel which is
+			/// independent of the radius. Suitable for very
+			/// large radii.
+			Fast
+		};
+
 		Gaffer::V2fPlug *radiusPlug();
 		const Gaffer::V2fPlug *radiusPlug() const;
 
@@ -64,6 +76,9 @@ class Blur : public ImageProcessor
 		Gaffer::BoolPlug *expandDataWindowPlug();
 		const Gaffer::BoolPlug *expandDataWindowPlug() const;
 
+		Gaffer::IntPlug *modePlug();
+		const Gaffer::IntPlug *modePlug() const;
+
 		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
 
 	protected :
@@ -88,6 +103,19 @@ class Blur : public ImageProcessor
 		Resample *resample();
 		const Resample *resample() const;
 
+		// Output plug holding the horizontal pass of the Fast mode for
+		// an entire row of tiles, computed with the tile origin set to
+		// ( 0, y ). Computing whole rows at once allows each pixel to be
+		// filtered at a cost independent of the radius.
+		Gaffer::FloatVectorDataPlug *horizontalStripPlug();
+		const Gaffer::FloatVectorDataPlug *horizontalStripPlug() const;
+
+		// Output plug holding the vertical pass of the Fast mode for an
+		// entire column of tiles, computed with the tile origin set to
+		// ( x, 0 ). Data is stored column by column.
+		Gaffer::FloatVectorDataPlug *verticalStripPlug();
+		const Gaffer::FloatVectorDataPlug *verticalStripPlug() const;
+
 		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
 
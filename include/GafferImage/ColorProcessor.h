@@ -67,6 +67,10 @@ class ColorProcessor : public ImageProcessor
 		/// Implemented to process the color data and stash the results on colorDataPlug()
 		/// format, dataWindow, metadata, and channelNames are passed through via direct connection to the input values.
 		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+		/// Implemented to avoid caching the channel data, since our implementation
+		/// of computeChannelData() simply copies data out of an intermediate plug
+		/// which is cached already.
+		virtual Gaffer::ValuePlug::CachePolicy computeCachePolicy( const Gaffer::ValuePlug *output ) const;
 		/// Implemented to use the results of colorDataPlug() via processColorData()
 		virtual IECore::ConstFloatVectorDataPtr computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
 
@@ -85,6 +89,11 @@ class ColorProcessor : public ImageProcessor
 		Gaffer::ObjectPlug *colorDataPlug();
 		const Gaffer::ObjectPlug *colorDataPlug() const;
 
+		// Fills chain with this node followed by the enabled ColorProcessors connected
+		// directly upstream of it, whose processing can be fused into our computation
+		// of colorDataPlug(). Returns the input plug at the head of the chain.
+		const ImagePlug *fusedChain( std::vector<const ColorProcessor *> &chain ) const;
+
 		static size_t g_firstPlugIndex;
 
 };
@@ -38,6 +38,8 @@
 #ifndef GAFFERIMAGE_DISPLAY_H
 #define GAFFERIMAGE_DISPLAY_H
 
+#include "tbb/spin_mutex.h"
+
 #include "IECore/DisplayDriverServer.h"
 
 #include "Gaffer/NumericPlug.h"
@@ -69,6 +71,14 @@ class Display : public ImageNode
 		/// Emitted when a complete image has been received.
 		static UnaryPlugSignal &imageReceivedSignal();
 
+		/// Dirties the output to reflect the data received since the last
+		/// call. The signals above are emitted on the thread receiving the
+		/// data, so it is the responsibility of the slots to arrange for this
+		/// to be called on the UI thread - see GafferImageUI.DisplayUI. When
+		/// only new buckets have been received, just the channel data is
+		/// dirtied, within an ImagePlug::DirtyRegionScope covering the buckets.
+		void applyReceivedData();
+
 	protected :
 
 		virtual void hashFormat( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
@@ -91,9 +101,18 @@ class Display : public ImageNode
 		IECore::DisplayDriverServerPtr m_server;
 		GafferDisplayDriverPtr m_driver;
 
+		// Data received but not yet applied by applyReceivedData().
+		// Written from the thread receiving the data.
+		tbb::spin_mutex m_receivedDataMutex;
+		bool m_receivedDriver;
+		Imath::Box2i m_receivedRegion;
+
 		Gaffer::IntPlug *updateCountPlug();
 		const Gaffer::IntPlug *updateCountPlug() const;
 
+		Gaffer::IntPlug *channelDataUpdateCountPlug();
+		const Gaffer::IntPlug *channelDataUpdateCountPlug() const;
+
 		void plugSet( Gaffer::Plug *plug );
 		void setupServer();
 		void driverCreated( GafferDisplayDriver *driver );
@@ -39,6 +39,7 @@
 
 #include <vector>
 #include "OpenEXR/ImathBox.h"
+#include "OpenEXR/ImathMatrix.h"
 
 namespace GafferImage
 {
@@ -131,6 +132,22 @@ void parallelGatherTiles(
 	TileOrder tileOrder = Unordered
 );
 
+/// Transform concatenation
+/// =======================
+///
+/// Rather than resampling the image once per node, ImageTransform and
+/// Resize concatenate the transforms of any ImageTransform, Resize and
+/// Offset nodes directly upstream of them, and resample once from the
+/// input at the head of the chain.
+///
+/// Walks upstream from `image` through the chain of such nodes, returning
+/// the input at the head of the chain and filling `matrix` with the
+/// transform from it to `image`. Disabled nodes are skipped, and the walk
+/// stops at the first node whose transform isn't an axis-aligned scale
+/// and translation, since that is all a Resample can apply in one pass.
+/// Returns `image` itself if there is nothing to concatenate.
+const ImagePlug *concatenatedTransformInput( const ImagePlug *image, Imath::M33f &matrix );
+
 } // namespace GafferImage
 
 #include "GafferImage/ImageAlgo.inl"
@@ -116,6 +116,11 @@ class ImageNode : public Gaffer::ComputeNode
 		/// Implemented to call the compute*() methods below whenever output is part of an ImagePlug.
 		/// Derived classes should reimplement the specific compute*() methods rather than compute() itself.
 		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+		/// Implemented to use the Standard policy for everything other than the channel
+		/// data, since it is cheap to compute and never spawns tasks. Derived classes
+		/// which spawn tasks when computing the format, data window, metadata or channel
+		/// names must reimplement this to return TaskCollaboration for those plugs.
+		virtual Gaffer::ValuePlug::CachePolicy computeCachePolicy( const Gaffer::ValuePlug *output ) const;
 		/// Compute methods for the individual children of outPlug() - these must be implemented by derived classes, or
 		/// an input connection must be made to the plug, so that the method is not called.
 		virtual GafferImage::Format computeFormat( const Gaffer::Context *context, const ImagePlug *parent ) const;
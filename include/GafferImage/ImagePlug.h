@@ -38,6 +38,8 @@
 #ifndef GAFFER_IMAGEPLUG_H
 #define GAFFER_IMAGEPLUG_H
 
+#include "boost/noncopyable.hpp"
+
 #include "IECore/ImagePrimitive.h"
 
 #include "Gaffer/TypedObjectPlug.h"
@@ -125,6 +127,13 @@ class ImagePlug : public Gaffer::ValuePlug
 		//@{
 		IECore::ConstFloatVectorDataPtr channelData( const std::string &channelName, const Imath::V2i &tileOrigin ) const;
 		IECore::MurmurHash channelDataHash( const std::string &channelName, const Imath::V2i &tileOrigin ) const;
+		/// Fetches several channels of the same tile, reusing a single temporary
+		/// Context. This is more efficient than calling channelData() repeatedly,
+		/// and is intended for operations which process several channels (typically
+		/// RGBA) together. The results are returned in the same order as channelNames.
+		void channelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin, std::vector<IECore::ConstFloatVectorDataPtr> &channelData ) const;
+		/// Returns a single hash combining the hashes for all the specified channels.
+		IECore::MurmurHash channelDataHash( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin ) const;
 		/// Returns a pointer to an IECore::ImagePrimitive. Note that the image's
 		/// coordinate system will be converted to the OpenEXR and Cortex specification
 		/// and have it's origin in the top left of it's display window with the positive
@@ -148,6 +157,42 @@ class ImagePlug : public Gaffer::ValuePlug
 			return tileOrigin;
 		}
 
+		/// @name Dirty regions
+		/// Dirty propagation applies to entire plugs, so when channelDataPlug()
+		/// is dirtied, clients must generally assume that every tile has changed.
+		/// When a node knows that only part of its output has changed, it may
+		/// declare the region using a DirtyRegionScope while dirtying the plug.
+		/// Slots connected to plugDirtiedSignal() may then use dirtyRegion() to
+		/// update only the affected tiles.
+		////////////////////////////////////////////////////////////////////
+		//@{
+		class DirtyRegionScope : boost::noncopyable
+		{
+
+			public :
+
+				DirtyRegionScope( const ImagePlug *image, const Imath::Box2i &region );
+				~DirtyRegionScope();
+
+			private :
+
+				const ImagePlug *m_image;
+				const Imath::Box2i m_region;
+				const DirtyRegionScope *m_previous;
+
+				friend class ImagePlug;
+
+		};
+
+		/// Returns the region of this image declared dirty by the current
+		/// DirtyRegionScope, or an infinite box if no region has been declared,
+		/// in which case the whole image must be assumed to have changed. The
+		/// region is followed through input connections, and through
+		/// ChannelDataProcessors and ColorProcessors, which process each pixel
+		/// independently. Passing through any other node makes the region unknown.
+		Imath::Box2i dirtyRegion() const;
+		//@}
+
 	private :
 
 		static void compoundObjectToCompoundData( const IECore::CompoundObject *object, IECore::CompoundData *data );
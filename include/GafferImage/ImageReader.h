@@ -115,6 +115,7 @@ class ImageReader : public ImageNode
 
 		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+		virtual Gaffer::ValuePlug::CachePolicy computeCachePolicy( const Gaffer::ValuePlug *output ) const;
 
 	private :
 
@@ -137,6 +138,24 @@ class ImageReader : public ImageNode
 		GafferImage::ImagePlug *intermediateImagePlug();
 		const GafferImage::ImagePlug *intermediateImagePlug() const;
 
+		// Channel data from fileImagePlug(), stored at half precision
+		// when that can be done without loss. This is what we cache,
+		// rather than the float data read from the file. It is packed
+		// before colour conversion, since converted values are rarely
+		// representable at half precision.
+		Gaffer::ObjectPlug *tileDataPlug();
+		const Gaffer::ObjectPlug *tileDataPlug() const;
+
+		// The image read from the file, as output by oiioReader().
+		GafferImage::ImagePlug *fileImagePlug();
+		const GafferImage::ImagePlug *fileImagePlug() const;
+
+		// The same image, but with the channel data unpacked from
+		// tileDataPlug() on demand rather than cached. This is
+		// the input to the colour conversion.
+		GafferImage::ImagePlug *unpackedImagePlug();
+		const GafferImage::ImagePlug *unpackedImagePlug() const;
+
 		void hashMaskedOutput( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h, bool alwaysClampToFrame = false ) const;
 		void computeMaskedOutput( Gaffer::ValuePlug *output, const Gaffer::Context *context, bool alwaysClampToFrame = false ) const;
 
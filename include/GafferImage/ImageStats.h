@@ -40,6 +40,7 @@
 #include "Gaffer/ComputeNode.h"
 #include "Gaffer/CompoundNumericPlug.h"
 #include "Gaffer/BoxPlug.h"
+#include "Gaffer/TypedObjectPlug.h"
 
 #include "GafferImage/ImagePlug.h"
 #include "GafferImage/ChannelMaskPlug.h"
@@ -49,6 +50,8 @@ namespace GafferImage
 
 /// Provides statistics on an image's colour profile.
 /// The ImageStats node outputs the minimum, maximum and average values of the pixel values within a region of interest in the image.
+/// All statistics for all channels are computed together in a single parallel pass over the tiles of the
+/// image, and cached on an internal plug from which the individual outputs are read.
 class ImageStats : public Gaffer::ComputeNode
 {
 
@@ -76,7 +79,7 @@ class ImageStats : public Gaffer::ComputeNode
 
 	protected :
 
-		/// Implemented to hash the area we are sampling along with the channel context and regionOfInterest.
+		/// Implemented to hash the tiles we are sampling along with the channels and regionOfInterest.
 		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 
 		/// Computes the min, max and average plugs by analyzing the input ImagePlug.
@@ -84,14 +87,18 @@ class ImageStats : public Gaffer::ComputeNode
 
 	private :
 
-		/// Sets channelName to the channel which corresponds to the output plug. The channel name is
-		/// computed from the intersection of the "in" plug's channels and the "channels" plug's channels.
-		/// If multiple channels are found to have the same channel index, the first is used.
-		/// For more information on this, please see ChannelMaskPlug::removeDuplicateIndices().
-		void channelNameFromOutput( const Gaffer::ValuePlug *output, std::string &channelName ) const;
-
-		/// A convenience function to just set the plug to 0 or 1 depending on what it's index is.
-		void setOutputToDefault( Gaffer::FloatPlug *output ) const;
+		/// Holds the min, max and average for all channels, as a
+		/// Color4fVectorData with three elements in that order.
+		Gaffer::ObjectPlug *allStatsPlug();
+		const Gaffer::ObjectPlug *allStatsPlug() const;
+
+		/// Returns the names of the channels corresponding to each of the four components
+		/// of the outputs, with an empty string for components which have no channel. The
+		/// channel names are computed from the intersection of the "in" plug's channels and
+		/// the "channels" plug's channels. If multiple channels are found to have the same
+		/// channel index, the first is used. For more information on this, please see
+		/// ChannelMaskPlug::removeDuplicateIndices().
+		std::vector<std::string> componentChannelNames() const;
 
 		/// Implemented to initialize the default format settings if they don't exist already.
 		void parentChanging( Gaffer::GraphComponent *newParent );
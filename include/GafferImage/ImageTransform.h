@@ -69,6 +69,10 @@ class ImageTransform : public ImageProcessor
 		Gaffer::StringPlug *filterPlug();
 		const Gaffer::StringPlug *filterPlug() const;
 
+		/// Returns the matrix for the transform applied by this
+		/// node, evaluated in the current context.
+		Imath::M33f matrix() const;
+
 	protected :
 
 		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
@@ -92,6 +96,13 @@ class ImageTransform : public ImageProcessor
 		ImagePlug *resampledInPlug();
 		const ImagePlug *resampledInPlug() const;
 
+		// Output plug to provide the input for the internal Resample.
+		// This passes through the image at the head of any chain of
+		// transforms we concatenate with (see concatenatedTransformInput()
+		// in ImageAlgo.h), so that the chain is resampled only once.
+		ImagePlug *concatenatedInPlug();
+		const ImagePlug *concatenatedInPlug() const;
+
 		// The internal Resample node.
 		Resample *resample();
 		const Resample *resample() const;
@@ -37,6 +37,8 @@
 #ifndef GAFFERIMAGE_MERGE_H
 #define GAFFERIMAGE_MERGE_H
 
+#include "IECore/ObjectVector.h"
+
 #include "Gaffer/NumericPlug.h"
 
 #include "GafferImage/ImageProcessor.h"
@@ -89,6 +91,10 @@ class Merge : public ImageProcessor
 
 	protected :
 
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+		virtual Gaffer::ValuePlug::CachePolicy computeCachePolicy( const Gaffer::ValuePlug *output ) const;
+
 		/// Reimplemented to hash the connected input plugs
 		virtual void hashDataWindow( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashChannelNames( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
@@ -98,14 +104,26 @@ class Merge : public ImageProcessor
 		virtual Imath::Box2i computeDataWindow( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		/// Creates a union of all of the connected inputs channelNames.
 		virtual IECore::ConstStringVectorDataPtr computeChannelNames( const Gaffer::Context *context, const ImagePlug *parent ) const;
-		/// Implemented to call doMergeOperation according to operationPlug()
+		/// Implemented to extract the channel from mergedDataPlug().
 		virtual IECore::ConstFloatVectorDataPtr computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
 
 	private :
 
+		// Stores the result of merging all the channels which are computed
+		// together with the channel named by "image:channelName". The R, G, B
+		// and A channels are computed together, so that the input tiles are
+		// fetched and the intermediate alpha composited only once for all four.
+		// Other channels are computed individually.
+		Gaffer::ObjectPlug *mergedDataPlug();
+		const Gaffer::ObjectPlug *mergedDataPlug() const;
+
+		// Fills channelNames with the channels which are computed together
+		// with channelName, in the order they are stored in mergedDataPlug().
+		void mergedChannelNames( const std::string &channelName, std::vector<std::string> &channelNames ) const;
+
 		// Performs the merge operation using the functor 'F'.
 		template<typename F>
-		IECore::ConstFloatVectorDataPtr merge( F f, const std::string &channelName, const Imath::V2i &tileOrigin ) const;
+		IECore::ObjectVectorPtr merge( F f, const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin ) const;
 
 		static size_t g_firstPlugIndex;
 
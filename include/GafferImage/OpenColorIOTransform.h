@@ -91,6 +91,14 @@ class OpenColorIOTransform : public ColorProcessor
 		/// pointer if no processing should take place.
 		virtual OpenColorIO::ConstTransformRcPtr transform() const = 0;
 
+	private :
+
+		// Returns the processor for transform(), reusing a cached one
+		// where the transform and the current config have been seen before.
+		OpenColorIO::ConstProcessorRcPtr processor( const Gaffer::Context *context ) const;
+
+		class ProcessorCache;
+
 };
 
 IE_CORE_DECLAREPTR( OpenColorIOTransform )
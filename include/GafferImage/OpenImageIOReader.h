@@ -108,6 +108,10 @@ class OpenImageIOReader : public ImageNode
 		virtual IECore::ConstStringVectorDataPtr computeChannelNames( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		virtual IECore::ConstFloatVectorDataPtr computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
 
+		/// Implemented to avoid caching the channel data, since the
+		/// OpenImageIO cache already holds it in the file's own precision.
+		virtual Gaffer::ValuePlug::CachePolicy computeCachePolicy( const Gaffer::ValuePlug *output ) const;
+
 	private :
 
 		void hashFileName( const Gaffer::Context *context, IECore::MurmurHash &h ) const;
@@ -81,6 +81,11 @@ class Resize : public ImageProcessor
 		Gaffer::StringPlug *filterPlug();
 		const Gaffer::StringPlug *filterPlug() const;
 
+		/// Returns the matrix for the transform applied by this
+		/// node, evaluated in the current context. This is the
+		/// identity when the input already has the output format.
+		Imath::M33f matrix() const;
+
 		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
 
 	protected :
@@ -108,12 +113,24 @@ class Resize : public ImageProcessor
 		ImagePlug *resampledInPlug();
 		const ImagePlug *resampledInPlug() const;
 
+		// The input for the internal Resample - a pass-through of
+		// the image at the head of any chain of transforms we
+		// concatenate with (see concatenatedTransformInput() in
+		// ImageAlgo.h).
+		ImagePlug *concatenatedInPlug();
+		const ImagePlug *concatenatedInPlug() const;
+
+		// The scale and offset mapping the input format
+		// into the output format, as determined by the fit mode.
+		Imath::M33f resizeMatrix() const;
+
 		// When we're actually changing the format, we get our
 		// output from resampledInPlug(), but when the format
 		// happens to be the same as the input, we simply pass
 		// through inPlug(). This function just returns the
-		// appropriate plug.
-		const ImagePlug *source() const;
+		// appropriate plug for `parent`, which may also be
+		// concatenatedInPlug().
+		const ImagePlug *source( const ImagePlug *parent ) const;
 
 		static size_t g_firstPlugIndex;
 
@@ -102,6 +102,7 @@ class ImageGadget : public GafferUI::Gadget
 	protected :
 
 		virtual void doRender( const GafferUI::Style *style ) const;
+		virtual void parentChanging( Gaffer::GraphComponent *newParent );
 
 	private :
 
@@ -111,6 +112,8 @@ class ImageGadget : public GafferUI::Gadget
 
 		void plugDirtied( const Gaffer::Plug *plug );
 		void contextChanged( const IECore::InternedString &name );
+		void dirty( unsigned flags );
+		void dirtyTiles( const Imath::Box2i &region );
 
 		GafferImage::ConstImagePlugPtr m_image;
 		Gaffer::ContextPtr m_context;
@@ -185,12 +188,60 @@ class ImageGadget : public GafferUI::Gadget
 			IECoreGL::TexturePtr texture;
 		};
 
-		void updateTiles() const;
-		void removeOutOfBoundsTiles() const;
-
 		typedef tbb::concurrent_unordered_map<TileIndex, Tile> Tiles;
 		mutable Tiles m_tiles;
 
+		// Tile updates.
+		//
+		// Rather than compute all the tiles in one go, blocking the UI
+		// until the whole image is available, we compute them a batch
+		// at a time on idle events, starting with the tiles closest to
+		// the centre of the viewport. Each idle event has a fixed time
+		// budget, checked before every tile, and any tiles we didn't get
+		// to remain queued for the next one. Textures are redrawn as each
+		// batch completes, and any dirtying of the image cancels the update
+		// by discarding the tiles still queued. The exception is when the
+		// image declares the region that was dirtied (see
+		// ImagePlug::DirtyRegionScope), in which case we keep the queue and
+		// add just the tiles intersecting the accumulated m_dirtyTilesRegion.
+
+		void updateTiles();
+		void updateTileQueue();
+		void queueTiles( const Imath::Box2i &region );
+		void channelsToCompute( std::vector<IECore::InternedString> &channels ) const;
+		void uploadTiles() const;
+		void removeOutOfBoundsTiles() const;
+
+		std::vector<TileIndex> m_tileQueue;
+		Imath::Box2i m_dirtyTilesRegion;
+		boost::signals::scoped_connection m_idleConnection;
+
+		// Viewport culling and proxy levels.
+		//
+		// We only compute the tiles which are visible in the viewport,
+		// and when zoomed out we display a downsampled proxy of the image
+		// rather than computing it at full resolution. Proxy level n is
+		// 2^n times smaller than the original image, and is generated by
+		// an internal ProxyImage node, created the first time the level
+		// is needed. Tiles are stored in the pixel space of the current
+		// level, and m_tilesBound is the region they cover.
+
+		class ProxyImage;
+		IE_CORE_DECLAREPTR( ProxyImage )
+
+		bool visibleRegion( Imath::Box2i &region, int &level ) const;
+		void viewportChanged();
+		const GafferImage::ImagePlug *proxyImage( int level );
+		const GafferImage::ImagePlug *tilesImage() const;
+
+		std::vector<ProxyImagePtr> m_proxyImages;
+		int m_tilesLevel;
+		Imath::Box2i m_tilesRegion;
+		Imath::Box2i m_tilesBound;
+
+		boost::signals::scoped_connection m_viewportChangedConnection;
+		boost::signals::scoped_connection m_cameraChangedConnection;
+
 		friend size_t tbb_hasher( const ImageGadget::TileIndex &tileIndex );
 
 		struct TileFunctor;
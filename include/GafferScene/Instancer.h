@@ -38,11 +38,21 @@
 #ifndef GAFFERSCENE_INSTANCER_H
 #define GAFFERSCENE_INSTANCER_H
 
+#include "OpenEXR/ImathQuat.h"
+
+#include "IECore/Primitive.h"
+#include "IECore/VectorTypedData.h"
+
+#include "Gaffer/TypedPlug.h"
+#include "Gaffer/TypedObjectPlug.h"
+
 #include "GafferScene/BranchCreator.h"
 
 namespace GafferScene
 {
 
+class InstancerCapsule;
+
 class Instancer : public BranchCreator
 {
 
@@ -59,10 +69,36 @@ class Instancer : public BranchCreator
 		ScenePlug *instancePlug();
 		const ScenePlug *instancePlug() const;
 
+		/// Name of an int primitive variable used to choose between
+		/// multiple prototypes. When specified, the children of the root
+		/// of instancePlug() are used as the prototypes, rather than
+		/// instancing the whole scene.
+		Gaffer::StringPlug *prototypeIndexPlug();
+		const Gaffer::StringPlug *prototypeIndexPlug() const;
+
+		/// Name of a quaternion primitive variable used to orient the instances.
+		Gaffer::StringPlug *orientationPlug();
+		const Gaffer::StringPlug *orientationPlug() const;
+
+		/// Name of a float or V3f primitive variable used to scale the instances.
+		Gaffer::StringPlug *scalePlug();
+		const Gaffer::StringPlug *scalePlug() const;
+
+		/// When on, the instances are not output as individual locations,
+		/// and are instead represented by a single InstancerCapsule object
+		/// at the location named by namePlug(). This is much cheaper for
+		/// large numbers of instances, and renderers expand the capsule
+		/// natively.
+		Gaffer::BoolPlug *encapsulatePlug();
+		const Gaffer::BoolPlug *encapsulatePlug() const;
+
 		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
 
 	protected :
 
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+
 		virtual void hashBranchBound( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual Imath::Box3f computeBranchBound( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const;
 
@@ -82,15 +118,78 @@ class Instancer : public BranchCreator
 
 		struct BoundHash;
 		struct BoundUnion;
+		struct PrototypeHash;
+
+		// Output plug holding an IntVectorData with one entry per prototype, each
+		// recording which of the scene plugs in the prototype hierarchy read the
+		// "instancer:id" context variable. This is computed once for all instances,
+		// by hashing the entire instance hierarchy with Context::ReadRecorders.
+		// Note that the ReadRecorder is pessimistic : if anything upstream reads the
+		// whole context (for instance via Context::hash() or Context::names(), or via
+		// a cached hash with no dependency information), it is treated as reading
+		// "instancer:id". The instances of such prototypes are then evaluated with
+		// their true ids, and will not share hashes or cached values.
+		Gaffer::ObjectPlug *prototypeIdDependenciesPlug();
+		const Gaffer::ObjectPlug *prototypeIdDependenciesPlug() const;
+
+		friend class InstancerCapsule;
+
+		// Resolves the per-point prototype indices and transforms
+		// from the primitive variables on the source object.
+		class Instances : public IECore::RefCounted
+		{
+
+			public :
+
+				// If `prototypeNames` is NULL, the whole instance scene
+				// is used as a single prototype.
+				Instances( IECore::ConstPrimitivePtr primitive, const IECore::InternedStringVectorData *prototypeNames, const std::string &prototypeIndexName, const std::string &orientationName, const std::string &scaleName );
+				virtual ~Instances();
+
+				size_t numInstances() const;
+				size_t numPrototypes() const;
+				size_t prototypeIndex( size_t instanceId ) const;
+				// Path to the root of the prototype within the instance scene.
+				const ScenePath &prototypeRoot( size_t prototypeIndex ) const;
+				Imath::M44f transform( size_t instanceId ) const;
+
+				void memoryUsage( IECore::Object::MemoryAccumulator &accumulator ) const;
+
+			private :
+
+				IECore::ConstPrimitivePtr m_primitive;
+				std::vector<ScenePath> m_prototypeRoots;
+
+				const std::vector<Imath::V3f> *m_p;
+				const std::vector<int> *m_indices;
+				const std::vector<Imath::Quatf> *m_orientations;
+				const std::vector<Imath::V3f> *m_scales;
+				const std::vector<float> *m_uniformScales;
+
+		};
+
+		IE_CORE_DECLAREPTR( Instances );
 
-		IECore::ConstV3fVectorDataPtr sourcePoints( const ScenePath &parentPath ) const;
+		ConstInstancesPtr instances( const ScenePath &parentPath ) const;
+		void hashInstances( const ScenePath &parentPath, IECore::MurmurHash &h ) const;
 		int instanceIndex( const ScenePath &branchPath ) const;
-		// Makes a new context suitable for use when evaluating instancePlug()
-		Gaffer::ContextPtr instanceContext( const Gaffer::Context *parentContext, const ScenePath &branchPath ) const;
-		// Fills an existing context with the fields needed for evaluating instancePlug()
-		void fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &branchPath ) const;
-		void fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &branchPath, int instanceId ) const;
-		Imath::M44f instanceTransform( const IECore::V3fVectorData *p, int instanceId ) const;
+		// Makes a new context suitable for use when evaluating `plug`, which must be
+		// a child of instancePlug(), at the location corresponding to `branchPath`.
+		Gaffer::ContextPtr instanceContext( const Gaffer::Context *parentContext, const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::ValuePlug *plug ) const;
+		// Fills an existing context with the fields needed for evaluating `plug` at
+		// `instancePath` within instancePlug(). The "instancer:id" variable is only set
+		// to the true id of the instance if `idDependencies` (an entry from
+		// prototypeIdDependencies()) says that `plug` depends on it - otherwise a fixed
+		// id is used, so that all instances share the same hashes and cached values.
+		void fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &instancePath, int instanceId, int idDependencies, const Gaffer::ValuePlug *plug ) const;
+		// Returns the value of prototypeIdDependenciesPlug(), evaluated without
+		// a scene path so that it is shared by all locations.
+		IECore::ConstIntVectorDataPtr prototypeIdDependencies( const Gaffer::Context *context ) const;
+		// Returns true if the bound or placement of any prototype varies with "instancer:id".
+		bool prototypesDependOnId( const std::vector<int> &idDependencies ) const;
+		// Appends the hashes of the entire prototype hierarchies, as used by
+		// the instances. Used to hash the InstancerCapsule.
+		void hashPrototypes( const Instances *instances, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 
 		static size_t g_firstPlugIndex;
 
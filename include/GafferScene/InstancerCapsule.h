@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERSCENE_INSTANCERCAPSULE_H
+#define GAFFERSCENE_INSTANCERCAPSULE_H
+
+#include "IECore/VisibleRenderable.h"
+
+#include "Gaffer/Context.h"
+
+#include "GafferScene/TypeIds.h"
+#include "GafferScene/Instancer.h"
+
+namespace GafferScene
+{
+
+/// A compact representation of all the instances generated by an Instancer,
+/// output in place of individual locations when Instancer::encapsulatePlug()
+/// is on. The capsule references the scene containing the prototypes, and
+/// provides the information needed to expand the instances on demand.
+///
+/// > Note : Capsules cannot be saved to file.
+class InstancerCapsule : public IECore::VisibleRenderable
+{
+
+	public :
+
+		InstancerCapsule();
+		virtual ~InstancerCapsule();
+
+		IE_CORE_DECLAREEXTENSIONOBJECT( GafferScene::InstancerCapsule, InstancerCapsuleTypeId, IECore::VisibleRenderable );
+
+		/// The scene containing the prototypes.
+		const ScenePlug *prototypesScene() const;
+
+		size_t numInstances() const;
+		/// Path within prototypesScene() of the root of the prototype
+		/// used by the specified instance. Throws if `instanceId` is
+		/// out of range, as do the other per-instance methods.
+		const ScenePlug::ScenePath &prototypeRoot( size_t instanceId ) const;
+		/// Transform for the instance, relative to the location holding
+		/// the capsule. This does not include the transform of the
+		/// prototype root itself.
+		Imath::M44f instanceTransform( size_t instanceId ) const;
+		/// Returns the context in which prototypesScene() should be
+		/// evaluated for the specified instance.
+		Gaffer::ContextPtr instanceContext( size_t instanceId ) const;
+
+		/// @name Renderable interface
+		////////////////////////////////////////////////////
+		//@{
+		/// Renders each instance using a SceneProcedural.
+		virtual void render( IECore::Renderer *renderer ) const;
+		virtual Imath::Box3f bound() const;
+		//@}
+
+	private :
+
+		friend class Instancer;
+
+		InstancerCapsule( const ScenePlug *prototypesScene, Instancer::ConstInstancesPtr instances, const Gaffer::Context *context, const IECore::MurmurHash &hash, const Imath::Box3f &bound );
+
+		void checkInstanceId( size_t instanceId ) const;
+
+		ConstScenePlugPtr m_prototypesScene;
+		Instancer::ConstInstancesPtr m_instances;
+		Gaffer::ConstContextPtr m_context;
+		IECore::MurmurHash m_hash;
+		Imath::Box3f m_bound;
+
+};
+
+IE_CORE_DECLAREPTR( InstancerCapsule )
+
+} // namespace GafferScene
+
+#endif // GAFFERSCENE_INSTANCERCAPSULE_H
@@ -90,6 +90,10 @@ class InteractiveRender : public Gaffer::Node
 		const Gaffer::Context *getContext() const;
 		void setContext( Gaffer::ContextPtr context );
 
+		/// The renderer currently in use, or NULL if the render is
+		/// stopped. This is intended primarily for use in testing.
+		IECoreScenePreview::Renderer *renderer();
+
 	protected :
 
 		// Constructor for derived classes which wish to hardcode the renderer type. Perhaps
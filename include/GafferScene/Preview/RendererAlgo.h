@@ -43,6 +43,7 @@ namespace GafferScene
 {
 
 IE_CORE_FORWARDDECLARE( ScenePlug )
+IE_CORE_FORWARDDECLARE( InstancerCapsule )
 
 namespace Preview
 {
@@ -57,6 +58,14 @@ void outputCameras( const ScenePlug *scene, const IECore::CompoundObject *global
 void outputLights( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer );
 void outputObjects( const ScenePlug *scene, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer );
 
+/// Expands the instances held by `capsule`, outputting the prototypes beneath
+/// the location `name`, which has the specified `transform` and (full) `attributes`.
+/// This is used by outputObjects(), and is also available for use by interactive
+/// renders. Because interactive renderers remove an object when its interface is
+/// released, the interfaces for all the objects are appended to `objectInterfaces`
+/// so the caller can keep them alive for as long as the instances are required.
+void outputCapsule( const InstancerCapsule *capsule, const std::string &name, const Imath::M44f &transform, const IECore::CompoundObject *attributes, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, std::vector<IECoreScenePreview::Renderer::ObjectInterfacePtr> &objectInterfaces );
+
 } // namespace Preview
 
 } // namespace GafferScene
@@ -0,0 +1,220 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORESCENEPREVIEW_CAPTURINGRENDERER_H
+#define IECORESCENEPREVIEW_CAPTURINGRENDERER_H
+
+#include <map>
+#include <set>
+
+#include "tbb/spin_mutex.h"
+
+#include "GafferScene/Private/IECoreScenePreview/Renderer.h"
+
+namespace IECoreScenePreview
+{
+
+/// A renderer which doesn't render anything, but instead captures
+/// the calls made to it so they can be inspected. This is intended
+/// for use in unit tests, to verify that a scene is output as expected
+/// without depending on any particular rendering backend. Registered
+/// with the type name "Capturing".
+///
+/// ObjectInterfaces may outlive the renderer, in which case they
+/// are detached from it when it is destroyed, and remain valid for
+/// inspection.
+class CapturingRenderer : public Renderer
+{
+
+	public :
+
+		CapturingRenderer( RenderType renderType = Interactive, const std::string &fileName = "" );
+		virtual ~CapturingRenderer();
+
+		IE_CORE_DECLAREMEMBERPTR( CapturingRenderer )
+
+		IE_CORE_FORWARDDECLARE( CapturedAttributes );
+
+		class CapturedAttributes : public AttributesInterface
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( CapturedAttributes )
+
+				const IECore::CompoundObject *attributes() const;
+
+			private :
+
+				CapturedAttributes( const IECore::CompoundObject *attributes );
+
+				IECore::ConstCompoundObjectPtr m_attributes;
+
+				friend class CapturingRenderer;
+
+		};
+
+		IE_CORE_FORWARDDECLARE( CapturedObject );
+
+		class CapturedObject : public ObjectInterface
+		{
+
+			public :
+
+				IE_CORE_DECLAREMEMBERPTR( CapturedObject )
+
+				virtual ~CapturedObject();
+
+				const std::string &capturedName() const;
+				/// The object samples, and their times. For non-deforming
+				/// objects the times are empty.
+				const std::vector<IECore::ConstObjectPtr> &capturedSamples() const;
+				const std::vector<float> &capturedSampleTimes() const;
+				/// The hash passed to `instance()`, or a default
+				/// hash if the object was not created as an instance.
+				const IECore::MurmurHash &capturedHash() const;
+
+				/// The most recently assigned transform samples, and
+				/// their times. For static transforms the times are empty.
+				const std::vector<Imath::M44f> &capturedTransforms() const;
+				const std::vector<float> &capturedTransformTimes() const;
+				/// The most recently assigned attributes.
+				const CapturedAttributes *capturedAttributes() const;
+
+				/// The number of times `transform()` and `attributes()`
+				/// have been called, allowing tests to verify that edits
+				/// are made only when necessary.
+				int numTransformEdits() const;
+				int numAttributeEdits() const;
+
+				virtual void transform( const Imath::M44f &transform );
+				virtual void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times );
+				virtual void attributes( const AttributesInterface *attributes );
+
+			private :
+
+				CapturedObject( CapturingRenderer *renderer, const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash );
+
+				// Not held by reference, because the renderer retains
+				// the objects in batch renders. Reset to NULL if the
+				// renderer is destroyed first.
+				CapturingRenderer *m_renderer;
+				const std::string m_name;
+				std::vector<IECore::ConstObjectPtr> m_capturedSamples;
+				std::vector<float> m_capturedSampleTimes;
+				const IECore::MurmurHash m_capturedHash;
+				std::vector<Imath::M44f> m_capturedTransforms;
+				std::vector<float> m_capturedTransformTimes;
+				ConstCapturedAttributesPtr m_capturedAttributes;
+				int m_numTransformEdits;
+				int m_numAttributeEdits;
+
+				friend class CapturingRenderer;
+
+		};
+
+		/// Captured state
+		/// ==============
+
+		/// Returns the current value of an option, or NULL
+		/// if it has not been specified.
+		const IECore::Data *capturedOption( const IECore::InternedString &name ) const;
+		/// Returns the named output, or NULL if it has not
+		/// been specified.
+		const Output *capturedOutput( const IECore::InternedString &name ) const;
+		/// Returns the named object, or NULL if it doesn't exist.
+		/// This includes cameras and lights.
+		const CapturedObject *capturedObject( const std::string &name ) const;
+		/// Returns the names of all the objects in the render.
+		std::vector<std::string> capturedObjectNames() const;
+		/// Returns the number of times `render()` has been called.
+		int numRenders() const;
+
+		/// Renderer interface
+		/// ==================
+
+		virtual void option( const IECore::InternedString &name, const IECore::Data *value );
+		virtual void output( const IECore::InternedString &name, const Output *output );
+
+		virtual AttributesInterfacePtr attributes( const IECore::CompoundObject *attributes );
+
+		virtual ObjectInterfacePtr camera( const std::string &name, const IECore::Camera *camera );
+		virtual ObjectInterfacePtr light( const std::string &name, const IECore::Object *object = NULL );
+		virtual ObjectInterfacePtr object( const std::string &name, const IECore::Object *object );
+		virtual ObjectInterfacePtr object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times );
+		virtual ObjectInterfacePtr instance( const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash );
+		virtual ObjectInterfacePtr instance( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash );
+
+		virtual void render();
+		virtual void pause();
+
+	private :
+
+		ObjectInterfacePtr capture( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash );
+		void release( CapturedObject *object );
+
+		RenderType m_renderType;
+
+		typedef std::map<IECore::InternedString, IECore::ConstDataPtr> OptionMap;
+		OptionMap m_options;
+		typedef std::map<IECore::InternedString, IECore::ConstDisplayPtr> OutputMap;
+		OutputMap m_outputs;
+
+		typedef tbb::spin_mutex ObjectsMutex;
+		mutable ObjectsMutex m_objectsMutex;
+		typedef std::map<std::string, CapturedObject *> ObjectMap;
+		ObjectMap m_capturedObjects;
+		// All live objects, including those which have since been
+		// replaced in m_capturedObjects by a newer object of the same
+		// name. Used to detach them when the renderer is destroyed.
+		typedef std::set<CapturedObject *> ObjectSet;
+		ObjectSet m_liveObjects;
+		// In non-interactive renders, releasing an ObjectInterface
+		// doesn't remove the object, so we keep the objects alive
+		// ourselves.
+		std::vector<ObjectInterfacePtr> m_retainedObjects;
+
+		int m_numRenders;
+
+		static Renderer::TypeDescription<CapturingRenderer> g_typeDescription;
+
+};
+
+IE_CORE_DECLAREPTR( CapturingRenderer )
+
+} // namespace IECoreScenePreview
+
+#endif // IECORESCENEPREVIEW_CAPTURINGRENDERER_H
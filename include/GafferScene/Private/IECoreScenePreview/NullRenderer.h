@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORESCENEPREVIEW_NULLRENDERER_H
+#define IECORESCENEPREVIEW_NULLRENDERER_H
+
+#include "tbb/atomic.h"
+
+#include "IECore/Timer.h"
+
+#include "GafferScene/Private/IECoreScenePreview/Renderer.h"
+
+namespace IECoreScenePreview
+{
+
+/// A renderer which discards everything it is given, but counts
+/// the calls made to it and times how long the client takes to make
+/// them. This allows the cost of generating and outputting a scene
+/// to be measured independently of any real rendering backend.
+/// Registered with the type name "Null".
+class NullRenderer : public Renderer
+{
+
+	public :
+
+		NullRenderer( RenderType renderType = Batch, const std::string &fileName = "" );
+		virtual ~NullRenderer();
+
+		IE_CORE_DECLAREMEMBERPTR( NullRenderer )
+
+		/// Returns a CompoundData containing the number of calls made
+		/// to each method, and the time in seconds spent outputting the
+		/// scene, measured from construction (or the last call to `pause()`)
+		/// until the last call to `render()`.
+		IECore::CompoundDataPtr statistics() const;
+
+		/// Renderer interface
+		/// ==================
+
+		virtual void option( const IECore::InternedString &name, const IECore::Data *value );
+		virtual void output( const IECore::InternedString &name, const Output *output );
+
+		virtual AttributesInterfacePtr attributes( const IECore::CompoundObject *attributes );
+
+		virtual ObjectInterfacePtr camera( const std::string &name, const IECore::Camera *camera );
+		virtual ObjectInterfacePtr light( const std::string &name, const IECore::Object *object = NULL );
+		virtual ObjectInterfacePtr object( const std::string &name, const IECore::Object *object );
+		virtual ObjectInterfacePtr object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times );
+		virtual ObjectInterfacePtr instance( const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash );
+		virtual ObjectInterfacePtr instance( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash );
+
+		virtual void render();
+		virtual void pause();
+
+	private :
+
+		class NullObjectInterface;
+
+		// Must be kept in sync with the names in statistics().
+		enum Call
+		{
+			OptionCall,
+			OutputCall,
+			AttributesCall,
+			CameraCall,
+			LightCall,
+			ObjectCall,
+			InstanceCall,
+			TransformEditCall,
+			AttributesEditCall,
+			RenderCall,
+			PauseCall,
+			NumCalls
+		};
+
+		void count( Call call );
+		ObjectInterfacePtr nullObject( Call call );
+
+		tbb::atomic<size_t> m_counts[NumCalls];
+
+		IECore::Timer m_timer;
+		double m_outputTime;
+
+		static Renderer::TypeDescription<NullRenderer> g_typeDescription;
+
+};
+
+IE_CORE_DECLAREPTR( NullRenderer )
+
+} // namespace IECoreScenePreview
+
+#endif // IECORESCENEPREVIEW_NULLRENDERER_H
@@ -38,6 +38,7 @@
 #define IECORESCENEPREVIEW_RENDERER_H
 
 #include "IECore/CompoundObject.h"
+#include "IECore/MurmurHash.h"
 #include "IECore/Display.h"
 #include "IECore/Camera.h"
 
@@ -196,6 +197,15 @@ class Renderer : public IECore::RefCounted
 		/// As above, but specifying a deforming object.
 		virtual ObjectInterfacePtr object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times ) = 0;
 
+		/// Adds a named instance of an object to the render. The hash must uniquely
+		/// identify the object, so that renderers which support instancing can convert
+		/// each unique object only once and share it between all instances with the same
+		/// hash. The default implementation ignores the hash and calls `object()`, so
+		/// renderers without support for instancing need not implement this.
+		virtual ObjectInterfacePtr instance( const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash );
+		/// As above, but specifying a deforming object.
+		virtual ObjectInterfacePtr instance( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash );
+
 		/// Performs the render - should be called after the
 		/// entire scene has been specified using the methods
 		/// above. Batch and SceneDescripton renders will have
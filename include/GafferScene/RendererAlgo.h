@@ -109,8 +109,9 @@ void outputTransform( const ScenePlug *scene, IECore::Renderer *renderer, size_t
 
 /// Samples the object from the current location in preparation for output to the renderer. Sampling parameters
 /// are as for the transformSamples() method. Multiple samples will only be generated for Primitives, since other
-/// object types cannot be interpolated anyway.
-void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &shutter, std::vector<IECore::ConstVisibleRenderablePtr> &samples, std::set<float> &sampleTimes );
+/// object types cannot be interpolated anyway. If hash is non-null, it is filled with a hash uniquely identifying
+/// the samples, suitable for detecting identical objects at different locations.
+void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &shutter, std::vector<IECore::ConstVisibleRenderablePtr> &samples, std::set<float> &sampleTimes, IECore::MurmurHash *hash = NULL );
 
 /// Outputs the object for the current location, using objectSamples() to generate the samples.
 void outputObject( const ScenePlug *scene, IECore::Renderer *renderer, size_t segments = 0, const Imath::V2f &shutter = Imath::V2i( 0 ) );
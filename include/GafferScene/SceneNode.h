@@ -103,6 +103,9 @@ class SceneNode : public Gaffer::ComputeNode
 
 		/// Implemented to call the compute*() methods below whenever output is part of a ScenePlug and the node is enabled.
 		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+		/// Implemented to use the Standard policy for the transform and attributes,
+		/// which are cheap to compute and never spawn tasks.
+		virtual Gaffer::ValuePlug::CachePolicy computeCachePolicy( const Gaffer::ValuePlug *output ) const;
 
 		/// Compute methods for the individual children of outPlug() - these must be implemented by derived classes, or
 		/// an input connection must be made to the plug, so that the method is not called.
@@ -128,6 +128,7 @@ enum TypeId
 	AttributeVisualiserTypeId = 110583,
 	SceneLoopTypeId = 110584,
 	RenderTypeId = 110585,
+	InstancerCapsuleTypeId = 110586,
 
 	PreviewInteractiveRenderTypeId = 110649,
 
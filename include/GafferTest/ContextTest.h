@@ -44,6 +44,8 @@ void testManyContexts();
 void testManySubstitutions();
 void testManyEnvironmentSubstitutions();
 void testScopingNullContext();
+void testScenePathContextHashing();
+void testImageTileContextHashing();
 
 } // namespace GafferTest
 
@@ -275,6 +275,42 @@ class RendererTest( GafferTest.TestCase ) :
 			self.assertEqual( len( lights ), 2 )
 			self.assertEqual( set( [ arnold.AiNodeGetName( l ) for l in lights ] ), { "testLight1", "testLight2" } )
 
+	def testInstancing( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.Renderer.create(
+			"IECoreArnold::Renderer",
+			GafferScene.Private.IECoreScenePreview.Renderer.RenderType.SceneDescription,
+			self.temporaryDirectory() + "/test.ass"
+		)
+
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		largePlane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -2 ), IECore.V2f( 2 ) ) )
+
+		objects = []
+		for i in range( 0, 10 ) :
+			objects.append( r.instance( "plane%d" % i, plane, plane.hash() ) )
+		for i in range( 0, 2 ) :
+			objects.append( r.instance( "largePlane%d" % i, largePlane, largePlane.hash() ) )
+
+		del objects
+		r.render()
+		del r
+
+		with IECoreArnold.UniverseBlock() :
+
+			arnold.AiASSLoad( self.temporaryDirectory() + "/test.ass" )
+
+			shapes = self.__allNodes( type = arnold.AI_NODE_SHAPE )
+			shapeTypes = [ arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( s ) ) for s in shapes ]
+
+			# Each unique object should have been converted only once,
+			# and shared between ginstance nodes for each location.
+			self.assertEqual( shapeTypes.count( "ginstance" ), 12 )
+			self.assertEqual( shapeTypes.count( "polymesh" ), 2 )
+
+			instanceNames = set( [ arnold.AiNodeGetName( s ) for s in shapes if arnold.AiNodeEntryGetName( arnold.AiNodeGetNodeEntry( s ) ) == "ginstance" ] )
+			self.assertEqual( instanceNames, set( [ "plane%d" % i for i in range( 0, 10 ) ] + [ "largePlane0", "largePlane1" ] ) )
+
 	def __allNodes( self, type = arnold.AI_NODE_ALL, ignoreBuiltIn = True ) :
 
 		result = []
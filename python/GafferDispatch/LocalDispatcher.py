@@ -35,12 +35,14 @@
 ##########################################################################
 
 import os
+import json
 import errno
 import signal
 import shlex
 import subprocess32 as subprocess
 import threading
 import time
+import Queue
 import traceback
 
 import IECore
@@ -48,6 +50,82 @@ import IECore
 import Gaffer
 import GafferDispatch
 
+# A persistent `gaffer execute -worker` process, which loads the
+# script once and then executes batches on request. Provides the same
+# `pid`, `poll()` and `returncode` members as `subprocess.Popen`, but
+# with respect to the most recently requested batch rather than the
+# process itself.
+class _Worker( object ) :
+
+	def __init__( self, args ) :
+
+		self.__process = subprocess.Popen(
+			args, stdin = subprocess.PIPE, stdout = subprocess.PIPE,
+			start_new_session = True
+		)
+
+		self.pid = self.__process.pid
+		self.returncode = None
+
+		self.__results = Queue.Queue()
+		self.__resultsThread = threading.Thread( target = self.__readResults )
+		self.__resultsThread.daemon = True
+		self.__resultsThread.start()
+
+	def execute( self, nodes, frames, context ) :
+
+		# Discard any result left over from an earlier batch. The
+		# only result which can be waiting for an idle worker is the
+		# exit code from it dying, and that doesn't apply to this batch.
+		self.returncode = None
+		while True :
+			try :
+				self.__results.get_nowait()
+			except Queue.Empty :
+				break
+
+		request = { "nodes" : nodes, "frames" : frames, "context" : context }
+		try :
+			self.__process.stdin.write( json.dumps( request ) + "\n" )
+			self.__process.stdin.flush()
+		except IOError :
+			# The worker has died, and __readResults()
+			# will report a failure.
+			pass
+
+	def poll( self ) :
+
+		if self.returncode is None :
+			try :
+				self.returncode = self.__results.get_nowait()
+			except Queue.Empty :
+				pass
+
+		return self.returncode
+
+	# Returns False if the worker process has exited.
+	def alive( self ) :
+
+		return self.__process.poll() is None
+
+	def stop( self ) :
+
+		try :
+			self.__process.stdin.close()
+		except IOError :
+			pass
+
+		self.__process.wait()
+
+	def __readResults( self ) :
+
+		for line in iter( self.__process.stdout.readline, "" ) :
+			self.__results.put( int( line ) )
+
+		# The process has exited, perhaps because it failed to load the script
+		# or was killed. If a batch was in progress, it has failed.
+		self.__results.put( self.__process.wait() or 1 )
+
 class LocalDispatcher( GafferDispatch.Dispatcher ) :
 
 	def __init__( self, name = "LocalDispatcher", jobPool = None ) :
@@ -57,6 +135,8 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 		self["executeInBackground"] = Gaffer.BoolPlug( defaultValue = False )
 		self["ignoreScriptLoadErrors"] = Gaffer.BoolPlug( defaultValue = False )
 		self["environmentCommand"] = Gaffer.StringPlug()
+		self["maxConcurrentTasks"] = Gaffer.IntPlug( defaultValue = 1, minValue = 1 )
+		self["useWorkers"] = Gaffer.BoolPlug( defaultValue = False )
 
 		self.__jobPool = jobPool if jobPool else LocalDispatcher.defaultJobPool()
 
@@ -86,6 +166,8 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 			self.__directory = directory
 			self.__stats = {}
 			self.__ignoreScriptLoadErrors = dispatcher["ignoreScriptLoadErrors"].getValue()
+			self.__maxConcurrentTasks = dispatcher["maxConcurrentTasks"].getValue()
+			self.__useWorkers = dispatcher["useWorkers"].getValue()
 			## \todo Make `Dispatcher::dispatch()` use a Process, so we don't need to
 			# do substitutions manually like this.
 			self.__environmentCommand = Gaffer.Context.current().substitute(
@@ -98,7 +180,7 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 			scriptFileName = script["fileName"].getValue()
 			self.__scriptFile = os.path.join( self.__directory, os.path.basename( scriptFileName ) if scriptFileName else "untitled.gfr" )
 			script.serialiseToFile( self.__scriptFile )
-			self.__storeNodeNames( script, batch )
+			self.__storeBatchSettings( script, batch )
 
 			self.__setStatus( batch, LocalDispatcher.Job.Status.Waiting, recursive = True )
 
@@ -116,35 +198,38 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 
 		def description( self ) :
 
-			batch = self.__currentBatch( self.__batch )
-			if batch is None or batch.plug() is None :
+			batches = [ b for b in self.__currentBatches() if b.plug() is not None ]
+			if not batches :
 				return "N/A"
 
-			frames = str( IECore.frameListFromList( [ int(x) for x in batch.frames() ] ) )
+			descriptions = []
+			for batch in batches :
+				frames = str( IECore.frameListFromList( [ int(x) for x in batch.frames() ] ) )
+				descriptions.append( batch.blindData()["nodeName"].value + " on frames " + frames )
 
-			return "Executing " + batch.blindData()["nodeName"].value + " on frames " + frames
+			return "Executing " + ", ".join( descriptions )
 
 		def statistics( self ) :
 
-			batch = self.__currentBatch( self.__batch )
-			if batch is None or "pid" not in batch.blindData().keys() :
+			pids = [ b.blindData()["pid"].value for b in self.__currentBatches() if "pid" in b.blindData().keys() ]
+			if not pids :
 				return {}
 
 			rss = 0
 			pcpu = 0.0
-			pid = batch.blindData().get( "pid" )
 
 			try :
 				stats = subprocess.Popen( ( "ps -Ao pid,ppid,pgid,sess,pcpu,rss" ).split( " " ), stdout=subprocess.PIPE, stderr=subprocess.PIPE ).communicate()[0].split()
 				for i in range( 0, len(stats), 6 ) :
-					if str(pid) in stats[i:i+4] :
+					if any( str(pid) in stats[i:i+4] for pid in pids ) :
 						pcpu += float(stats[i+4])
 						rss += float(stats[i+5])
 			except :
 				return {}
 
 			return {
-				"pid" : pid,
+				"pid" : pids[0],
+				"pids" : pids,
 				"pcpu" : pcpu,
 				"rss" : rss,
 			}
@@ -219,34 +304,96 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 		def __backgroundDispatch( self ) :
 
 			with self.__messageHandler :
-				self.__doBackgroundDispatch( self.__batch )
+				workers = []
+				try :
+					self.__doBackgroundDispatch( self.__batch, workers )
+				finally :
+					for worker in workers :
+						worker.stop()
 
-		def __doBackgroundDispatch( self, batch ) :
+		def __doBackgroundDispatch( self, batch, workers ) :
 
-			if self.__getStatus( batch ) == LocalDispatcher.Job.Status.Complete :
-				return True
+			# Independent branches of the task graph are executed
+			# concurrently, launching each batch as soon as its
+			# preTasks are complete, subject to the limit on the total
+			# weight of the batches running at any one time. Batches
+			# for nodes which require sequence execution already contain
+			# all their frames, so they are never split across processes.
 
-			for upstreamBatch in batch.preTasks() :
-				if not self.__doBackgroundDispatch( upstreamBatch ) :
+			batches = self.__allBatches( batch )
+			running = []
+			failedBatch = None
+
+			while True :
+
+				if batch.blindData().get( "killed" ) :
+					for runningBatch, process in running :
+						os.killpg( process.pid, signal.SIGTERM )
+					self.__reportKilled( batch )
 					return False
 
-			if batch.blindData().get( "killed" ) :
-				self.__reportKilled( batch )
-				return False
+				# Check on the batches we've launched.
+
+				for runningBatch, process in list( running ) :
+					if process.poll() is None :
+						continue
+					running.remove( ( runningBatch, process ) )
+					if process.returncode :
+						failedBatch = failedBatch or runningBatch
+						self.__setStatus( runningBatch, LocalDispatcher.Job.Status.Failed )
+					else :
+						self.__setStatus( runningBatch, LocalDispatcher.Job.Status.Complete )
+
+				if failedBatch is not None :
+					# Don't launch anything more, but let the batches
+					# that are already running finish.
+					if not running :
+						self.__reportFailed( failedBatch )
+						return False
+					time.sleep( 0.01 )
+					continue
+
+				# Launch any batches whose preTasks are complete.
+
+				for readyBatch in self.__readyBatches( batches ) :
+
+					if readyBatch.plug() is None :
+						# The root batch exists only to depend on the others.
+						self.__reportCompleted( batch )
+						return True
+
+					if len( readyBatch.frames() ) == 0 :
+						# This case occurs for nodes like TaskList and TaskContextProcessors,
+						# because they don't do anything in execute (they have empty hashes).
+						# Their batches exist only to depend on upstream batches. We don't need
+						# to do any work here, but we still signal completion for the task to
+						# provide progress feedback to the user.
+						self.__setStatus( readyBatch, LocalDispatcher.Job.Status.Complete )
+						IECore.msg( IECore.MessageHandler.Level.Info, self.__messageTitle, "Finished " + readyBatch.blindData()["nodeName"].value )
+						continue
+
+					weight = self.__weight( readyBatch )
+					runningWeight = sum( self.__weight( b ) for b, p in running )
+					if running and runningWeight + weight > self.__maxConcurrentTasks :
+						continue
+
+					running.append( ( readyBatch, self.__launch( readyBatch, running, workers ) ) )
 
-			if not batch.plug() :
-				self.__reportCompleted( batch )
-				return True
+				time.sleep( 0.01 )
 
-			if len( batch.frames() ) == 0 :
-				# This case occurs for nodes like TaskList and TaskContextProcessors,
-				# because they don't do anything in execute (they have empty hashes).
-				# Their batches exist only to depend on upstream batches. We don't need
-				# to do any work here, but we still signal completion for the task to
-				# provide progress feedback to the user.
-				self.__setStatus( batch, LocalDispatcher.Job.Status.Complete )
-				IECore.msg( IECore.MessageHandler.Level.Info, self.__messageTitle, "Finished " + batch.blindData()["nodeName"].value )
-				return True
+		# Returns the weight of the batch, clamped so that a batch heavier
+		# than `maxConcurrentTasks` can still run, and counts the same
+		# whether it is waiting to launch or already running.
+		def __weight( self, batch ) :
+
+			return min( batch.blindData()["weight"].value, self.__maxConcurrentTasks )
+
+		# Launches the batch, returning an object with the same `pid`,
+		# `poll()` and `returncode` members as `subprocess.Popen`. When
+		# using workers, the batch is handed to an idle worker from
+		# `workers`, and new workers are launched only when all the
+		# existing ones are busy executing the `running` batches.
+		def __launch( self, batch, running, workers ) :
 
 			taskContext = batch.context()
 			frames = str( IECore.frameListFromList( [ int(x) for x in batch.frames() ] ) )
@@ -254,8 +401,6 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 			args = [
 				"gaffer", "execute",
 				"-script", self.__scriptFile,
-				"-nodes", batch.blindData()["nodeName"].value,
-				"-frames", frames,
 			]
 
 			args = shlex.split( self.__environmentCommand ) + args
@@ -268,30 +413,69 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 				if entry not in self.__context.keys() or taskContext[entry] != self.__context[entry] :
 					contextArgs.extend( [ "-" + entry, repr(taskContext[entry]) ] )
 
+			self.__setStatus( batch, LocalDispatcher.Job.Status.Running )
+
+			if self.__useWorkers :
+
+				idleWorkers = [ w for w in workers if not any( p is w for b, p in running ) ]
+
+				# Workers may die while idle (if killed externally, for
+				# instance), so we discard any which have exited rather
+				# than dispatch to them.
+				for w in idleWorkers :
+					if not w.alive() :
+						w.stop()
+						workers.remove( w )
+				idleWorkers = [ w for w in idleWorkers if w in workers ]
+
+				if idleWorkers :
+					worker = idleWorkers[0]
+				else :
+					args.append( "-worker" )
+					IECore.msg( IECore.MessageHandler.Level.Info, self.__messageTitle, " ".join( args ) )
+					worker = _Worker( args )
+					workers.append( worker )
+
+				description = "executing %s on %s" % ( batch.blindData()["nodeName"].value, frames )
+				IECore.msg( IECore.MessageHandler.Level.Info, self.__messageTitle, description )
+				worker.execute( [ batch.blindData()["nodeName"].value ], frames, contextArgs )
+				batch.blindData()["pid"] = IECore.IntData( worker.pid )
+
+				return worker
+
+			args.extend( [ "-nodes", batch.blindData()["nodeName"].value, "-frames", frames ] )
 			if contextArgs :
 				args.extend( [ "-context" ] + contextArgs )
 
-			self.__setStatus( batch, LocalDispatcher.Job.Status.Running )
 			IECore.msg( IECore.MessageHandler.Level.Info, self.__messageTitle, " ".join( args ) )
 			process = subprocess.Popen( args, start_new_session=True )
 			batch.blindData()["pid"] = IECore.IntData( process.pid )
 
-			while process.poll() is None :
+			return process
 
-				if batch.blindData().get( "killed" ) :
-					os.killpg( process.pid, signal.SIGTERM )
-					self.__reportKilled( batch )
-					return False
+		# Returns all the batches in the graph, with each batch listed
+		# only once, even if it is a preTask of several others.
+		def __allBatches( self, batch, result = None ) :
 
-				time.sleep( 0.01 )
+			result = [] if result is None else result
+			if any( b.isSame( batch ) for b in result ) :
+				return result
 
-			if process.returncode :
-				self.__reportFailed( batch )
-				return False
+			for upstreamBatch in batch.preTasks() :
+				self.__allBatches( upstreamBatch, result )
 
-			self.__setStatus( batch, LocalDispatcher.Job.Status.Complete )
+			result.append( batch )
+			return result
 
-			return True
+		# Returns the batches which are waiting to be executed,
+		# and whose preTasks have all been completed.
+		def __readyBatches( self, batches ) :
+
+			return [
+				b for b in batches
+				if self.__getStatus( b ) == LocalDispatcher.Job.Status.Waiting and
+				all( self.__getStatus( p ) == LocalDispatcher.Job.Status.Complete for p in b.preTasks() )
+			]
 
 		def __getStatus( self, batch ) :
 
@@ -324,26 +508,23 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 			self.__dispatcher.jobPool()._remove( self )
 			IECore.msg( IECore.MessageHandler.Level.Info, self.__messageTitle, "Killed " + self.name() )
 
-		def __currentBatch( self, batch ) :
+		def __currentBatches( self ) :
 
-			if self.__getStatus( batch ) == LocalDispatcher.Job.Status.Running :
-				return batch
+			return [ b for b in self.__allBatches( self.__batch ) if self.__getStatus( b ) == LocalDispatcher.Job.Status.Running ]
 
-			for upstreamBatch in batch.preTasks() :
-
-				batch = self.__currentBatch( upstreamBatch )
-				if batch is not None :
-					return batch
-
-			return None
-
-		def __storeNodeNames( self, script, batch ) :
+		def __storeBatchSettings( self, script, batch ) :
 
 			if batch.plug() :
 				batch.blindData()["nodeName"] = batch.plug().node().relativeName( script )
+				weight = 1
+				localPlug = batch.node()["dispatcher"].getChild( "local" )
+				if localPlug is not None :
+					with batch.context() :
+						weight = localPlug["weight"].getValue()
+				batch.blindData()["weight"] = IECore.IntData( weight )
 
 			for upstreamBatch in batch.preTasks() :
-				self.__storeNodeNames( script, upstreamBatch )
+				self.__storeBatchSettings( script, upstreamBatch )
 
 	class JobPool( IECore.RunTimeTyped ) :
 
@@ -415,6 +596,15 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 
 		return self.__jobPool
 
+	@staticmethod
+	def _setupPlugs( parentPlug ) :
+
+		if "local" in parentPlug :
+			return
+
+		parentPlug["local"] = Gaffer.Plug()
+		parentPlug["local"]["weight"] = Gaffer.IntPlug( defaultValue = 1, minValue = 1 )
+
 	def _doDispatch( self, batch ) :
 
 		job = LocalDispatcher.Job(
@@ -432,4 +622,4 @@ class LocalDispatcher( GafferDispatch.Dispatcher ) :
 IECore.registerRunTimeTyped( LocalDispatcher, typeName = "GafferDispatch::LocalDispatcher" )
 IECore.registerRunTimeTyped( LocalDispatcher.JobPool, typeName = "GafferDispatch::LocalDispatcher::JobPool" )
 
-GafferDispatch.Dispatcher.registerDispatcher( "Local", LocalDispatcher )
+GafferDispatch.Dispatcher.registerDispatcher( "Local", LocalDispatcher, LocalDispatcher._setupPlugs )
@@ -35,6 +35,7 @@
 ##########################################################################
 
 import os
+import inspect
 import stat
 import shutil
 import unittest
@@ -743,6 +744,166 @@ class LocalDispatcherTest( GafferTest.TestCase ) :
 		with open( testFile ) as f :
 			self.assertEqual( f.readlines(), [ "HELLO WORLD\n" ] )
 
+	# Dispatches two independent tasks, each of which waits briefly for
+	# the other to start, and then records whether or not the other was
+	# running at the same time. Rather than comparing timings, this uses
+	# files to synchronise the tasks, so the result is deterministic :
+	# concurrent tasks always see each other, and sequential tasks never do.
+	def __concurrentCommands( self, maxConcurrentTasks, weight = 1 ) :
+
+		s = Gaffer.ScriptNode()
+
+		for name, other in ( ( "a", "b" ), ( "b", "a" ) ) :
+			s[name] = GafferDispatch.PythonCommand()
+			s[name]["command"].setValue( inspect.cleandoc(
+				"""
+				import os
+				import time
+
+				directory = %s
+
+				def path( name, suffix ) :
+					return os.path.join( directory, name + "." + suffix )
+
+				def waitFor( fileName ) :
+					for i in range( 0, 50 ) :
+						if os.path.exists( fileName ) :
+							return
+						time.sleep( 0.1 )
+
+				open( path( %s, "started" ), "w" ).close()
+				waitFor( path( %s, "started" ) )
+				sawOther = os.path.exists( path( %s, "started" ) ) and not os.path.exists( path( %s, "finished" ) )
+				with open( path( %s, "sawOther" ), "w" ) as f :
+					f.write( str( int( sawOther ) ) )
+				waitFor( path( %s, "sawOther" ) )
+				open( path( %s, "finished" ), "w" ).close()
+				""" % (
+					repr( self.temporaryDirectory() ),
+					repr( name ), repr( other ), repr( other ), repr( other ),
+					repr( name ), repr( other ), repr( name ),
+				)
+			) )
+
+		s["a"]["dispatcher"]["local"]["weight"].setValue( weight )
+
+		s["l"] = GafferDispatch.TaskList()
+		s["l"]["preTasks"][0].setInput( s["a"]["task"] )
+		s["l"]["preTasks"][1].setInput( s["b"]["task"] )
+
+		dispatcher = GafferDispatch.Dispatcher.create( "LocalTest" )
+		dispatcher["executeInBackground"].setValue( True )
+		dispatcher["maxConcurrentTasks"].setValue( maxConcurrentTasks )
+		dispatcher["framesMode"].setValue( GafferDispatch.Dispatcher.FramesMode.CurrentFrame )
+		dispatcher.dispatch( [ s["l"] ] )
+		dispatcher.jobPool().waitForAll()
+
+		result = []
+		for name in ( "a", "b" ) :
+			with open( os.path.join( self.temporaryDirectory(), name + ".sawOther" ) ) as f :
+				result.append( bool( int( f.read() ) ) )
+
+		return result
+
+	def testConcurrentTasks( self ) :
+
+		self.assertEqual( self.__concurrentCommands( maxConcurrentTasks = 2 ), [ True, True ] )
+
+	def testMaxConcurrentTasks( self ) :
+
+		self.assertEqual( self.__concurrentCommands( maxConcurrentTasks = 1 ), [ False, False ] )
+
+	def testTaskWeight( self ) :
+
+		self.assertEqual( self.__concurrentCommands( maxConcurrentTasks = 2, weight = 2 ), [ False, False ] )
+
+	def testTaskWeightGreaterThanMaxConcurrentTasks( self ) :
+
+		# The heavy task is clamped to `maxConcurrentTasks`, so it still
+		# runs, but never alongside the other task.
+		self.assertEqual( self.__concurrentCommands( maxConcurrentTasks = 2, weight = 3 ), [ False, False ] )
+
+	def testConcurrentTasksRespectDependencies( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		fileName = os.path.join( self.temporaryDirectory(), "result.txt" )
+		for name in ( "a", "b", "c" ) :
+			s[name] = GafferDispatch.SystemCommand()
+			s[name]["command"].setValue( "echo " + name + " >> " + fileName )
+
+		s["a"]["preTasks"][0].setInput( s["b"]["task"] )
+		s["b"]["preTasks"][0].setInput( s["c"]["task"] )
+
+		dispatcher = GafferDispatch.Dispatcher.create( "LocalTest" )
+		dispatcher["executeInBackground"].setValue( True )
+		dispatcher["maxConcurrentTasks"].setValue( 3 )
+		dispatcher["framesMode"].setValue( GafferDispatch.Dispatcher.FramesMode.CurrentFrame )
+		dispatcher.dispatch( [ s["a"] ] )
+		dispatcher.jobPool().waitForAll()
+
+		with open( fileName ) as f :
+			self.assertEqual( f.read().split(), [ "c", "b", "a" ] )
+
+	def testWorkers( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		fileName = os.path.join( self.temporaryDirectory(), "pids.txt" )
+
+		s["c"] = GafferDispatch.PythonCommand()
+		s["c"]["command"].setValue( inspect.cleandoc(
+			"""
+			import os
+			with open( %s, "a" ) as f :
+				f.write( "%%d %%d\\n" %% ( context.getFrame(), os.getpid() ) )
+			""" % repr( fileName )
+		) )
+
+		dispatcher = GafferDispatch.Dispatcher.create( "LocalTest" )
+		dispatcher["executeInBackground"].setValue( True )
+		dispatcher["useWorkers"].setValue( True )
+		dispatcher["framesMode"].setValue( GafferDispatch.Dispatcher.FramesMode.CustomRange )
+		dispatcher["frameRange"].setValue( "1-4" )
+		dispatcher.dispatch( [ s["c"] ] )
+		dispatcher.jobPool().waitForAll()
+
+		with open( fileName ) as f :
+			lines = [ l.split() for l in f.readlines() ]
+
+		# Each frame is a separate batch, but they should
+		# all have been executed by the same worker process.
+		self.assertEqual( [ int( l[0] ) for l in lines ], [ 1, 2, 3, 4 ] )
+		self.assertEqual( len( set( l[1] for l in lines ) ), 1 )
+		self.assertNotEqual( int( lines[0][1] ), os.getpid() )
+
+	def testWorkerFailure( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["n1"] = GafferDispatchTest.TextWriter()
+		s["n1"]["fileName"].setValue( "/tmp/dispatcherTest/n1_####.txt" )
+		s["n1"]["text"].setValue( "n1 on ${frame}" )
+		s["n2"] = GafferDispatchTest.TextWriter()
+		s["n2"]["fileName"].setValue( "" )
+		s["n2"]["text"].setValue( "n2 on ${frame}" )
+		s["n3"] = GafferDispatchTest.TextWriter()
+		s["n3"]["fileName"].setValue( "/tmp/dispatcherTest/n3_####.txt" )
+		s["n3"]["text"].setValue( "n3 on ${frame}" )
+		s["n1"]["preTasks"][0].setInput( s["n2"]["task"] )
+		s["n2"]["preTasks"][0].setInput( s["n3"]["task"] )
+
+		dispatcher = GafferDispatch.Dispatcher.create( "LocalTest" )
+		dispatcher["executeInBackground"].setValue( True )
+		dispatcher["useWorkers"].setValue( True )
+		dispatcher.dispatch( [ s["n1"] ] )
+		dispatcher.jobPool().waitForAll()
+
+		# n3 executed correctly
+		self.assertTrue( os.path.isfile( s.context().substitute( s["n3"]["fileName"].getValue() ) ) )
+
+		# n2 failed, so n1 never executed
+		self.assertFalse( os.path.isfile( s.context().substitute( s["n1"]["fileName"].getValue() ) ) )
+
 	def tearDown( self ) :
 
 		GafferTest.TestCase.tearDown( self )
@@ -97,6 +97,72 @@ Gaffer.Metadata.registerNode(
 
 		),
 
+		"maxConcurrentTasks" : (
+
+			"description",
+			"""
+			The maximum number of tasks to execute concurrently when
+			executing in the background. Independent branches of the
+			task graph are executed in parallel, while tasks are always
+			executed after the tasks they depend on. Tasks may be given
+			a weight greater than one using the Local dispatcher settings
+			on the task node, in which case they count as several tasks
+			towards the limit.
+			""",
+
+		),
+
+		"useWorkers" : (
+
+			"description",
+			"""
+			Executes background tasks using persistent worker processes
+			rather than launching a new `gaffer execute ...` process for
+			each batch. Each worker loads the script once and then executes
+			many batches, avoiding the startup cost and keeping the caches
+			warm from one batch to the next. This is particularly beneficial
+			when there are many small batches, such as when writing images
+			one frame at a time. Workers are shut down when the job is
+			complete.
+			""",
+
+		),
+
+	}
+
+)
+
+Gaffer.Metadata.registerNode(
+
+	GafferDispatch.ExecutableNode,
+
+	plugs = {
+
+		"dispatcher.local" : (
+
+			"description",
+			"""
+			Settings that control how tasks are
+			executed by the LocalDispatcher.
+			""",
+
+			"layout:section", "Local",
+			"plugValueWidget:type", "GafferUI.LayoutPlugValueWidget",
+
+		),
+
+		"dispatcher.local.weight" : (
+
+			"description",
+			"""
+			The number of concurrent tasks that this task counts as
+			when executing in the background. Resource hungry tasks
+			may be given a higher weight to limit the number of other
+			tasks that run alongside them.
+			""",
+
+		),
+
 	}
 
 )
@@ -41,6 +41,7 @@ import IECore
 import Gaffer
 import GafferTest
 import GafferImage
+import GafferImageTest
 
 class BlurTest( GafferTest.TestCase ) :
 
@@ -126,5 +127,155 @@ class BlurTest( GafferTest.TestCase ) :
 			blur["radius"].setValue( IECore.V2f( i * 0.5 ) )
 			self.assertAlmostEqual( stats["average"]["r"].getValue(), 1 / 100., delta = 0.0001 )
 
+	def testFastModePassThrough( self ) :
+
+		c = GafferImage.Constant()
+
+		b = GafferImage.Blur()
+		b["in"].setInput( c["out"] )
+		b["mode"].setValue( GafferImage.Blur.Mode.Fast )
+		b["radius"].setValue( IECore.V2f( 0 ) )
+
+		self.assertEqual( c["out"].imageHash(), b["out"].imageHash() )
+		self.assertEqual( c["out"].image(), b["out"].image() )
+
+	def testFastModeEnergyPreservation( self ) :
+
+		constant = GafferImage.Constant()
+		constant["color"].setValue( IECore.Color4f( 1 ) )
+
+		crop = GafferImage.Crop()
+		crop["in"].setInput( constant["out"] )
+		crop["area"].setValue( IECore.Box2i( IECore.V2i( 100 ), IECore.V2i( 101 ) ) )
+		crop["affectDisplayWindow"].setValue( False )
+
+		blur = GafferImage.Blur()
+		blur["in"].setInput( crop["out"] )
+		blur["mode"].setValue( GafferImage.Blur.Mode.Fast )
+		blur["expandDataWindow"].setValue( True )
+
+		stats = GafferImage.ImageStats()
+		stats["in"].setInput( blur["out"] )
+		stats["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 200 ) ) )
+
+		for radius in ( 0.5, 1, 5, 10, 50 ) :
+
+			blur["radius"].setValue( IECore.V2f( radius ) )
+			self.assertAlmostEqual( stats["average"]["r"].getValue(), 1 / 40000., delta = 0.000001 )
+
+	def testFastModeClamp( self ) :
+
+		constant = GafferImage.Constant()
+		constant["format"].setValue( GafferImage.Format( 100, 100 ) )
+		constant["color"].setValue( IECore.Color4f( 0.5 ) )
+
+		blur = GafferImage.Blur()
+		blur["in"].setInput( constant["out"] )
+		blur["mode"].setValue( GafferImage.Blur.Mode.Fast )
+		blur["boundingMode"].setValue( GafferImage.Sampler.BoundingMode.Clamp )
+		blur["radius"].setValue( IECore.V2f( 30 ) )
+
+		stats = GafferImage.ImageStats()
+		stats["in"].setInput( blur["out"] )
+		stats["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 100 ) ) )
+
+		for p in ( "min", "max" ) :
+			self.assertAlmostEqual( stats[p]["r"].getValue(), 0.5, delta = 0.00001 )
+
+		blur["boundingMode"].setValue( GafferImage.Sampler.BoundingMode.Black )
+		self.assertLess( stats["min"]["r"].getValue(), 0.5 )
+
+	def testFastModeApproximatesAccurateMode( self ) :
+
+		constant = GafferImage.Constant()
+		constant["color"].setValue( IECore.Color4f( 1 ) )
+
+		crop = GafferImage.Crop()
+		crop["in"].setInput( constant["out"] )
+		crop["area"].setValue( IECore.Box2i( IECore.V2i( 80 ), IECore.V2i( 120 ) ) )
+		crop["affectDisplayWindow"].setValue( False )
+
+		accurate = GafferImage.Blur()
+		accurate["in"].setInput( crop["out"] )
+		accurate["radius"].setValue( IECore.V2f( 20, 10 ) )
+		accurate["expandDataWindow"].setValue( True )
+
+		fast = GafferImage.Blur()
+		fast["in"].setInput( crop["out"] )
+		fast["radius"].setValue( IECore.V2f( 20, 10 ) )
+		fast["expandDataWindow"].setValue( True )
+		fast["mode"].setValue( GafferImage.Blur.Mode.Fast )
+
+		window = IECore.Box2i( IECore.V2i( 40 ), IECore.V2i( 160 ) )
+		accurateSampler = GafferImage.Sampler( accurate["out"], "R", window )
+		fastSampler = GafferImage.Sampler( fast["out"], "R", window )
+
+		for y in range( window.min.y, window.max.y, 5 ) :
+			for x in range( window.min.x, window.max.x, 5 ) :
+				self.assertAlmostEqual( accurateSampler.sample( x, y ), fastSampler.sample( x, y ), delta = 0.03 )
+
+	def testFastModeMatchesAccurateModeOnDegenerateAxis( self ) :
+
+		constant = GafferImage.Constant()
+		constant["color"].setValue( IECore.Color4f( 1 ) )
+
+		crop = GafferImage.Crop()
+		crop["in"].setInput( constant["out"] )
+		crop["area"].setValue( IECore.Box2i( IECore.V2i( 80 ), IECore.V2i( 120 ) ) )
+		crop["affectDisplayWindow"].setValue( False )
+
+		accurate = GafferImage.Blur()
+		accurate["in"].setInput( crop["out"] )
+		accurate["expandDataWindow"].setValue( True )
+
+		fast = GafferImage.Blur()
+		fast["in"].setInput( crop["out"] )
+		fast["expandDataWindow"].setValue( True )
+		fast["mode"].setValue( GafferImage.Blur.Mode.Fast )
+
+		for boundingMode in ( GafferImage.Sampler.BoundingMode.Black, GafferImage.Sampler.BoundingMode.Clamp ) :
+			for radius in ( IECore.V2f( 0, 10 ), IECore.V2f( 10, 0 ) ) :
+
+				for blur in ( accurate, fast ) :
+					blur["boundingMode"].setValue( boundingMode )
+					blur["radius"].setValue( radius )
+
+				self.assertEqual( fast["out"]["dataWindow"].getValue(), accurate["out"]["dataWindow"].getValue() )
+
+				window = accurate["out"]["dataWindow"].getValue()
+				accurateSampler = GafferImage.Sampler( accurate["out"], "R", window )
+				fastSampler = GafferImage.Sampler( fast["out"], "R", window )
+
+				for y in range( window.min.y, window.max.y, 3 ) :
+					for x in range( window.min.x, window.max.x, 3 ) :
+						self.assertAlmostEqual( accurateSampler.sample( x, y ), fastSampler.sample( x, y ), delta = 0.03 )
+
+	@GafferTest.TestRunner.PerformanceTestMethod()
+	def testFastModePerformance( self ) :
+
+		constant = GafferImage.Constant()
+		constant["format"].setValue( GafferImage.Format( 512, 512 ) )
+		constant["color"].setValue( IECore.Color4f( 1, 0.5, 0.25, 1 ) )
+
+		blur = GafferImage.Blur()
+		blur["in"].setInput( constant["out"] )
+		blur["mode"].setValue( GafferImage.Blur.Mode.Fast )
+		blur["boundingMode"].setValue( GafferImage.Sampler.BoundingMode.Clamp )
+		blur["radius"].setValue( IECore.V2f( 50 ) )
+
+		with GafferTest.TestRunner.PerformanceScope() :
+			GafferImageTest.processTiles( blur["out"] )
+
+		# Blurring a constant image with clamped bounds
+		# should leave it unchanged.
+
+		stats = GafferImage.ImageStats()
+		stats["in"].setInput( blur["out"] )
+		stats["regionOfInterest"].setValue( blur["out"]["format"].getValue().getDisplayWindow() )
+
+		for channel, value in zip( "rgba", ( 1, 0.5, 0.25, 1 ) ) :
+			self.assertAlmostEqual( stats["min"][channel].getValue(), value, delta = 0.00001 )
+			self.assertAlmostEqual( stats["max"][channel].getValue(), value, delta = 0.00001 )
+
 if __name__ == "__main__":
 	unittest.main()
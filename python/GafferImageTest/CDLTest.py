@@ -172,5 +172,56 @@ class CDLTest( GafferImageTest.ImageTestCase ) :
 		self.assertEqual( i["out"]["metadata"].getValue(), o["out"]["metadata"].getValue() )
 		self.assertEqual( i["out"]["channelNames"].getValue(), o["out"]["channelNames"].getValue() )
 
+	def __chain( self, input, breakChain = False ) :
+
+		result = []
+		for slope, offset in [ ( 2, 0.1 ), ( 0.5, 0.2 ), ( 1.5, -0.1 ) ] :
+
+			if breakChain :
+				# An identity Grade isn't a ColorProcessor, so
+				# prevents us fusing with the nodes upstream.
+				grade = GafferImage.Grade()
+				grade["in"].setInput( input )
+				input = grade["out"]
+				result.append( grade )
+
+			cdl = GafferImage.CDL()
+			cdl["in"].setInput( input )
+			cdl["slope"].setValue( IECore.Color3f( slope ) )
+			cdl["offset"].setValue( IECore.Color3f( offset ) )
+			input = cdl["out"]
+			result.append( cdl )
+
+		return result
+
+	def testFusedChain( self ) :
+
+		i = GafferImage.ImageReader()
+		i["fileName"].setValue( self.imageFile )
+
+		fused = self.__chain( i["out"] )
+		unfused = self.__chain( i["out"], breakChain = True )
+
+		self.assertEqual( fused[-1]["out"].image(), unfused[-1]["out"].image() )
+
+		# Only the last node in the chain should compute
+		# and cache colour data.
+
+		memoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( memoryLimit )
+		with Gaffer.PerformanceMonitor() as m :
+			GafferImageTest.processTiles( fused[-1]["out"] )
+
+		self.assertEqual( m.plugStatistics( fused[0]["__colorData"] ).computeCount, 0 )
+		self.assertEqual( m.plugStatistics( fused[1]["__colorData"] ).computeCount, 0 )
+		self.assertGreater( m.plugStatistics( fused[2]["__colorData"] ).computeCount, 0 )
+
+		# Disabled nodes should be skipped.
+
+		fused[1]["enabled"].setValue( False )
+		unfused[3]["enabled"].setValue( False )
+		self.assertEqual( fused[-1]["out"].image(), unfused[-1]["out"].image() )
+
 if __name__ == "__main__":
 	unittest.main()
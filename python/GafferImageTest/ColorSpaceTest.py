@@ -151,5 +151,50 @@ class ColorSpaceTest( GafferImageTest.ImageTestCase ) :
 		self.assertEqual( i["out"]["dataWindow"].getValue(), o["out"]["dataWindow"].getValue() )
 		self.assertEqual( i["out"]["channelNames"].getValue(), o["out"]["channelNames"].getValue() )
 
+	def testProcessorsFollowSettings( self ) :
+
+		i = GafferImage.ImageReader()
+		i["fileName"].setValue( self.fileName )
+
+		o1 = GafferImage.ColorSpace()
+		o1["in"].setInput( i["out"] )
+		o1["inputSpace"].setValue( "linear" )
+		o1["outputSpace"].setValue( "sRGB" )
+
+		o2 = GafferImage.ColorSpace()
+		o2["in"].setInput( i["out"] )
+		o2["inputSpace"].setValue( "sRGB" )
+		o2["outputSpace"].setValue( "linear" )
+
+		image1 = o1["out"].image()
+		image2 = o2["out"].image()
+		self.assertNotEqual( image1, image2 )
+
+		# Swapping the settings must pick up the processor
+		# matching the new settings rather than a stale one.
+
+		o1["inputSpace"].setValue( "sRGB" )
+		o1["outputSpace"].setValue( "linear" )
+		o2["inputSpace"].setValue( "linear" )
+		o2["outputSpace"].setValue( "sRGB" )
+
+		self.assertEqual( o1["out"].image(), image2 )
+		self.assertEqual( o2["out"].image(), image1 )
+
+	def testInvalidColorSpaceErrorsAreRepeated( self ) :
+
+		i = GafferImage.ImageReader()
+		i["fileName"].setValue( self.fileName )
+
+		o = GafferImage.ColorSpace()
+		o["in"].setInput( i["out"] )
+		o["inputSpace"].setValue( "linear" )
+		o["outputSpace"].setValue( "notAColorSpace" )
+
+		# Failed computes aren't cached, so the second call
+		# must produce the same descriptive error as the first.
+		for n in range( 0, 2 ) :
+			self.assertRaisesRegexp( RuntimeError, "notAColorSpace", o["out"].channelData, "R", IECore.V2i( 0 ) )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -60,14 +60,14 @@ class DisplayTest( GafferImageTest.ImageTestCase ) :
 
 	def __dataReceived( self, plug ) :
 
-		# Emulate the DisplayUI code which increments a plug when data is received, to
+		# Emulate the DisplayUI code which applies the data when it is received, to
 		# trigger correct recomputation.
-		plug.node()["__updateCount"].setValue( plug.node()["__updateCount"].getValue() + 1 )
+		plug.node().applyReceivedData()
 		self.__dataReceivedSemaphore.release()
 
 	def __imageReceived( self, plug ) :
 
-		plug.node()["__updateCount"].setValue( plug.node()["__updateCount"].getValue() + 1 )
+		plug.node().applyReceivedData()
 		self.__imageReceivedSemaphore.release()
 
 	def testDefaultFormat( self ) :
@@ -214,6 +214,75 @@ class DisplayTest( GafferImageTest.ImageTestCase ) :
 
 		return node
 
+	def testUpdatesRecomputeOnlyAffectedTiles( self ) :
+
+		node = GafferImage.Display()
+		node["port"].setValue( 2500 )
+
+		grade = GafferImage.Grade()
+		grade["in"].setInput( node["out"] )
+		grade["gain"].setValue( IECore.Color3f( 2 ) )
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+		externalWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( tileSize * 4 - 1 ) )
+		driver = IECore.ClientDisplayDriver(
+			externalWindow,
+			externalWindow,
+			[ "R" ],
+			{
+				"displayHost" : "localHost",
+				"displayPort" : "2500",
+				"remoteDisplayType" : "GafferImage::GafferDisplayDriver",
+			}
+		)
+
+		driver.imageData( externalWindow, IECore.FloatVectorData( [ 1 ] * ( tileSize * 4 ) ** 2 ) )
+		self.__dataReceivedSemaphore.acquire()
+		GafferImageTest.processTiles( grade["out"] )
+
+		# A bucket only dirties the channel data, and declares the region
+		# it covers, which is passed through the Grade because it processes
+		# each pixel independently.
+
+		dirtied = []
+		regions = []
+		def plugDirtied( plug ) :
+			dirtied.append( plug.relativeName( grade ) )
+			regions.append( grade["out"].dirtyRegion() )
+
+		plugDirtiedConnection = grade.plugDirtiedSignal().connect( plugDirtied )
+
+		bucketWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( tileSize - 1 ) )
+		driver.imageData( bucketWindow, IECore.FloatVectorData( [ 2 ] * tileSize ** 2 ) )
+		self.__dataReceivedSemaphore.acquire()
+
+		del plugDirtiedConnection
+
+		gafferBucketWindow = node["out"]["format"].getValue().fromEXRSpace( bucketWindow )
+		self.assertEqual( set( dirtied ), { "in.channelData", "in", "out.channelData", "out" } )
+		for region in regions :
+			self.assertEqual( region, gafferBucketWindow )
+
+		# Clients which don't use the region still rehash every tile. But
+		# the hashes of the tiles that the bucket didn't touch are unchanged,
+		# so their values are reused from the cache, and only the touched
+		# tile is recomputed.
+
+		with Gaffer.PerformanceMonitor() as m :
+			GafferImageTest.processTiles( grade["out"] )
+
+		self.assertEqual( m.plugStatistics( grade["out"]["channelData"] ).computeCount, 1 )
+		self.assertGreaterEqual( m.plugStatistics( grade["out"]["channelData"] ).hashCount, 16 )
+
+		# Outside of the update, the region is unknown.
+
+		self.assertEqual(
+			grade["out"].dirtyRegion(),
+			IECore.Box2i( IECore.V2i( -2 ** 31 ), IECore.V2i( 2 ** 31 - 1 ) )
+		)
+
+		driver.imageClose()
+
 	def __tiles( self, node, channelName ) :
 
 		dataWindow = node["out"]["dataWindow"].getValue()
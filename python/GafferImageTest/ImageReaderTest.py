@@ -373,5 +373,93 @@ class ImageReaderTest( GafferImageTest.ImageTestCase ) :
 				context.setFrame( i )
 				assertHold( 7 )
 
+	def __writeConstant( self, fileName, dataType, size = 64 ) :
+
+		c = GafferImage.Constant()
+		c["format"].setValue( GafferImage.Format( size, size ) )
+		c["color"].setValue( IECore.Color4f( 0.1, 0.2, 0.3, 1 ) )
+
+		w = GafferImage.ImageWriter()
+		w["in"].setInput( c["out"] )
+		w["fileName"].setValue( fileName )
+		w["openexr"]["dataType"].setValue( dataType )
+		w["task"].execute()
+
+	def testHalfTilesUseLessCacheMemory( self ) :
+
+		fileName = self.temporaryDirectory() + "/half.exr"
+		self.__writeConstant( fileName, "half" )
+
+		reader = GafferImage.ImageReader()
+		reader["fileName"].setValue( fileName )
+
+		memoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( memoryLimit )
+		memoryBefore = Gaffer.ValuePlug.cacheMemoryUsage()
+		tile = reader["out"].channelData( "R", IECore.V2i( 0 ) )
+		memoryUsed = Gaffer.ValuePlug.cacheMemoryUsage() - memoryBefore
+
+		self.assertLess( memoryUsed, tile.memoryUsage() * 0.6 )
+
+		# The values must be returned exactly as they are
+		# in the file.
+
+		oiioReader = GafferImage.OpenImageIOReader()
+		oiioReader["fileName"].setValue( fileName )
+		self.assertEqual( tile, oiioReader["out"].channelData( "R", IECore.V2i( 0 ) ) )
+		self.assertEqual( reader["out"].image(), oiioReader["out"].image() )
+
+	def testHalfTilesUseLessCacheMemoryWithColorConversion( self ) :
+
+		fileName = self.temporaryDirectory() + "/half.exr"
+		self.__writeConstant( fileName, "half", size = 256 )
+
+		reader = GafferImage.ImageReader()
+		reader["fileName"].setValue( fileName )
+
+		# ImageWriter never writes the oiio:ColorSpace metadata which
+		# ImageReader uses to choose the conversion, so we must force
+		# the conversion on the internal ColorSpace node instead.
+
+		reader["__colorSpace"]["inputSpace"].setInput( None )
+		reader["__colorSpace"]["inputSpace"].setValue( "sRGB" )
+
+		oiioReader = GafferImage.OpenImageIOReader()
+		oiioReader["fileName"].setValue( fileName )
+		self.assertNotEqual(
+			reader["out"].channelData( "R", IECore.V2i( 0 ) ),
+			oiioReader["out"].channelData( "R", IECore.V2i( 0 ) )
+		)
+
+		memoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( memoryLimit )
+		memoryBefore = Gaffer.ValuePlug.cacheMemoryUsage()
+		image = reader["out"].image()
+		memoryUsed = Gaffer.ValuePlug.cacheMemoryUsage() - memoryBefore
+
+		# The file data is cached at half precision, and only the converted
+		# RGB channels are cached at float precision. Caching the file data
+		# at float precision as well would use more than twice as much.
+
+		floatMemory = sum( [ image[n].data.memoryUsage() for n in image.keys() ] )
+		self.assertLess( memoryUsed, floatMemory * 1.5 )
+
+	def testFloatTilesAreNotTruncated( self ) :
+
+		fileName = self.temporaryDirectory() + "/float.exr"
+		self.__writeConstant( fileName, "float" )
+
+		reader = GafferImage.ImageReader()
+		reader["fileName"].setValue( fileName )
+
+		oiioReader = GafferImage.OpenImageIOReader()
+		oiioReader["fileName"].setValue( fileName )
+
+		tile = reader["out"].channelData( "R", IECore.V2i( 0 ) )
+		self.assertEqual( tile, oiioReader["out"].channelData( "R", IECore.V2i( 0 ) ) )
+		self.assertAlmostEqual( tile[0], 0.1, places = 7 )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -39,6 +39,7 @@ import unittest
 
 import IECore
 
+import Gaffer
 import GafferTest
 import GafferImage
 import GafferImageTest
@@ -168,6 +169,52 @@ class ImageStatsTest( GafferImageTest.ImageTestCase ) :
 
 		self.assertEqual( s["max"]["r"].getValue(), 0 )
 
+	def testNegativeValues( self ) :
+
+		c = GafferImage.Constant()
+		c["color"].setValue( IECore.Color4f( -1, -2, -3, -4 ) )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( c["out"] )
+		s["regionOfInterest"].setValue( c["out"]["format"].getValue().getDisplayWindow() )
+
+		self.__assertColour( s["average"].getValue(), IECore.Color4f( -1, -2, -3, -4 ) )
+		self.__assertColour( s["min"].getValue(), IECore.Color4f( -1, -2, -3, -4 ) )
+		self.__assertColour( s["max"].getValue(), IECore.Color4f( -1, -2, -3, -4 ) )
+
+	def testROIOutsideDataWindow( self ) :
+
+		c = GafferImage.Constant()
+		c["format"].setValue( GafferImage.Format( 100, 100 ) )
+		c["color"].setValue( IECore.Color4f( 1, 0.5, 0.25, 1 ) )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( c["out"] )
+		s["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 50 ), IECore.V2i( 150 ) ) )
+
+		# Pixels outside the data window count as black.
+		self.__assertColour( s["average"].getValue(), IECore.Color4f( 0.25, 0.125, 0.0625, 0.25 ) )
+		self.__assertColour( s["min"].getValue(), IECore.Color4f( 0 ) )
+		self.__assertColour( s["max"].getValue(), IECore.Color4f( 1, 0.5, 0.25, 1 ) )
+
+	def testOutputsShareComputation( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( self.__rgbFilePath )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( r["out"] )
+		s["regionOfInterest"].setValue( r["out"]["format"].getValue().getDisplayWindow() )
+
+		# All the outputs are read from the results
+		# of a single pass over the image.
+		with Gaffer.PerformanceMonitor() as m :
+			s["average"].getValue()
+			s["min"].getValue()
+			s["max"].getValue()
+
+		self.assertEqual( m.plugStatistics( s["__allStats"] ).computeCount, 1 )
+
 	def __assertColour( self, colour1, colour2 ) :
 		for i in range( 0, 4 ):
 			self.assertEqual( "%.4f" % colour2[i], "%.4f" % colour1[i] )
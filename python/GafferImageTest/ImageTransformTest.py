@@ -291,5 +291,72 @@ class ImageTransformTest( GafferImageTest.ImageTestCase ) :
 		self.assertGreater( sample( IECore.V2i( 10, 10 ) ), 0.9 )
 		self.assertGreater( sample( IECore.V2i( 11, 10 ) ), 0.09 )
 
+	def testConcatenation( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( self.fileName )
+
+		t1 = GafferImage.ImageTransform()
+		t1["in"].setInput( r["out"] )
+		t1["transform"]["scale"].setValue( IECore.V2f( 0.5 ) )
+
+		o = GafferImage.Offset()
+		o["in"].setInput( t1["out"] )
+		o["offset"].setValue( IECore.V2i( 10, 20 ) )
+
+		t2 = GafferImage.ImageTransform()
+		t2["in"].setInput( o["out"] )
+		t2["transform"]["translate"].setValue( IECore.V2f( 0.5, 0 ) )
+
+		# The chain should be resampled once from the reader,
+		# giving exactly the same result as the equivalent
+		# single transform. Filtering each step separately
+		# would give a softer result.
+
+		t3 = GafferImage.ImageTransform()
+		t3["in"].setInput( r["out"] )
+		t3["transform"]["scale"].setValue( IECore.V2f( 0.5 ) )
+		t3["transform"]["translate"].setValue( IECore.V2f( 10.5, 20 ) )
+
+		self.assertImagesEqual( t2["out"], t3["out"] )
+
+		# Changes upstream must still be reflected downstream.
+
+		t1["transform"]["scale"].setValue( IECore.V2f( 0.25 ) )
+		t3["transform"]["scale"].setValue( IECore.V2f( 0.25 ) )
+		self.assertImagesEqual( t2["out"], t3["out"] )
+
+		# Disabled nodes are skipped over.
+
+		t1["enabled"].setValue( False )
+		t3["transform"]["scale"].setValue( IECore.V2f( 1 ) )
+		self.assertImagesEqual( t2["out"], t3["out"] )
+
+	def testRotationIsNotConcatenated( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( self.fileName )
+
+		t1 = GafferImage.ImageTransform()
+		t1["in"].setInput( r["out"] )
+		t1["transform"]["rotate"].setValue( 45 )
+
+		t2 = GafferImage.ImageTransform()
+		t2["in"].setInput( t1["out"] )
+		t2["transform"]["scale"].setValue( IECore.V2f( 0.5 ) )
+
+		# A Grade with default settings doesn't change the
+		# image, but prevents any concatenation, giving us
+		# a reference to compare against.
+
+		g = GafferImage.Grade()
+		g["in"].setInput( t1["out"] )
+
+		t3 = GafferImage.ImageTransform()
+		t3["in"].setInput( g["out"] )
+		t3["transform"]["scale"].setValue( IECore.V2f( 0.5 ) )
+
+		self.assertImagesEqual( t2["out"], t3["out"] )
+
 if __name__ == "__main__":
 	unittest.main()
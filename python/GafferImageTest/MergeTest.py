@@ -195,23 +195,21 @@ class MergeTest( GafferImageTest.ImageTestCase ) :
 
 		c1["color"]["r"].setValue( 0.1 )
 
-		self.assertEqual( len( cs ), 5 )
-		self.assertTrue( cs[0][0].isSame( m["in"][0]["channelData"] ) )
-		self.assertTrue( cs[1][0].isSame( m["in"][0] ) )
-		self.assertTrue( cs[2][0].isSame( m["in"] ) )
-		self.assertTrue( cs[3][0].isSame( m["out"]["channelData"] ) )
-		self.assertTrue( cs[4][0].isSame( m["out"] ) )
+		dirtiedPlugs = set( [ x[0].relativeName( x[0].node() ) for x in cs ] )
+		self.assertEqual(
+			dirtiedPlugs,
+			set( [ "in.in0.channelData", "in.in0", "in", "__mergedData", "out.channelData", "out" ] )
+		)
 
 		del cs[:]
 
 		c2["color"]["g"].setValue( 0.2 )
 
-		self.assertEqual( len( cs ), 5 )
-		self.assertTrue( cs[0][0].isSame( m["in"][1]["channelData"] ) )
-		self.assertTrue( cs[1][0].isSame( m["in"][1] ) )
-		self.assertTrue( cs[2][0].isSame( m["in"] ) )
-		self.assertTrue( cs[3][0].isSame( m["out"]["channelData"] ) )
-		self.assertTrue( cs[4][0].isSame( m["out"] ) )
+		dirtiedPlugs = set( [ x[0].relativeName( x[0].node() ) for x in cs ] )
+		self.assertEqual(
+			dirtiedPlugs,
+			set( [ "in.in1.channelData", "in.in1", "in", "__mergedData", "out.channelData", "out" ] )
+		)
 
 	def testEnabledAffects( self ) :
 
@@ -443,5 +441,52 @@ class MergeTest( GafferImageTest.ImageTestCase ) :
 
 		self.assertEqual( m["out"]["dataWindow"].getValue(), a["out"]["dataWindow"].getValue() )
 
+	def testRGBAComputedTogether( self ) :
+
+		a = GafferImage.Constant()
+		a["color"].setValue( IECore.Color4f( 0.1, 0.2, 0.3, 0.4 ) )
+
+		b = GafferImage.Constant()
+		b["color"].setValue( IECore.Color4f( 1.0, 0.3, 0.1, 0.2 ) )
+
+		merge = GafferImage.Merge()
+		merge["in"][0].setInput( a["out"] )
+		merge["in"][1].setInput( b["out"] )
+		merge["operation"].setValue( GafferImage.Merge.Operation.Over )
+
+		with Gaffer.PerformanceMonitor() as m :
+			tiles = merge["out"].channelData( [ "R", "G", "B", "A" ], IECore.V2i( 0 ) )
+
+		self.assertEqual( m.plugStatistics( merge["__mergedData"] ).computeCount, 1 )
+
+		expected = [
+			1.0 + 0.1 * ( 1 - 0.2 ),
+			0.3 + 0.2 * ( 1 - 0.2 ),
+			0.1 + 0.3 * ( 1 - 0.2 ),
+			0.2 + 0.4 * ( 1 - 0.2 ),
+		]
+		for tile, value in zip( tiles, expected ) :
+			self.assertAlmostEqual( tile[0], value, places = 6 )
+
+		# The channels must still have distinct hashes.
+
+		hashes = [ merge["out"].channelDataHash( c, IECore.V2i( 0 ) ) for c in "RGBA" ]
+		self.assertEqual( len( set( [ str( h ) for h in hashes ] ) ), 4 )
+
+	def testMultiChannelFetch( self ) :
+
+		c = GafferImage.Constant()
+		c["color"].setValue( IECore.Color4f( 0.1, 0.2, 0.3, 0.4 ) )
+
+		tiles = c["out"].channelData( [ "B", "R" ], IECore.V2i( 0 ) )
+		self.assertEqual( len( tiles ), 2 )
+		self.assertEqual( tiles[0], c["out"].channelData( "B", IECore.V2i( 0 ) ) )
+		self.assertEqual( tiles[1], c["out"].channelData( "R", IECore.V2i( 0 ) ) )
+
+		self.assertNotEqual(
+			c["out"].channelDataHash( [ "B", "R" ], IECore.V2i( 0 ) ),
+			c["out"].channelDataHash( [ "R", "B" ], IECore.V2i( 0 ) ),
+		)
+
 if __name__ == "__main__":
 	unittest.main()
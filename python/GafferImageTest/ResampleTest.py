@@ -35,6 +35,7 @@
 ##########################################################################
 
 import os
+import math
 import shutil
 import unittest
 import subprocess
@@ -177,5 +178,51 @@ class ResampleTest( GafferImageTest.ImageTestCase ) :
 		r["filterWidth"].setValue( IECore.V2f( 10 ) )
 		self.assertEqual( r["out"]["dataWindow"].getValue(), IECore.Box2i( d.min - IECore.V2i( 5 ), d.max + IECore.V2i( 5 ) ) )
 
+	@GafferTest.TestRunner.PerformanceTestMethod()
+	def testPerformance( self ) :
+
+		# Times upsizes and downsizes with each filter, checking
+		# that each produces the expected data window and preserves
+		# the average value of the image.
+
+		reader = GafferImage.ImageReader()
+		reader["fileName"].setValue( os.path.dirname( __file__ ) + "/images/checker.exr" )
+
+		inputSize = reader["out"]["format"].getValue().getDisplayWindow().size()
+
+		resample = GafferImage.Resample()
+		resample["in"].setInput( reader["out"] )
+		resample["boundingMode"].setValue( GafferImage.Sampler.BoundingMode.Clamp )
+
+		inputStats = GafferImage.ImageStats()
+		inputStats["in"].setInput( reader["out"] )
+		inputStats["regionOfInterest"].setValue( reader["out"]["dataWindow"].getValue() )
+		inputAverage = inputStats["average"]["r"].getValue()
+
+		stats = GafferImage.ImageStats()
+		stats["in"].setInput( resample["out"] )
+
+		GafferImageTest.processTiles( reader["out"] )
+
+		for filter in GafferImage.Resample.filters() :
+			for scale in ( 0.25, 0.5, 2, 8 ) :
+
+				resample["filter"].setValue( filter )
+				resample["dataWindow"].setValue(
+					IECore.Box2f( IECore.V2f( 0 ), IECore.V2f( inputSize.x * scale, inputSize.y * scale ) )
+				)
+
+				with GafferTest.TestRunner.PerformanceScope() :
+					GafferImageTest.processTiles( resample["out"] )
+
+				dataWindow = resample["out"]["dataWindow"].getValue()
+				self.assertEqual(
+					dataWindow,
+					IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( int( math.ceil( inputSize.x * scale ) ), int( math.ceil( inputSize.y * scale ) ) ) )
+				)
+
+				stats["regionOfInterest"].setValue( dataWindow )
+				self.assertAlmostEqual( stats["average"]["r"].getValue(), inputAverage, delta = 0.05, msg = "%s %.2f" % ( filter, scale ) )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -34,6 +34,7 @@
 #
 ##########################################################################
 
+import os
 import unittest
 
 import IECore
@@ -241,5 +242,31 @@ class ResizeTest( GafferImageTest.ImageTestCase ) :
 
 		self.assertEqual( r["out"]["dataWindow"].getValue(), IECore.Box2i() )
 
+	def testConcatenation( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( os.path.expandvars( "$GAFFER_ROOT/python/GafferImageTest/images/checker.exr" ) )
+		size = r["out"]["format"].getValue().getDisplayWindow().size()
+
+		r1 = GafferImage.Resize()
+		r1["in"].setInput( r["out"] )
+		r1["format"].setValue( GafferImage.Format( size.x * 2, size.y * 2 ) )
+		r1["fitMode"].setValue( r1.FitMode.Distort )
+
+		r2 = GafferImage.Resize()
+		r2["in"].setInput( r1["out"] )
+		r2["format"].setValue( GafferImage.Format( size.x / 2, size.y / 2 ) )
+		r2["fitMode"].setValue( r2.FitMode.Distort )
+
+		# The chain should be resampled once from the reader,
+		# giving the same result as resizing directly.
+
+		r3 = GafferImage.Resize()
+		r3["in"].setInput( r["out"] )
+		r3["format"].setValue( GafferImage.Format( size.x / 2, size.y / 2 ) )
+		r3["fitMode"].setValue( r3.FitMode.Distort )
+
+		self.assertImagesEqual( r2["out"], r3["out"] )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -91,7 +91,27 @@ Gaffer.Metadata.registerNode(
 			which the blur will bleed onto.
 			"""
 
-		]
+		],
+
+		"mode" : [
+
+			"description",
+			"""
+			The method used to perform the blur. Accurate uses a
+			true gaussian filter, but becomes slow for large radii.
+			Fast approximates a gaussian using several box filters,
+			and takes the same time to compute regardless of radius.
+			It is recommended for radii greater than a few tens of
+			pixels, where the approximation is indistinguishable
+			from a true gaussian.
+			""",
+
+			"preset:Accurate", GafferImage.Blur.Mode.Accurate,
+			"preset:Fast", GafferImage.Blur.Mode.Fast,
+
+			"plugValueWidget:type", "GafferUI.PresetsPlugValueWidget",
+
+		],
 
 	}
 
@@ -111,8 +111,7 @@ def __update( plug ) :
 
 	node = plug.node()
 	if node:
-		updateCountPlug = node["__updateCount"]
-		updateCountPlug.setValue( updateCountPlug.getValue() + 1 )
+		node.applyReceivedData()
 
 	global __plugsPendingUpdate
 	global __plugsPendingUpdateLock
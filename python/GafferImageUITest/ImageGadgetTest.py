@@ -35,10 +35,12 @@
 ##########################################################################
 
 import unittest
+import threading
 
 import IECore
 
 import Gaffer
+import GafferUI
 import GafferUITest
 import GafferImage
 import GafferImageUI
@@ -77,6 +79,223 @@ class ImageGadgetTest( GafferUITest.TestCase ) :
 		g.setImage( c["out"] )
 		self.assertTrue( g.getImage().isSame( c["out"] ) )
 
+	def testTileUpdatesAreBudgeted( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["constant"] = GafferImage.Constant()
+		script["constant"]["format"].setValue( GafferImage.Format( 512, 512 ) )
+
+		script["grade"] = GafferImage.Grade()
+		script["grade"]["in"].setInput( script["constant"]["out"] )
+
+		# Make every tile slow to compute, with a separate
+		# computation for each tile.
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( 'import time; time.sleep( 0.05 ); parent["grade"]["gain"]["r"] = 2 + context["image:tileOrigin"].x * 0' )
+
+		numTiles = ( 512 / GafferImage.ImagePlug.tileSize() ) ** 2
+
+		g = GafferImageUI.ImageGadget()
+		g.setSoloChannel( 0 )
+		g.setImage( script["grade"]["out"] )
+
+		# A single idle event must return control to the UI once
+		# the budget is used up, rather than completing a whole
+		# batch of slow tiles.
+
+		with Gaffer.PerformanceMonitor() as m :
+			GafferUI.Gadget.idleSignal()()
+
+		computeCount = m.plugStatistics( script["grade"]["out"]["channelData"] ).computeCount
+		self.assertGreater( computeCount, 0 )
+		self.assertLess( computeCount, numTiles )
+		self.assertFalse( GafferUI.Gadget.idleSignal().empty() )
+
+		# Dirtying the image must cancel the remaining tiles of
+		# the previous update, so that each tile is only computed
+		# once for the new image, and the update must eventually
+		# complete.
+
+		script["grade"]["offset"]["r"].setValue( 0.1 )
+
+		with Gaffer.PerformanceMonitor() as m :
+			while not GafferUI.Gadget.idleSignal().empty() :
+				GafferUI.Gadget.idleSignal()()
+
+		self.assertEqual( m.plugStatistics( script["grade"]["out"]["channelData"] ).computeCount, numTiles )
+
+	def testViewportCulling( self ) :
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+		script = self.__tileDependentImage( tileSize * 16 )
+
+		g = GafferImageUI.ImageGadget()
+		g.setSoloChannel( 0 )
+		g.setImage( script["grade"]["out"] )
+
+		# Show a region of two by two tiles at one image pixel
+		# per screen pixel. Only tiles overlapping the viewport
+		# should be computed.
+
+		v = GafferUI.ViewportGadget( g )
+		v.setCamera( IECore.Camera( parameters = { "projection" : "orthographic" } ) )
+		v.setViewport( IECore.V2i( tileSize * 2 ) )
+		v.frame( IECore.Box3f( IECore.V3f( 0 ), IECore.V3f( tileSize * 2, tileSize * 2, 0 ) ), IECore.V3f( 0, 0, -1 ) )
+
+		with Gaffer.PerformanceMonitor() as m :
+			self.__waitForUpdate()
+
+		computeCount = m.plugStatistics( script["grade"]["out"]["channelData"] ).computeCount
+		self.assertGreaterEqual( computeCount, 4 )
+		self.assertLessEqual( computeCount, 9 )
+		self.assertEqual( self.__resampledTiles( m ), 0 )
+
+		# Zooming in within the region we already have
+		# shouldn't require any further updates.
+
+		v.frame( IECore.Box3f( IECore.V3f( 0 ), IECore.V3f( tileSize, tileSize, 0 ) ), IECore.V3f( 0, 0, -1 ) )
+		self.assertTrue( GafferUI.Gadget.idleSignal().empty() )
+
+	def testProxyLevels( self ) :
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+		script = self.__tileDependentImage( tileSize * 32 )
+
+		script["crop"] = GafferImage.Crop()
+		script["crop"]["in"].setInput( script["grade"]["out"] )
+		script["crop"]["affectDisplayWindow"].setValue( False )
+		script["crop"]["area"].setValue( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( tileSize * 16 ) ) )
+
+		g = GafferImageUI.ImageGadget()
+		g.setSoloChannel( 0 )
+		g.setImage( script["crop"]["out"] )
+
+		# Show the whole display window in a viewport around ten
+		# times smaller, which should use proxy level 3. At that
+		# level the cropped data window is covered by two by two
+		# tiles.
+
+		v = GafferUI.ViewportGadget( g )
+		v.setCamera( IECore.Camera( parameters = { "projection" : "orthographic" } ) )
+		v.setViewport( IECore.V2i( tileSize * 3 ) )
+		v.frame( g.bound(), IECore.V3f( 0, 0, -1 ) )
+
+		with Gaffer.PerformanceMonitor() as m :
+			self.__waitForUpdate()
+
+		self.assertEqual( self.__resampledTiles( m ), 4 )
+
+		# The proxy must follow changes to the data window of
+		# the input. Now the data window is covered by four by
+		# four tiles, and at least the new ones must be computed.
+
+		script["crop"]["area"].setValue( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( tileSize * 32 ) ) )
+
+		with Gaffer.PerformanceMonitor() as m :
+			self.__waitForUpdate()
+
+		self.assertGreaterEqual( self.__resampledTiles( m ), 12 )
+		self.assertLessEqual( self.__resampledTiles( m ), 16 )
+
+		# Zooming in to one pixel per screen pixel should return
+		# to the original image, so that changes to it only need
+		# the visible tiles to be recomputed, without resampling.
+
+		v.frame( IECore.Box3f( IECore.V3f( 0 ), IECore.V3f( tileSize * 3, tileSize * 3, 0 ) ), IECore.V3f( 0, 0, -1 ) )
+		script["grade"]["offset"]["r"].setValue( 0.1 )
+
+		with Gaffer.PerformanceMonitor() as m :
+			self.__waitForUpdate()
+
+		self.assertEqual( self.__resampledTiles( m ), 0 )
+		computeCount = m.plugStatistics( script["grade"]["out"]["channelData"] ).computeCount
+		self.assertGreaterEqual( computeCount, 9 )
+		self.assertLessEqual( computeCount, 16 )
+
+	def testDisplayUpdatesOnlyAffectedTiles( self ) :
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+
+		display = GafferImage.Display()
+		display["port"].setValue( 2501 )
+
+		dataReceivedSemaphore = threading.Semaphore( 0 )
+		dataReceivedConnection = GafferImage.Display.dataReceivedSignal().connect( lambda plug : dataReceivedSemaphore.release() )
+
+		externalWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( tileSize * 4 - 1 ) )
+		driver = IECore.ClientDisplayDriver(
+			externalWindow,
+			externalWindow,
+			[ "R" ],
+			{
+				"displayHost" : "localHost",
+				"displayPort" : "2501",
+				"remoteDisplayType" : "GafferImage::GafferDisplayDriver",
+			}
+		)
+
+		driver.imageData( externalWindow, IECore.FloatVectorData( [ 1 ] * ( tileSize * 4 ) ** 2 ) )
+		dataReceivedSemaphore.acquire()
+		display.applyReceivedData()
+
+		g = GafferImageUI.ImageGadget()
+		g.setImage( display["out"] )
+
+		with Gaffer.PerformanceMonitor() as m :
+			self.__waitForUpdate()
+
+		self.assertEqual( m.plugStatistics( display["out"]["channelData"] ).hashCount, 16 )
+
+		# A bucket covering a single tile should only cause that
+		# tile to be updated, rather than the whole image.
+
+		bucketWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( tileSize - 1 ) )
+		driver.imageData( bucketWindow, IECore.FloatVectorData( [ 2 ] * tileSize ** 2 ) )
+		dataReceivedSemaphore.acquire()
+
+		with Gaffer.PerformanceMonitor() as m :
+			display.applyReceivedData()
+			self.__waitForUpdate()
+
+		self.assertEqual( m.plugStatistics( display["out"]["channelData"] ).hashCount, 1 )
+		self.assertEqual( m.plugStatistics( display["out"]["channelData"] ).computeCount, 1 )
+
+		driver.imageClose()
+
+	def __tileDependentImage( self, size ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["constant"] = GafferImage.Constant()
+		script["constant"]["format"].setValue( GafferImage.Format( size, size ) )
+
+		# Make the Grade compute separately for each tile,
+		# so that we can count the tiles the gadget uses.
+		script["grade"] = GafferImage.Grade()
+		script["grade"]["in"].setInput( script["constant"]["out"] )
+
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( 'parent["grade"]["gain"]["r"] = 2 + context["image:tileOrigin"].x * 0' )
+
+		return script
+
+	def __waitForUpdate( self ) :
+
+		while not GafferUI.Gadget.idleSignal().empty() :
+			GafferUI.Gadget.idleSignal()()
+
+	# Returns the number of tiles computed by the Resample
+	# nodes the gadget uses to generate proxy levels.
+	def __resampledTiles( self, monitor ) :
+
+		result = 0
+		for plug, statistics in monitor.allStatistics().items() :
+			if isinstance( plug.node(), GafferImage.Resample ) and plug.fullName().endswith( ".out.channelData" ) :
+				result += statistics.computeCount
+
+		return result
+
 if __name__ == "__main__":
 	unittest.main()
 
@@ -0,0 +1,139 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+
+import IECore
+
+import GafferTest
+import GafferScene
+
+class CapturingRendererTest( GafferTest.TestCase ) :
+
+	def testFactory( self ) :
+
+		self.assertTrue( "Capturing" in GafferScene.Private.IECoreScenePreview.Renderer.types() )
+
+		r = GafferScene.Private.IECoreScenePreview.Renderer.create( "Capturing" )
+		self.assertTrue( isinstance( r, GafferScene.Private.IECoreScenePreview.CapturingRenderer ) )
+
+	def testOptionsAndOutputs( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.CapturingRenderer()
+
+		r.option( "test", IECore.IntData( 10 ) )
+		self.assertEqual( r.capturedOption( "test" ), IECore.IntData( 10 ) )
+		r.option( "test", None )
+		self.assertEqual( r.capturedOption( "test" ), None )
+
+		o = IECore.Display( "beauty.exr", "exr", "rgba" )
+		r.output( "beauty", o )
+		self.assertEqual( r.capturedOutput( "beauty" ), o )
+		r.output( "beauty", None )
+		self.assertEqual( r.capturedOutput( "beauty" ), None )
+
+	def testObjects( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.CapturingRenderer()
+
+		attributes = r.attributes( IECore.CompoundObject( { "doubleSided" : IECore.BoolData( False ) } ) )
+
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		o = r.object( "/plane", plane )
+		o.attributes( attributes )
+		o.transform( IECore.M44f.createTranslated( IECore.V3f( 1, 2, 3 ) ) )
+
+		self.assertEqual( r.capturedObjectNames(), [ "/plane" ] )
+
+		c = r.capturedObject( "/plane" )
+		self.assertEqual( c.capturedName(), "/plane" )
+		self.assertEqual( c.capturedSamples(), [ plane ] )
+		self.assertEqual( c.capturedTransforms(), [ IECore.M44f.createTranslated( IECore.V3f( 1, 2, 3 ) ) ] )
+		self.assertEqual( c.capturedAttributes().attributes(), IECore.CompoundObject( { "doubleSided" : IECore.BoolData( False ) } ) )
+		self.assertEqual( c.numTransformEdits(), 1 )
+		self.assertEqual( c.numAttributeEdits(), 1 )
+
+		del o, c
+		self.assertEqual( r.capturedObjectNames(), [] )
+		self.assertEqual( r.capturedObject( "/plane" ), None )
+
+	def testInstances( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.CapturingRenderer()
+
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		o1 = r.instance( "/plane1", plane, plane.hash() )
+		o2 = r.instance( "/plane2", plane, plane.hash() )
+		o3 = r.object( "/plane3", plane )
+
+		self.assertEqual( r.capturedObject( "/plane1" ).capturedHash(), plane.hash() )
+		self.assertEqual( r.capturedObject( "/plane2" ).capturedHash(), plane.hash() )
+		self.assertEqual( r.capturedObject( "/plane3" ).capturedHash(), IECore.MurmurHash() )
+
+	def testRetainedObjects( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.CapturingRenderer(
+			GafferScene.Private.IECoreScenePreview.Renderer.RenderType.Batch
+		)
+
+		r.object( "/plane", IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) ) )
+		self.assertEqual( r.capturedObjectNames(), [ "/plane" ] )
+
+		r.render()
+		self.assertEqual( r.numRenders(), 1 )
+
+	def testObjectsOutliveRenderer( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.CapturingRenderer()
+
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		o1 = r.object( "/plane", plane )
+		# Replaces the first object in the captured objects,
+		# but both must still be detached from the renderer.
+		o2 = r.object( "/plane", plane )
+		c = r.capturedObject( "/plane" )
+
+		del r
+
+		o1.transform( IECore.M44f.createTranslated( IECore.V3f( 1 ) ) )
+		o2.transform( IECore.M44f.createTranslated( IECore.V3f( 2 ) ) )
+		self.assertEqual( c.capturedName(), "/plane" )
+		self.assertEqual( c.capturedTransforms(), [ IECore.M44f.createTranslated( IECore.V3f( 2 ) ) ] )
+
+		del o1, o2, c
+
+if __name__ == "__main__":
+	unittest.main()
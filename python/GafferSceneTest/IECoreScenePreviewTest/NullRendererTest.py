@@ -0,0 +1,102 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+
+import IECore
+
+import Gaffer
+import GafferTest
+import GafferScene
+
+class NullRendererTest( GafferTest.TestCase ) :
+
+	def testFactory( self ) :
+
+		self.assertTrue( "Null" in GafferScene.Private.IECoreScenePreview.Renderer.types() )
+
+		r = GafferScene.Private.IECoreScenePreview.Renderer.create( "Null" )
+		self.assertTrue( isinstance( r, GafferScene.Private.IECoreScenePreview.NullRenderer ) )
+
+	def testStatistics( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.NullRenderer()
+
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		a = r.attributes( IECore.CompoundObject() )
+		for i in range( 0, 10 ) :
+			o = r.instance( "/plane%d" % i, plane, plane.hash() )
+			o.attributes( a )
+			o.transform( IECore.M44f() )
+
+		r.object( "/plane", plane )
+		r.render()
+
+		s = r.statistics()
+		self.assertEqual( s["instance"].value, 10 )
+		self.assertEqual( s["object"].value, 1 )
+		self.assertEqual( s["attributes"].value, 1 )
+		self.assertEqual( s["attributesEdit"].value, 10 )
+		self.assertEqual( s["transformEdit"].value, 10 )
+		self.assertEqual( s["render"].value, 1 )
+		self.assertTrue( s["outputTime"].value >= 0 )
+
+	def testObjectsOutliveRenderer( self ) :
+
+		r = GafferScene.Private.IECoreScenePreview.NullRenderer()
+
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+		o = r.object( "/plane", plane )
+
+		del r
+
+		o.transform( IECore.M44f() )
+		o.attributes( None )
+		del o
+
+	def testRenderThroughRenderNode( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		s["plane"] = GafferScene.Plane()
+		s["render"] = GafferScene.Preview.Render()
+		s["render"]["renderer"].setValue( "Null" )
+		s["render"]["in"].setInput( s["plane"]["out"] )
+
+		s["render"]["task"].execute()
+
+if __name__ == "__main__":
+	unittest.main()
@@ -35,6 +35,8 @@
 #
 ##########################################################################
 
+import math
+
 import IECore
 
 import Gaffer
@@ -457,5 +459,698 @@ class InstancerTest( GafferSceneTest.SceneTestCase ) :
 
 			script["reference"].load( self.temporaryDirectory() + "/test.grf" )
 
+	def testIdIndependentPrototypesShareHashes( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["plane"]["divisions"].setValue( IECore.V2i( 2 ) )
+
+		script["sphere"] = GafferScene.Sphere()
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["plane"]["out"] )
+		script["instancer"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer"]["parent"].setValue( "/plane" )
+
+		# The prototype doesn't use "instancer:id", so all instances
+		# should share the same hashes.
+
+		self.assertEqual(
+			script["instancer"]["out"].objectHash( "/plane/instances/0/sphere" ),
+			script["instancer"]["out"].objectHash( "/plane/instances/1/sphere" ),
+		)
+		self.assertEqual(
+			script["instancer"]["out"].boundHash( "/plane/instances/0" ),
+			script["instancer"]["out"].boundHash( "/plane/instances/1" ),
+		)
+
+		# But as soon as it does, the instances must be
+		# computed individually.
+
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( "parent['sphere']['radius'] = 1 + context['instancer:id']" )
+
+		self.assertNotEqual(
+			script["instancer"]["out"].objectHash( "/plane/instances/0/sphere" ),
+			script["instancer"]["out"].objectHash( "/plane/instances/1/sphere" ),
+		)
+
+		expectedBound = IECore.Box3f()
+		for i in range( 0, 9 ) :
+			instancePath = "/plane/instances/%d" % i
+			self.assertEqual(
+				script["instancer"]["out"].bound( instancePath + "/sphere" ),
+				IECore.Box3f( IECore.V3f( -1 - i ), IECore.V3f( 1 + i ) )
+			)
+			expectedBound.extendBy(
+				script["instancer"]["out"].bound( instancePath ).transform( script["instancer"]["out"].transform( instancePath ) )
+			)
+
+		self.assertEqual( script["instancer"]["out"].bound( "/plane/instances" ), expectedBound )
+
+		self.assertSceneValid( script["instancer"]["out"] )
+
+		# Dependencies on the id must be detected even when they
+		# only affect the result for some ids, as is typical when
+		# using a SceneSwitch to choose between several prototypes.
+
+		del script["expression"]
+		script["sphere"]["radius"].setValue( 1 )
+
+		script["bigSphere"] = GafferScene.Sphere()
+		script["bigSphere"]["radius"].setValue( 2 )
+
+		script["switch"] = GafferScene.SceneSwitch()
+		script["switch"]["in"][0].setInput( script["sphere"]["out"] )
+		script["switch"]["in"][1].setInput( script["bigSphere"]["out"] )
+		script["instancer"]["instance"].setInput( script["switch"]["out"] )
+
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( "parent['switch']['index'] = 1 if context.get( 'instancer:id', 0 ) > 5 else 0" )
+
+		self.assertEqual(
+			script["instancer"]["out"].objectHash( "/plane/instances/0/sphere" ),
+			script["instancer"]["out"].objectHash( "/plane/instances/1/sphere" ),
+		)
+		self.assertNotEqual(
+			script["instancer"]["out"].objectHash( "/plane/instances/0/sphere" ),
+			script["instancer"]["out"].objectHash( "/plane/instances/6/sphere" ),
+		)
+
+		expectedBound = IECore.Box3f()
+		for i in range( 0, 9 ) :
+			instancePath = "/plane/instances/%d" % i
+			radius = 2 if i > 5 else 1
+			self.assertEqual(
+				script["instancer"]["out"].bound( instancePath + "/sphere" ),
+				IECore.Box3f( IECore.V3f( -radius ), IECore.V3f( radius ) )
+			)
+			expectedBound.extendBy(
+				script["instancer"]["out"].bound( instancePath ).transform( script["instancer"]["out"].transform( instancePath ) )
+			)
+
+		self.assertEqual( script["instancer"]["out"].bound( "/plane/instances" ), expectedBound )
+
+		self.assertSceneValid( script["instancer"]["out"] )
+
+	def testPrototypes( self ) :
+
+		sphere = IECore.SpherePrimitive()
+		plane = IECore.MeshPrimitive.createPlane( IECore.Box2f( IECore.V2f( -1 ), IECore.V2f( 1 ) ) )
+
+		instanceInput = GafferSceneTest.CompoundObjectSource()
+		instanceInput["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( IECore.Box3f( IECore.V3f( -1 ), IECore.V3f( 3, 1, 1 ) ) ),
+				"children" : {
+					"sphere" : {
+						"object" : sphere,
+						"bound" : IECore.Box3fData( sphere.bound() ),
+					},
+					"plane" : {
+						"object" : plane,
+						"bound" : IECore.Box3fData( plane.bound() ),
+						"transform" : IECore.M44fData( IECore.M44f.createTranslated( IECore.V3f( 2, 0, 0 ) ) ),
+					},
+				}
+			} )
+		)
+
+		points = IECore.PointsPrimitive(
+			IECore.V3fVectorData(
+				[ IECore.V3f( 0, 0, 0 ), IECore.V3f( 10, 0, 0 ), IECore.V3f( 20, 0, 0 ), IECore.V3f( 30, 0, 0 ) ]
+			)
+		)
+		points["index"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( [ 0, 1, 2, -1 ] ) )
+		points["orient"] = IECore.PrimitiveVariable(
+			IECore.PrimitiveVariable.Interpolation.Vertex,
+			IECore.QuatfVectorData( [ IECore.Quatf().setAxisAngle( IECore.V3f( 0, 0, 1 ), math.pi / 2 ) ] * 4 )
+		)
+		points["scale"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 1, 2, 3, 4 ] ) )
+
+		pointsInput = GafferSceneTest.CompoundObjectSource()
+		pointsInput["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( points.bound() ),
+				"children" : {
+					"points" : {
+						"bound" : IECore.Box3fData( points.bound() ),
+						"object" : points,
+					},
+				},
+			}, )
+		)
+
+		instancer = GafferScene.Instancer()
+		instancer["in"].setInput( pointsInput["out"] )
+		instancer["instance"].setInput( instanceInput["out"] )
+		instancer["parent"].setValue( "/points" )
+
+		prototypeNames = instanceInput["out"].childNames( "/" )
+		self.assertEqual( len( prototypeNames ), 2 )
+
+		# Without a prototype index, the whole scene is instanced
+		# onto every point, translated but not rotated or scaled.
+
+		for i in range( 0, 4 ) :
+			instancePath = "/points/instances/%d" % i
+			self.assertEqual( instancer["out"].childNames( instancePath ), prototypeNames )
+			self.assertEqual( instancer["out"].transform( instancePath ), IECore.M44f.createTranslated( points["P"].data[i] ) )
+
+		# With a prototype index, each point gets a single prototype,
+		# with its root transform preserved.
+
+		instancer["prototypeIndex"].setValue( "index" )
+		instancer["orientation"].setValue( "orient" )
+		instancer["scale"].setValue( "scale" )
+
+		self.assertSceneValid( instancer["out"] )
+		self.assertEqual( instancer["out"].childNames( "/points/instances" ), IECore.InternedStringVectorData( [ "0", "1", "2", "3" ] ) )
+
+		for i, index in enumerate( points["index"].data ) :
+
+			prototype = prototypeNames[index % 2]
+			instancePath = "/points/instances/%d" % i
+			self.assertEqual( instancer["out"].object( instancePath ), instanceInput["out"].object( "/" + prototype ) )
+			self.assertEqual( instancer["out"].bound( instancePath ), instanceInput["out"].bound( "/" + prototype ) )
+			self.assertEqual( instancer["out"].childNames( instancePath ), IECore.InternedStringVectorData() )
+
+			expectedTransform = (
+				instanceInput["out"].transform( "/" + prototype ) *
+				IECore.M44f.createScaled( IECore.V3f( i + 1 ) ) *
+				points["orient"].data[i].toMatrix44() *
+				IECore.M44f.createTranslated( points["P"].data[i] )
+			)
+			self.assertTrue( instancer["out"].transform( instancePath ).equalWithAbsError( expectedTransform, 0.00001 ) )
+
+		# Prototype transforms, orientation and scale must all
+		# contribute to the bound.
+
+		expectedBound = IECore.Box3f()
+		for i in range( 0, 4 ) :
+			instancePath = "/points/instances/%d" % i
+			expectedBound.extendBy( instancer["out"].bound( instancePath ).transform( instancer["out"].transform( instancePath ) ) )
+
+		bound = instancer["out"].bound( "/points/instances" )
+		self.assertTrue( bound.min.equalWithAbsError( expectedBound.min, 0.0001 ) )
+		self.assertTrue( bound.max.equalWithAbsError( expectedBound.max, 0.0001 ) )
+
+	def testBadPrototypeIndex( self ) :
+
+		points = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( 0 ), IECore.V3f( 1 ) ] ) )
+		points["floatIndex"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ 0, 1 ] ) )
+
+		pointsInput = GafferSceneTest.CompoundObjectSource()
+		pointsInput["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( points.bound() ),
+				"children" : {
+					"points" : {
+						"bound" : IECore.Box3fData( points.bound() ),
+						"object" : points,
+					},
+				},
+			}, )
+		)
+
+		sphere = GafferScene.Sphere()
+		group = GafferScene.Group()
+		group["in"][0].setInput( sphere["out"] )
+
+		instancer = GafferScene.Instancer()
+		instancer["in"].setInput( pointsInput["out"] )
+		instancer["instance"].setInput( group["out"] )
+		instancer["parent"].setValue( "/points" )
+
+		for name in ( "missing", "floatIndex" ) :
+			instancer["prototypeIndex"].setValue( name )
+			self.assertRaises( RuntimeError, instancer["out"].childNames, "/points/instances" )
+			self.assertRaises( RuntimeError, instancer["out"].object, "/points/instances/0/sphere" )
+
+	def testPrototypeIndexAffects( self ) :
+
+		n = GafferScene.Instancer()
+		for plugName in ( "prototypeIndex", "orientation", "scale" ) :
+			a = [ x.relativeName( n ) for x in n.affects( n[plugName] ) ]
+			self.assertTrue( "out.transform" in a )
+			self.assertTrue( "out.bound" in a )
+
+		a = [ x.relativeName( n ) for x in n.affects( n["prototypeIndex"] ) ]
+		self.assertTrue( "out.childNames" in a )
+		self.assertTrue( "out.object" in a )
+
+	def testPrototypeIndexDirtyPropagation( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["sphere"] = GafferScene.Sphere()
+		script["cube"] = GafferScene.Cube()
+
+		script["group"] = GafferScene.Group()
+		script["group"]["in"][0].setInput( script["sphere"]["out"] )
+		script["group"]["in"][1].setInput( script["cube"]["out"] )
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["plane"]["out"] )
+		script["instancer"]["instance"].setInput( script["group"]["out"] )
+		script["instancer"]["parent"].setValue( "/plane" )
+		script["instancer"]["prototypeIndex"].setValue( "index" )
+
+		# Changing the points changes the prototype chosen for each
+		# instance, and therefore the attributes and object too.
+
+		dirtied = GafferTest.CapturingSlot( script["instancer"].plugDirtiedSignal() )
+		script["plane"]["divisions"].setValue( IECore.V2i( 2 ) )
+		dirtiedPlugs = [ x[0] for x in dirtied ]
+		for plugName in ( "childNames", "bound", "transform", "attributes", "object" ) :
+			self.assertTrue( script["instancer"]["out"][plugName] in dirtiedPlugs )
+
+		# As does changing the names of the prototypes.
+
+		dirtied = GafferTest.CapturingSlot( script["instancer"].plugDirtiedSignal() )
+		script["sphere"]["name"].setValue( "ball" )
+		dirtiedPlugs = [ x[0] for x in dirtied ]
+		for plugName in ( "childNames", "bound", "transform", "attributes", "object" ) :
+			self.assertTrue( script["instancer"]["out"][plugName] in dirtiedPlugs )
+
+		# And the points are held by the capsule when encapsulating,
+		# so any change to them must dirty the object.
+
+		script["instancer"]["prototypeIndex"].setValue( "" )
+		script["instancer"]["encapsulate"].setValue( True )
+
+		dirtied = GafferTest.CapturingSlot( script["instancer"].plugDirtiedSignal() )
+		script["plane"]["divisions"].setValue( IECore.V2i( 3 ) )
+		self.assertTrue( script["instancer"]["out"]["object"] in [ x[0] for x in dirtied ] )
+
+	def testIdDependenciesArePerPrototypeAndPerPlug( self ) :
+
+		points = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( x, 0, 0 ) for x in range( 0, 4 ) ] ) )
+		points["index"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( [ 0, 1, 0, 1 ] ) )
+
+		script = Gaffer.ScriptNode()
+
+		script["points"] = GafferSceneTest.CompoundObjectSource()
+		script["points"]["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( points.bound() ),
+				"children" : {
+					"points" : {
+						"bound" : IECore.Box3fData( points.bound() ),
+						"object" : points,
+					},
+				},
+			}, )
+		)
+
+		script["sphere"] = GafferScene.Sphere()
+		script["cube"] = GafferScene.Cube()
+
+		script["parent"] = GafferScene.Parent()
+		script["parent"]["in"].setInput( script["sphere"]["out"] )
+		script["parent"]["child"].setInput( script["cube"]["out"] )
+		script["parent"]["parent"].setValue( "/" )
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["points"]["out"] )
+		script["instancer"]["instance"].setInput( script["parent"]["out"] )
+		script["instancer"]["parent"].setValue( "/points" )
+		script["instancer"]["prototypeIndex"].setValue( "index" )
+
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( "parent['sphere']['radius'] = 1 + context.get( 'instancer:id', 0 )" )
+
+		self.assertEqual( script["instancer"]["out"].childNames( "/points/instances" ), IECore.InternedStringVectorData( [ "0", "1", "2", "3" ] ) )
+
+		# Only the sphere depends on "instancer:id", so the cubes
+		# are still shared.
+
+		out = script["instancer"]["out"]
+		self.assertNotEqual( out.objectHash( "/points/instances/0" ), out.objectHash( "/points/instances/2" ) )
+		self.assertNotEqual( out.boundHash( "/points/instances/0" ), out.boundHash( "/points/instances/2" ) )
+		self.assertEqual( out.objectHash( "/points/instances/1" ), out.objectHash( "/points/instances/3" ) )
+		self.assertEqual( out.boundHash( "/points/instances/1" ), out.boundHash( "/points/instances/3" ) )
+
+		# And only the sphere's bound and object depend on it, so
+		# its attributes are still shared.
+
+		self.assertEqual( out.attributesHash( "/points/instances/0" ), out.attributesHash( "/points/instances/2" ) )
+
+		self.assertEqual( out.bound( "/points/instances/0" ), IECore.Box3f( IECore.V3f( -1 ), IECore.V3f( 1 ) ) )
+		self.assertEqual( out.bound( "/points/instances/2" ), IECore.Box3f( IECore.V3f( -3 ), IECore.V3f( 3 ) ) )
+
+		self.assertSceneValid( out )
+
+		# Removing the dependency must be picked up.
+
+		del script["expression"]
+		self.assertEqual( out.objectHash( "/points/instances/0" ), out.objectHash( "/points/instances/2" ) )
+		self.assertEqual( out.bound( "/points/instances/2" ), IECore.Box3f( IECore.V3f( -1 ), IECore.V3f( 1 ) ) )
+
+	def testEncapsulate( self ) :
+
+		sphere = IECore.SpherePrimitive()
+		instanceInput = GafferSceneTest.CompoundObjectSource()
+		instanceInput["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( IECore.Box3f( IECore.V3f( -2 ), IECore.V3f( 2 ) ) ),
+				"children" : {
+					"sphere" : {
+						"object" : sphere,
+						"bound" : IECore.Box3fData( sphere.bound() ),
+						"transform" : IECore.M44fData( IECore.M44f.createScaled( IECore.V3f( 2 ) ) ),
+					},
+				}
+			} )
+		)
+
+		points = IECore.PointsPrimitive( IECore.V3fVectorData( [ IECore.V3f( x, 0, 0 ) for x in range( 0, 10 ) ] ) )
+		pointsInput = GafferSceneTest.CompoundObjectSource()
+		pointsInput["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( points.bound() ),
+				"children" : {
+					"points" : {
+						"bound" : IECore.Box3fData( points.bound() ),
+						"object" : points,
+					},
+				},
+			} )
+		)
+
+		instancer = GafferScene.Instancer()
+		instancer["in"].setInput( pointsInput["out"] )
+		instancer["instance"].setInput( instanceInput["out"] )
+		instancer["parent"].setValue( "/points" )
+
+		self.assertEqual( len( instancer["out"].childNames( "/points/instances" ) ), 10 )
+		bound = instancer["out"].bound( "/points/instances" )
+		objectHash = instancer["out"].objectHash( "/points/instances" )
+
+		instancer["encapsulate"].setValue( True )
+		self.assertSceneValid( instancer["out"] )
+
+		# The instances are no longer output as locations, and are
+		# represented instead by a capsule at the instances location.
+
+		self.assertEqual( instancer["out"].childNames( "/points/instances" ), IECore.InternedStringVectorData() )
+		self.assertEqual( instancer["out"].bound( "/points/instances" ), bound )
+		self.assertNotEqual( instancer["out"].objectHash( "/points/instances" ), objectHash )
+
+		capsule = instancer["out"].object( "/points/instances" )
+		self.assertTrue( isinstance( capsule, GafferScene.InstancerCapsule ) )
+		self.assertEqual( capsule.bound(), bound )
+		self.assertTrue( capsule.prototypesScene().isSame( instancer["instance"] ) )
+		self.assertEqual( capsule.numInstances(), 10 )
+		for i in range( 0, 10 ) :
+			self.assertEqual( capsule.prototypeRoot( i ), "/" )
+			self.assertEqual( capsule.instanceTransform( i ), IECore.M44f.createTranslated( points["P"].data[i] ) )
+			self.assertEqual( capsule.instanceContext( i )["instancer:id"], i )
+
+		self.assertRaises( IndexError, capsule.prototypeRoot, 10 )
+
+		# Using a prototype index makes each child of the instance
+		# root into a separate prototype.
+
+		points["index"] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.IntVectorData( [ 0 ] * 10 ) )
+		pointsInput["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( points.bound() ),
+				"children" : {
+					"points" : {
+						"bound" : IECore.Box3fData( points.bound() ),
+						"object" : points,
+					},
+				},
+			} )
+		)
+		instancer["prototypeIndex"].setValue( "index" )
+
+		capsule = instancer["out"].object( "/points/instances" )
+		for i in range( 0, 10 ) :
+			self.assertEqual( capsule.prototypeRoot( i ), "/sphere" )
+
+		# Changes to the prototypes must be reflected in the hash
+		# for the capsule, even though they don't affect the bound.
+
+		capsuleHash = instancer["out"].objectHash( "/points/instances" )
+		smallSphere = IECore.SpherePrimitive( 0.5 )
+		instanceInput["in"].setValue(
+			IECore.CompoundObject( {
+				"bound" : IECore.Box3fData( IECore.Box3f( IECore.V3f( -2 ), IECore.V3f( 2 ) ) ),
+				"children" : {
+					"sphere" : {
+						"object" : smallSphere,
+						"bound" : IECore.Box3fData( sphere.bound() ),
+						"transform" : IECore.M44fData( IECore.M44f.createScaled( IECore.V3f( 2 ) ) ),
+					},
+				}
+			} )
+		)
+		self.assertNotEqual( instancer["out"].objectHash( "/points/instances" ), capsuleHash )
+
+		# Turning encapsulation off again gives us the original locations.
+
+		instancer["encapsulate"].setValue( False )
+		self.assertEqual( len( instancer["out"].childNames( "/points/instances" ) ), 10 )
+
+	def testCapsuleIdentity( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["sphere"] = GafferScene.Sphere()
+
+		script["instancer1"] = GafferScene.Instancer()
+		script["instancer1"]["in"].setInput( script["plane"]["out"] )
+		script["instancer1"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer1"]["parent"].setValue( "/plane" )
+		script["instancer1"]["encapsulate"].setValue( True )
+
+		# The capsule hash is derived purely from the instances and
+		# the prototype hierarchies, so identical Instancers produce
+		# identical hashes, and capsules which expand identically.
+
+		script["instancer2"] = GafferScene.Instancer()
+		script["instancer2"]["in"].setInput( script["plane"]["out"] )
+		script["instancer2"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer2"]["parent"].setValue( "/plane" )
+		script["instancer2"]["encapsulate"].setValue( True )
+		instancer2 = script["instancer2"]
+
+		self.assertEqual(
+			script["instancer1"]["out"].objectHash( "/plane/instances" ),
+			instancer2["out"].objectHash( "/plane/instances" )
+		)
+
+		capsule1 = script["instancer1"]["out"].object( "/plane/instances" )
+		capsule2 = instancer2["out"].object( "/plane/instances" )
+		self.assertTrue( capsule1.prototypesScene().isSame( script["instancer1"]["instance"] ) )
+		self.assertEqual( capsule2.numInstances(), capsule1.numInstances() )
+		for i in range( 0, capsule1.numInstances() ) :
+			self.assertEqual( capsule2.prototypeRoot( i ), capsule1.prototypeRoot( i ) )
+			self.assertEqual( capsule2.instanceTransform( i ), capsule1.instanceTransform( i ) )
+			self.assertEqual( capsule2.instanceContext( i ), capsule1.instanceContext( i ) )
+
+		# But a change to the prototypes of one Instancer gives it
+		# a new hash.
+
+		script["sphere2"] = GafferScene.Sphere()
+		script["sphere2"]["radius"].setValue( 2 )
+		instancer2["instance"].setInput( script["sphere2"]["out"] )
+		self.assertNotEqual(
+			script["instancer1"]["out"].objectHash( "/plane/instances" ),
+			instancer2["out"].objectHash( "/plane/instances" )
+		)
+		capsule2 = instancer2["out"].object( "/plane/instances" )
+		self.assertTrue( capsule2.prototypesScene().isSame( instancer2["instance"] ) )
+
+		# The capsule accounts for the memory used by the instances
+		# and the context it holds, not just its own members.
+
+		self.assertGreater( capsule1.memoryUsage(), script["plane"]["out"].object( "/plane" ).memoryUsage() )
+
+		# The capsule keeps the prototypes scene alive.
+
+		del script, instancer2
+		self.assertTrue( isinstance( capsule1.prototypesScene(), GafferScene.ScenePlug ) )
+
+		# Default constructed capsules are empty.
+
+		capsule = GafferScene.InstancerCapsule()
+		self.assertEqual( capsule.numInstances(), 0 )
+		self.assertEqual( capsule.prototypesScene(), None )
+		self.assertRaises( IndexError, capsule.prototypeRoot, 0 )
+		self.assertRaises( IndexError, capsule.instanceTransform, 0 )
+		self.assertRaises( IndexError, capsule.instanceContext, 0 )
+
+	def testEncapsulatedRender( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["plane"]["divisions"].setValue( IECore.V2i( 2 ) )
+
+		script["sphere"] = GafferScene.Sphere()
+		script["sphere"]["type"].setValue( GafferScene.Sphere.Type.Primitive )
+		script["sphere"]["transform"]["scale"].setValue( IECore.V3f( 2 ) )
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["plane"]["out"] )
+		script["instancer"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer"]["parent"].setValue( "/plane" )
+
+		def render() :
+
+			renderer = GafferScene.Private.IECoreScenePreview.CapturingRenderer(
+				GafferScene.Private.IECoreScenePreview.Renderer.RenderType.Batch
+			)
+			GafferScene.Preview.RendererAlgo.outputObjects(
+				script["instancer"]["out"], script["instancer"]["out"]["globals"].getValue(), renderer
+			)
+			return renderer
+
+		# Expanding a capsule must produce exactly the same objects,
+		# with the same names and transforms, as the equivalent
+		# scene locations.
+
+		expanded = render()
+		script["instancer"]["encapsulate"].setValue( True )
+		encapsulated = render()
+
+		names = expanded.capturedObjectNames()
+		self.assertEqual( len( names ), 10 )
+		self.assertEqual( encapsulated.capturedObjectNames(), names )
+
+		for name in names :
+			e = expanded.capturedObject( name )
+			c = encapsulated.capturedObject( name )
+			self.assertEqual( c.capturedSamples(), e.capturedSamples() )
+			self.assertEqual( c.capturedTransforms(), e.capturedTransforms() )
+			self.assertEqual( c.capturedHash(), e.capturedHash() )
+
+		# And because the sphere doesn't depend on "instancer:id",
+		# every instance is output with the same hash, allowing the
+		# renderer to share a single copy.
+
+		sphereNames = [ n for n in names if n.startswith( "/plane/instances/" ) ]
+		self.assertEqual( len( sphereNames ), 9 )
+		self.assertEqual(
+			len( set( str( encapsulated.capturedObject( n ).capturedHash() ) for n in sphereNames ) ),
+			1
+		)
+
+		# Whereas prototypes which do depend on the id get a hash per instance.
+
+		script["expression"] = Gaffer.Expression()
+		script["expression"].setExpression( "parent['sphere']['radius'] = 1 + context.get( 'instancer:id', 0 )" )
+
+		encapsulated = render()
+		self.assertEqual( encapsulated.capturedObjectNames(), names )
+		self.assertEqual(
+			len( set( str( encapsulated.capturedObject( n ).capturedHash() ) for n in sphereNames ) ),
+			9
+		)
+		for i in range( 0, 9 ) :
+			sphere = encapsulated.capturedObject( "/plane/instances/%d/sphere" % i ).capturedSamples()[0]
+			self.assertEqual( sphere.radius(), 1 + i )
+
+	def testEncapsulatedInteractiveRender( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["plane"]["divisions"].setValue( IECore.V2i( 2 ) )
+
+		script["sphere"] = GafferScene.Sphere()
+		script["sphere"]["type"].setValue( GafferScene.Sphere.Type.Primitive )
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["plane"]["out"] )
+		script["instancer"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer"]["parent"].setValue( "/plane" )
+		script["instancer"]["encapsulate"].setValue( True )
+
+		script["render"] = GafferScene.Preview.InteractiveRender()
+		script["render"]["renderer"].setValue( "Capturing" )
+		script["render"]["in"].setInput( script["instancer"]["out"] )
+		script["render"]["state"].setValue( script["render"].State.Running )
+
+		renderer = script["render"].renderer()
+		self.assertTrue( isinstance( renderer, GafferScene.Private.IECoreScenePreview.CapturingRenderer ) )
+
+		points = script["plane"]["out"].object( "/plane" )
+
+		def assertInstances( planeTransform ) :
+
+			names = sorted( n for n in renderer.capturedObjectNames() if n.startswith( "/plane/instances/" ) )
+			self.assertEqual( names, sorted( "/plane/instances/%d/sphere" % i for i in range( 0, 9 ) ) )
+			for i in range( 0, 9 ) :
+				sphere = renderer.capturedObject( "/plane/instances/%d/sphere" % i )
+				self.assertTrue( isinstance( sphere.capturedSamples()[0], IECore.SpherePrimitive ) )
+				self.assertEqual(
+					sphere.capturedTransforms(),
+					[ IECore.M44f.createTranslated( points["P"].data[i] ) * planeTransform ]
+				)
+
+		# The capsule must be expanded into the individual instances,
+		# just as it is for batch renders.
+
+		assertInstances( IECore.M44f() )
+
+		# And the instances must be updated when the transform of
+		# the capsule's location changes.
+
+		script["plane"]["transform"]["translate"].setValue( IECore.V3f( 0, 1, 0 ) )
+		assertInstances( IECore.M44f.createTranslated( IECore.V3f( 0, 1, 0 ) ) )
+
+		# Or when the prototypes change.
+
+		script["sphere"]["radius"].setValue( 2 )
+		assertInstances( IECore.M44f.createTranslated( IECore.V3f( 0, 1, 0 ) ) )
+		self.assertEqual( renderer.capturedObject( "/plane/instances/0/sphere" ).capturedSamples()[0].radius(), 2 )
+
+		# Turning off encapsulation gives exactly the same objects.
+
+		script["instancer"]["encapsulate"].setValue( False )
+		assertInstances( IECore.M44f.createTranslated( IECore.V3f( 0, 1, 0 ) ) )
+
+		script["render"]["state"].setValue( script["render"].State.Stopped )
+
+	def testEncapsulatedLegacyRender( self ) :
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["plane"]["divisions"].setValue( IECore.V2i( 2 ) )
+
+		script["sphere"] = GafferScene.Sphere()
+		script["sphere"]["type"].setValue( GafferScene.Sphere.Type.Primitive )
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["plane"]["out"] )
+		script["instancer"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer"]["parent"].setValue( "/plane" )
+		script["instancer"]["encapsulate"].setValue( True )
+
+		capsule = script["instancer"]["out"].object( "/plane/instances" )
+		self.assertEqual( capsule.numInstances(), 9 )
+
+		renderer = IECore.CapturingRenderer()
+		with IECore.WorldBlock( renderer ) :
+			capsule.render( renderer )
+
+		def findSpheres( g, result ) :
+			if isinstance( g, IECore.SpherePrimitive ) :
+				result.append( g )
+			elif isinstance( g, IECore.Group ) :
+				for c in g.children() :
+					findSpheres( c, result )
+			return result
+
+		self.assertEqual( len( findSpheres( renderer.world(), [] ) ), 9 )
+
 if __name__ == "__main__":
 	unittest.main()
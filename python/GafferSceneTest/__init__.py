@@ -112,6 +112,7 @@ from SceneLoopTest import SceneLoopTest
 from SceneProcessorTest import SceneProcessorTest
 from MeshToPointsTest import MeshToPointsTest
 from InteractiveRenderTest import InteractiveRenderTest
+import IECoreScenePreviewTest
 
 if __name__ == "__main__":
 	import unittest
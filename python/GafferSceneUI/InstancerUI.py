@@ -60,12 +60,20 @@ Gaffer.Metadata.registerNode(
 	the object level when exporting to the renderer (this
 	occurs for all nodes, not just the Instancer).
 
-	Per-instance variation can be achieved using the
+	Multiple prototypes may be instanced by grouping them
+	under the root of the instance scene, and using a primitive
+	variable to choose between them - see the prototypeIndex
+	plug for details. Instances may also be oriented and scaled
+	using primitive variables.
+
+	Further per-instance variation can be achieved using the
 	${instancer:id} variable in the upstream instance graph.
 	A common use case is to use this to randomise the index
 	on a SceneSwitch node, to choose randomly between several
 	instances, but it can be used to drive _any_ property of
-	the upstream graph.
+	the upstream graph. Note that instances which depend on it must be
+	computed individually, whereas those that don't are computed
+	only once and shared.
 	""",
 
 	plugs = {
@@ -105,6 +113,59 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"prototypeIndex" : [
+
+			"description",
+			"""
+			The name of an int primitive variable used to choose
+			a prototype for each instance. When specified, each
+			child of the root of the instance scene is treated as
+			a separate prototype, and the primitive variable
+			provides an index into the list of children. Indices
+			outside the range of the list wrap around. When no
+			name is specified, the entire instance scene is
+			instanced onto every point.
+			""",
+
+		],
+
+		"orientation" : [
+
+			"description",
+			"""
+			The name of a quaternion primitive variable used to
+			orient the instances.
+			""",
+
+		],
+
+		"scale" : [
+
+			"description",
+			"""
+			The name of a primitive variable used to scale the
+			instances. This may be either a float primitive
+			variable for uniform scaling, or a V3f primitive
+			variable for non-uniform scaling.
+			""",
+
+		],
+
+		"encapsulate" : [
+
+			"description",
+			"""
+			Outputs all the instances as a single compact object
+			at the location specified by the name plug, rather than
+			as individual child locations. This makes scene generation
+			much cheaper for large numbers of instances, and renderers
+			expand the instances as they are output. The drawback
+			is that the individual instances can no longer be
+			modified or filtered downstream.
+			""",
+
+		],
+
 	}
 
 )
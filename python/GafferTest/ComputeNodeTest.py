@@ -480,6 +480,122 @@ class ComputeNodeTest( GafferTest.TestCase ) :
 		n["op1"].setValue( 1 )
 		self.assertEqual( n["sum"].getValue(), 1 )
 
+	def testConcurrentComputesAreNotDuplicated( self ) :
+
+		class SlowAddNode( GafferTest.AddNode ) :
+
+			def __init__( self, name="SlowAddNode" ) :
+
+				GafferTest.AddNode.__init__( self, name )
+
+			def compute( self, plug, context ) :
+
+				time.sleep( 0.1 )
+				GafferTest.AddNode.compute( self, plug, context )
+
+		IECore.registerRunTimeTyped( SlowAddNode )
+
+		n = SlowAddNode()
+		n["op1"].setValue( 1 )
+		n["op2"].setValue( 2 )
+
+		def f() :
+
+			self.assertEqual( n["sum"].getValue(), 3 )
+
+		with Gaffer.PerformanceMonitor() as m :
+
+			threads = []
+			for i in range( 0, 10 ) :
+				t = threading.Thread( target = f )
+				t.start()
+				threads.append( t )
+
+			for t in threads :
+				t.join()
+
+		self.assertEqual( m.plugStatistics( n["sum"] ).computeCount, 1 )
+
+	def testPassThroughChainWithTaskCollaboration( self ) :
+
+		# All the nodes in the chain share the same hash, so each
+		# upstream compute is for the same hash that the downstream
+		# compute is already responsible for. Both outputs use the
+		# default TaskCollaboration policy, so this would deadlock
+		# if the downstream compute waited on itself.
+
+		n1 = self.PassThrough()
+		n2 = self.PassThrough()
+		n3 = self.PassThrough()
+		n2["in"].setInput( n1["out"] )
+		n3["in"].setInput( n2["out"] )
+
+		n1["in"].setValue( IECore.IntVectorData( range( 0, 10 ) ) )
+		self.assertEqual( n3["out"].hash(), n1["in"].hash() )
+
+		def f() :
+
+			self.assertEqual( n3["out"].getValue(), IECore.IntVectorData( range( 0, 10 ) ) )
+
+		threads = []
+		for i in range( 0, 10 ) :
+			t = threading.Thread( target = f )
+			t.start()
+			threads.append( t )
+
+		for t in threads :
+			t.join()
+
+		f()
+
+	def testConcurrentComputeErrors( self ) :
+
+		class SlowBadNode( GafferTest.AddNode ) :
+
+			def __init__( self, name="SlowBadNode" ) :
+
+				GafferTest.AddNode.__init__( self, name )
+
+			def compute( self, plug, context ) :
+
+				time.sleep( 0.1 )
+				raise ValueError( "Bad" )
+
+		IECore.registerRunTimeTyped( SlowBadNode )
+
+		n = SlowBadNode()
+		cs = GafferTest.CapturingSlot( n.errorSignal() )
+
+		# Threads waiting on another thread's failed compute must
+		# see the original exception, and report the error just
+		# as the computing thread does.
+
+		errors = []
+		def f() :
+
+			try :
+				n["sum"].getValue()
+			except Exception as e :
+				errors.append( e )
+
+		threads = []
+		for i in range( 0, 4 ) :
+			t = threading.Thread( target = f )
+			t.start()
+			threads.append( t )
+
+		for t in threads :
+			t.join()
+
+		self.assertEqual( len( errors ), 4 )
+		for e in errors :
+			self.assertTrue( isinstance( e, RuntimeError ) )
+			self.assertTrue( "ValueError: Bad" in str( e ) )
+
+		self.assertEqual( len( cs ), 4 )
+		for s in cs :
+			self.assertTrue( s[0].isSame( n["sum"] ) )
+
 	def testThreading( self ) :
 
 		GafferTest.testComputeNodeThreading()
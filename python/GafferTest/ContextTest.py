@@ -536,6 +536,33 @@ class ContextTest( GafferTest.TestCase ) :
 		c["ui:test"] = 1
 		self.assertEqual( h, c.hash() )
 
+	def testScenePathContextHashing( self ) :
+
+		GafferTest.testScenePathContextHashing()
+
+	def testImageTileContextHashing( self ) :
+
+		GafferTest.testImageTileContextHashing()
+
+	def testIncrementalHashMatchesFullHash( self ) :
+
+		c1 = Gaffer.Context()
+		c1["a"] = 10
+		c1["b"] = IECore.StringVectorData( [ "one", "two" ] )
+		c1.hash()
+
+		c2 = Gaffer.Context( c1 )
+		c2["a"] = 20
+		self.assertNotEqual( c2.hash(), c1.hash() )
+
+		c3 = Gaffer.Context()
+		c3["b"] = IECore.StringVectorData( [ "one", "two" ] )
+		c3["a"] = 20
+		self.assertEqual( c3.hash(), c2.hash() )
+
+		c2["a"] = 10
+		self.assertEqual( c2.hash(), c1.hash() )
+
 	def testManySubstitutions( self ) :
 
 		GafferTest.testManySubstitutions()
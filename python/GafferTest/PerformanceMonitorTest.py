@@ -87,19 +87,23 @@ class PerformanceMonitorTest( GafferTest.TestCase ) :
 			( 1, 1 )
 		)
 
-		# Force a rehash by making a new context. We should
+		# Force a rehash by clearing the hash cache. We should
 		# still be using the cache for the value though.
+		Gaffer.ValuePlug.clearHashCache()
 		with m :
-			with Gaffer.Context() as c :
-				c["myVariable"] = 1 # Force a rehash
-				self.assertEqual( a["sum"].getValue(), -2003 )
-
+			self.assertEqual( a["sum"].getValue(), -2003 )
 
 		self.assertEqual(
 			( m.plugStatistics( a["sum"] ).hashCount, m.plugStatistics( a["sum"] ).computeCount ),
 			( 2, 1 )
 		)
 
+		# Check the cache hits recorded above.
+		self.assertEqual(
+			( m.plugStatistics( a["sum"] ).hashCacheHits, m.plugStatistics( a["sum"] ).computeCacheHits ),
+			( 1, 2 )
+		)
+
 		# Check the dictionary of all statistics.
 		self.assertEqual( len( m.allStatistics() ), 1 )
 		self.assertEqual(
@@ -113,23 +117,31 @@ class PerformanceMonitorTest( GafferTest.TestCase ) :
 			hashCount = 10,
 			computeCount = 20,
 			hashDuration = 100,
-			computeDuration = 200
+			computeDuration = 200,
+			hashCacheHits = 5,
+			computeCacheHits = 6
 		)
 
 		self.assertEqual( s.hashCount, 10 )
 		self.assertEqual( s.computeCount, 20 )
 		self.assertEqual( s.hashDuration, 100 )
 		self.assertEqual( s.computeDuration, 200 )
+		self.assertEqual( s.hashCacheHits, 5 )
+		self.assertEqual( s.computeCacheHits, 6 )
 
 		s.hashCount = 20
 		s.computeCount = 30
 		s.hashDuration = 200
 		s.computeDuration = 300
+		s.hashCacheHits = 7
+		s.computeCacheHits = 8
 
 		self.assertEqual( s.hashCount, 20 )
 		self.assertEqual( s.computeCount, 30 )
 		self.assertEqual( s.hashDuration, 200 )
 		self.assertEqual( s.computeDuration, 300 )
+		self.assertEqual( s.hashCacheHits, 7 )
+		self.assertEqual( s.computeCacheHits, 8 )
 
 	def testEnterReturnValue( self ) :
 
@@ -214,10 +226,9 @@ class PerformanceMonitorTest( GafferTest.TestCase ) :
 		self.assertAlmostEqual( seconds( m.plugStatistics( n2["out"] ).hashDuration ), 0.1, delta = 0.01 )
 		self.assertAlmostEqual( seconds( m.plugStatistics( n2["out"] ).computeDuration ), 0.2, delta = 0.01 )
 
+		Gaffer.ValuePlug.clearHashCache() # force rehash, but not recompute
 		with m :
-			with Gaffer.Context() as c :
-				c["test"] = 1 # force rehash, but not recompute
-				n2["out"].getValue()
+			n2["out"].getValue()
 
 		self.assertEqual( m.plugStatistics( n1["out"] ).hashCount, 2 )
 		self.assertEqual( m.plugStatistics( n1["out"] ).computeCount, 1 )
@@ -0,0 +1,105 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import sys
+import time
+import functools
+import threading
+import unittest
+
+## A unittest.TextTestRunner which additionally reports the timings
+# of test methods decorated with `TestRunner.PerformanceTestMethod()`.
+class TestRunner( unittest.TextTestRunner ) :
+
+	def __init__( self, stream = sys.stderr, descriptions = True, verbosity = 1 ) :
+
+		unittest.TextTestRunner.__init__( self, stream, descriptions, verbosity, resultclass = self.__Result )
+
+	## Decorator used to annotate test methods which measure performance.
+	# The method is run `repeat` times, and the fastest of the times spent
+	# within `PerformanceScope` blocks is reported by the TestRunner. Methods
+	# must still make assertions about their results, so that they test
+	# correctness as well as providing timings.
+	class PerformanceTestMethod( object ) :
+
+		def __init__( self, repeat = 3 ) :
+
+			self.__repeat = repeat
+
+		def __call__( self, method ) :
+
+			@functools.wraps( method )
+			def wrapper( testCase ) :
+
+				timings = []
+				for i in range( 0, self.__repeat ) :
+					TestRunner.PerformanceScope._timings.current = []
+					try :
+						method( testCase )
+					finally :
+						timings.append( sum( TestRunner.PerformanceScope._timings.current ) )
+						TestRunner.PerformanceScope._timings.current = None
+
+				testCase.performanceTiming = min( timings )
+
+			wrapper.performanceTestMethod = True
+			return wrapper
+
+	## Context manager used within a PerformanceTestMethod, to time
+	# only the code being measured rather than the setup of the test.
+	class PerformanceScope( object ) :
+
+		_timings = threading.local()
+
+		def __enter__( self ) :
+
+			self.__startTime = time.time()
+
+		def __exit__( self, type, value, traceBack ) :
+
+			timings = getattr( TestRunner.PerformanceScope._timings, "current", None )
+			if timings is not None :
+				timings.append( time.time() - self.__startTime )
+
+	class __Result( unittest.TextTestResult ) :
+
+		def addSuccess( self, test ) :
+
+			timing = getattr( test, "performanceTiming", None )
+			if timing is not None and self.showAll :
+				self.stream.write( "(%.3fs) " % timing )
+
+			unittest.TextTestResult.addSuccess( self, test )
@@ -0,0 +1,144 @@
+##########################################################################
+#
+#  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import os
+import json
+import unittest
+
+import IECore
+
+import Gaffer
+import GafferTest
+
+class TraceMonitorTest( GafferTest.TestCase ) :
+
+	def testWriteTrace( self ) :
+
+		a = GafferTest.AddNode()
+		a["op1"].setValue( 1 )
+		a["op2"].setValue( 2 )
+
+		# An earlier test may have left an identical AddNode result
+		# in the cache, in which case we'd see no compute event.
+		memoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( memoryLimit )
+		Gaffer.ValuePlug.clearHashCache()
+
+		with Gaffer.TraceMonitor() as m :
+			with Gaffer.Context() as c :
+				c.setFrame( 10 )
+				c["myString"] = "a\"b"
+				self.assertEqual( a["sum"].getValue(), 3 )
+
+		fileName = os.path.join( self.temporaryDirectory(), "trace.json" )
+		m.writeTrace( fileName )
+
+		with open( fileName ) as f :
+			trace = json.load( f )
+
+		events = [ e for e in trace["traceEvents"] if e["ph"] == "X" ]
+		self.assertEqual(
+			sorted( e["cat"] for e in events ),
+			[ "computeNode:compute", "computeNode:hash" ]
+		)
+
+		for e in events :
+			self.assertEqual( e["name"], a["sum"].fullName() )
+			self.assertGreaterEqual( e["dur"], 0 )
+			self.assertTrue( "frame : 10" in e["args"]["context"] )
+			self.assertTrue( "myString : a\"b" in e["args"]["context"] )
+
+	def testNestedEvents( self ) :
+
+		a1 = GafferTest.AddNode()
+		a2 = GafferTest.AddNode()
+		a2["op1"].setInput( a1["sum"] )
+
+		with Gaffer.TraceMonitor() as m :
+			a2["sum"].getValue()
+
+		fileName = os.path.join( self.temporaryDirectory(), "trace.json" )
+		m.writeTrace( fileName )
+
+		with open( fileName ) as f :
+			trace = json.load( f )
+
+		events = [ e for e in trace["traceEvents"] if e["ph"] == "X" ]
+		hashes = dict( ( e["name"], e ) for e in events if e["cat"] == "computeNode:hash" )
+		self.assertEqual( set( hashes.keys() ), set( [ a1["sum"].fullName(), a2["sum"].fullName() ] ) )
+
+		# The upstream hash is performed during the downstream one.
+		outer = hashes[a2["sum"].fullName()]
+		inner = hashes[a1["sum"].fullName()]
+		self.assertGreaterEqual( inner["ts"], outer["ts"] )
+		self.assertLessEqual( inner["ts"] + inner["dur"], outer["ts"] + outer["dur"] )
+
+	def testHashDependenciesUnaffected( self ) :
+
+		# Returns the number of hashes performed as we change
+		# first a variable the hash doesn't depend on, and
+		# then one it does.
+		def hashCounts() :
+
+			frame = GafferTest.FrameNode()
+			add = GafferTest.AddNode()
+			add["op1"].setInput( frame["output"] )
+
+			result = []
+			with Gaffer.Context() as c :
+
+				c["foo"] = "a"
+				self.assertEqual( add["sum"].getValue(), 1 )
+				numHashCalls = add.numHashCalls
+
+				c["foo"] = "b"
+				self.assertEqual( add["sum"].getValue(), 1 )
+				result.append( add.numHashCalls - numHashCalls )
+
+				c.setFrame( 2 )
+				self.assertEqual( add["sum"].getValue(), 2 )
+				result.append( add.numHashCalls - numHashCalls )
+
+			return result
+
+		self.assertEqual( hashCounts(), [ 0, 1 ] )
+		with Gaffer.TraceMonitor() :
+			self.assertEqual( hashCounts(), [ 0, 1 ] )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -36,6 +36,7 @@
 ##########################################################################
 
 import gc
+import threading
 
 import IECore
 
@@ -79,6 +80,174 @@ class ValuePlugTest( GafferTest.TestCase ) :
 		# the objects should be one and the same, as we reenabled the cache.
 		self.failUnless( v1.isSame( v2 ) )
 
+	def testHashCacheSizeLimit( self ) :
+
+		n = GafferTest.CachingTestNode()
+		n["in"].setValue( "a" )
+
+		h = n["out"].hash()
+		self.assertEqual( n.numHashCalls, 1 )
+
+		# second call should come from the cache
+		self.assertEqual( n["out"].hash(), h )
+		self.assertEqual( n.numHashCalls, 1 )
+
+		Gaffer.ValuePlug.setHashCacheSizeLimit( 0 )
+		self.assertEqual( Gaffer.ValuePlug.getHashCacheSizeLimit(), 0 )
+		self.assertEqual( Gaffer.ValuePlug.hashCacheTotalUsage(), 0 )
+
+		# with no cache, every call should be computed
+		self.assertEqual( n["out"].hash(), h )
+		self.assertEqual( n.numHashCalls, 2 )
+		self.assertEqual( n["out"].hash(), h )
+		self.assertEqual( n.numHashCalls, 3 )
+
+		Gaffer.ValuePlug.setHashCacheSizeLimit( self.__originalHashCacheSizeLimit )
+
+		self.assertEqual( n["out"].hash(), h )
+		self.assertEqual( n.numHashCalls, 4 )
+		self.assertEqual( n["out"].hash(), h )
+		self.assertEqual( n.numHashCalls, 4 )
+
+	def testHashCacheEvictions( self ) :
+
+		Gaffer.ValuePlug.setHashCacheSizeLimit( 1 )
+		evictions = Gaffer.ValuePlug.hashCacheEvictions()
+
+		n1 = GafferTest.CachingTestNode()
+		n2 = GafferTest.CachingTestNode()
+		n1["out"].hash()
+		n2["out"].hash()
+
+		self.assertEqual( Gaffer.ValuePlug.hashCacheTotalUsage(), 1 )
+		self.assertEqual( Gaffer.ValuePlug.hashCacheEvictions(), evictions + 1 )
+
+	def testHashCacheInvalidatedByDirtiness( self ) :
+
+		n = GafferTest.CachingTestNode()
+		n["in"].setValue( "a" )
+
+		h1 = n["out"].hash()
+		self.assertEqual( n.numHashCalls, 1 )
+
+		n["in"].setValue( "b" )
+		h2 = n["out"].hash()
+		self.assertNotEqual( h2, h1 )
+		self.assertEqual( n.numHashCalls, 2 )
+
+		n["in"].setValue( "a" )
+		self.assertEqual( n["out"].hash(), h1 )
+		self.assertEqual( n.numHashCalls, 3 )
+
+	def testHashCacheSharedBetweenThreads( self ) :
+
+		n = GafferTest.CachingTestNode()
+		n["in"].setValue( "a" )
+
+		h = n["out"].hash()
+		self.assertEqual( n.numHashCalls, 1 )
+
+		def f() :
+
+			self.assertEqual( n["out"].hash(), h )
+
+		t = threading.Thread( target = f )
+		t.start()
+		t.join()
+
+		self.assertEqual( n.numHashCalls, 1 )
+
+	def testHashCacheIgnoresUnusedContextVariables( self ) :
+
+		n = GafferTest.CachingTestNode()
+		n["in"].setValue( "a" )
+
+		h = n["out"].hash()
+		self.assertEqual( n.numHashCalls, 1 )
+
+		# The hash doesn't read any context variables, so
+		# it can be reused in any context.
+
+		with Gaffer.Context() as c :
+
+			c.setFrame( 10 )
+			self.assertEqual( n["out"].hash(), h )
+
+			c["foo"] = "bar"
+			self.assertEqual( n["out"].hash(), h )
+
+		self.assertEqual( n.numHashCalls, 1 )
+
+	def testHashCacheRespectsUsedContextVariables( self ) :
+
+		frame = GafferTest.FrameNode()
+
+		add = GafferTest.AddNode()
+		add["op1"].setInput( frame["output"] )
+
+		c = Gaffer.Context()
+
+		# Hash the upstream node first, so that the downstream
+		# node finds it in the cache and must pick up the dependency
+		# on the frame from there.
+		with c :
+			frame["output"].hash()
+			self.assertEqual( add["sum"].getValue(), 1 )
+
+		numHashCalls = add.numHashCalls
+
+		with c :
+			c["foo"] = "bar"
+			self.assertEqual( add["sum"].getValue(), 1 )
+			self.assertEqual( add.numHashCalls, numHashCalls )
+
+			c.setFrame( 2 )
+			self.assertEqual( add["sum"].getValue(), 2 )
+			self.assertEqual( add.numHashCalls, numHashCalls + 1 )
+
+			c.setFrame( 1 )
+			self.assertEqual( add["sum"].getValue(), 1 )
+			self.assertEqual( add.numHashCalls, numHashCalls + 1 )
+
+	def testHashCacheSizeLimit( self ) :
+
+		frame = GafferTest.FrameNode()
+
+		add = GafferTest.AddNode()
+		add["op1"].setInput( frame["output"] )
+
+		# With a limit of zero, nothing should be stored,
+		# so every call must rehash.
+
+		Gaffer.ValuePlug.clearHashCache()
+		Gaffer.ValuePlug.setHashCacheSizeLimit( 0 )
+
+		numHashCalls = add.numHashCalls
+		h = add["sum"].hash()
+		self.assertEqual( add["sum"].hash(), h )
+		self.assertEqual( add.numHashCalls, numHashCalls + 2 )
+		self.assertEqual( Gaffer.ValuePlug.hashCacheTotalUsage(), 0 )
+
+		# With a small limit, hashing in many contexts
+		# must not grow the cache beyond it.
+
+		Gaffer.ValuePlug.setHashCacheSizeLimit( 4 )
+
+		with Gaffer.Context() as c :
+			for i in range( 0, 100 ) :
+				c.setFrame( i )
+				add["sum"].hash()
+				self.assertLessEqual( Gaffer.ValuePlug.hashCacheTotalUsage(), 4 )
+
+		# And entries which are stored must still be reused.
+
+		numHashCalls = add.numHashCalls
+		with Gaffer.Context() as c :
+			c.setFrame( 99 )
+			add["sum"].hash()
+
+		self.assertEqual( add.numHashCalls, numHashCalls )
+
 	def testSettable( self ) :
 
 		p1 = Gaffer.IntPlug( direction = Gaffer.Plug.Direction.In )
@@ -622,12 +791,14 @@ class ValuePlugTest( GafferTest.TestCase ) :
 		GafferTest.TestCase.setUp( self )
 
 		self.__originalCacheMemoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		self.__originalHashCacheSizeLimit = Gaffer.ValuePlug.getHashCacheSizeLimit()
 
 	def tearDown( self ) :
 
 		GafferTest.TestCase.tearDown( self )
 
 		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+		Gaffer.ValuePlug.setHashCacheSizeLimit( self.__originalHashCacheSizeLimit )
 
 if __name__ == "__main__":
 	unittest.main()
@@ -53,6 +53,7 @@ except AttributeError :
 		return wrapper
 
 from TestCase import TestCase
+from TestRunner import TestRunner
 from AddNode import AddNode
 from SphereNode import SphereNode
 from SignalsTest import SignalsTest
@@ -129,6 +130,7 @@ from AnimationTest import AnimationTest
 from StatsApplicationTest import StatsApplicationTest
 from DownstreamIteratorTest import DownstreamIteratorTest
 from PerformanceMonitorTest import PerformanceMonitorTest
+from TraceMonitorTest import TraceMonitorTest
 
 if __name__ == "__main__":
 	import unittest
@@ -76,3 +76,8 @@ void ComputeNode::hash( const ValuePlug *output, const Context *context, IECore:
 void ComputeNode::compute( ValuePlug *output, const Context *context ) const
 {
 }
+
+ValuePlug::CachePolicy ComputeNode::computeCachePolicy( const ValuePlug *output ) const
+{
+	return ValuePlug::TaskCollaboration;
+}
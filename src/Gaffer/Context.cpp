@@ -44,6 +44,7 @@ static char **environ = *_NSGetEnviron();
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <stack>
 
 #include "tbb/enumerable_thread_specific.h"
@@ -125,8 +126,8 @@ Context::Context()
 	set( g_framesPerSecond, 24.0f );
 }
 
-Context::Context( const Context &other, Ownership ownership )
-	:	m_map( other.m_map ), m_changedSignal( NULL ), m_hash( other.m_hash ), m_hashValid( other.m_hashValid )
+Context::Context( const Context &other, Ownership ownership, bool tracked )
+	:	m_map( other.m_map ), m_changedSignal( NULL ), m_dependencyTracker( tracked ? other.m_dependencyTracker : NULL ), m_hash( other.m_hash ), m_hashValid( other.m_hashValid )
 {
 	// We used the (shallow) Map copy constructor in our initialiser above
 	// because it offers a big performance win over iterating and inserting copies
@@ -167,6 +168,27 @@ Context::~Context()
 	delete m_changedSignal;
 }
 
+void Context::borrow( const Context &other )
+{
+	for( Map::const_iterator it = m_map.begin(), eIt = m_map.end(); it != eIt; ++it )
+	{
+		if( it->second.ownership != Borrowed )
+		{
+			it->second.data->removeRef();
+		}
+	}
+
+	m_map = other.m_map;
+	for( Map::iterator it = m_map.begin(), eIt = m_map.end(); it != eIt; ++it )
+	{
+		it->second.ownership = Borrowed;
+	}
+
+	m_dependencyTracker = other.m_dependencyTracker;
+	m_hash = other.m_hash;
+	m_hashValid = other.m_hashValid;
+}
+
 void Context::remove( const IECore::InternedString &name )
 {
 	Map::iterator it = m_map.find( name );
@@ -179,6 +201,11 @@ void Context::remove( const IECore::InternedString &name )
 
 void Context::changed( const IECore::InternedString &name )
 {
+	Map::iterator it = m_map.find( name );
+	if( it != m_map.end() )
+	{
+		it->second.hash = IECore::MurmurHash();
+	}
 	m_hashValid = false;
 	if( m_changedSignal )
 	{
@@ -188,6 +215,10 @@ void Context::changed( const IECore::InternedString &name )
 
 void Context::names( std::vector<IECore::InternedString> &names ) const
 {
+	if( m_dependencyTracker )
+	{
+		m_dependencyTracker->readAll();
+	}
 	for( Map::const_iterator it = m_map.begin(), eIt = m_map.end(); it != eIt; it++ )
 	{
 		names.push_back( it->first );
@@ -240,6 +271,15 @@ Context::ChangedSignal &Context::changedSignal()
 }
 
 IECore::MurmurHash Context::hash() const
+{
+	if( m_dependencyTracker )
+	{
+		m_dependencyTracker->readAll();
+	}
+	return hashInternal();
+}
+
+IECore::MurmurHash Context::hashInternal() const
 {
 	if( m_hashValid )
 	{
@@ -259,15 +299,51 @@ IECore::MurmurHash Context::hash() const
 		{
 			continue;
 		}
+		if( it->second.hash == IECore::MurmurHash() )
+		{
+			it->second.data->hash( it->second.hash );
+		}
 		m_hash.append( (uint64_t)&name );
-		it->second.data->hash( m_hash );
+		m_hash.append( it->second.hash );
 	}
 	m_hashValid = true;
 	return m_hash;
 }
 
+IECore::MurmurHash Context::variablesHash( const DependencyTracker::Names &names ) const
+{
+	IECore::MurmurHash result;
+	for( DependencyTracker::Names::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+	{
+		result.append( (uint64_t)&(it->string()) );
+		Map::const_iterator mIt = m_map.find( *it );
+		if( mIt == m_map.end() )
+		{
+			// Absence of a variable is significant too, since computations
+			// may fall back to a default value.
+			result.append( 0 );
+			continue;
+		}
+		if( mIt->second.hash == IECore::MurmurHash() )
+		{
+			mIt->second.data->hash( mIt->second.hash );
+		}
+		result.append( 1 );
+		result.append( mIt->second.hash );
+	}
+	return result;
+}
+
 bool Context::operator == ( const Context &other ) const
 {
+	if( m_dependencyTracker )
+	{
+		m_dependencyTracker->readAll();
+	}
+	if( other.m_dependencyTracker )
+	{
+		other.m_dependencyTracker->readAll();
+	}
 	if( m_map.size() != other.m_map.size() )
 	{
 		return false;
@@ -496,6 +572,125 @@ void Context::substituteInternal( const char *s, std::string &result, const int
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+// DependencyTracker implementation
+//////////////////////////////////////////////////////////////////////////
+
+Context::DependencyTracker::DependencyTracker( DependencyTracker *parent )
+	:	m_parent( parent ), m_all( false )
+{
+}
+
+void Context::DependencyTracker::reset( DependencyTracker *parent )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	m_parent = parent;
+	m_names.clear();
+	m_all = false;
+}
+
+void Context::DependencyTracker::read( const IECore::InternedString &name )
+{
+	Mutex::scoped_lock lock( m_mutex, /* write = */ false );
+	if( m_all || m_names.find( name ) != m_names.end() )
+	{
+		return;
+	}
+
+	lock.upgrade_to_writer();
+	if( !m_all )
+	{
+		m_names.insert( name );
+	}
+}
+
+void Context::DependencyTracker::read( const Names &names )
+{
+	Mutex::scoped_lock lock( m_mutex, /* write = */ false );
+	if( m_all || std::includes( m_names.begin(), m_names.end(), names.begin(), names.end() ) )
+	{
+		return;
+	}
+
+	lock.upgrade_to_writer();
+	if( !m_all )
+	{
+		m_names.insert( names.begin(), names.end() );
+	}
+}
+
+void Context::DependencyTracker::readAll()
+{
+	Mutex::scoped_lock lock( m_mutex, /* write = */ false );
+	if( m_all )
+	{
+		return;
+	}
+
+	lock.upgrade_to_writer();
+	m_all = true;
+	m_names.clear();
+}
+
+bool Context::DependencyTracker::names( Names &names ) const
+{
+	Mutex::scoped_lock lock( m_mutex, /* write = */ false );
+	names = m_names;
+	return !m_all;
+}
+
+bool Context::DependencyTracker::readOnly( const Names &names ) const
+{
+	Mutex::scoped_lock lock( m_mutex, /* write = */ false );
+	return !m_all && std::includes( names.begin(), names.end(), m_names.begin(), m_names.end() );
+}
+
+void Context::DependencyTracker::mergeIntoParent() const
+{
+	if( !m_parent )
+	{
+		return;
+	}
+
+	Mutex::scoped_lock lock( m_mutex, /* write = */ false );
+	if( m_all )
+	{
+		m_parent->readAll();
+	}
+	else if( m_names.size() )
+	{
+		m_parent->read( m_names );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ReadRecorder implementation
+//////////////////////////////////////////////////////////////////////////
+
+Context::ReadRecorder::ReadRecorder( Context *context )
+	:	m_context( context ), m_previousTracker( context->m_dependencyTracker )
+{
+	m_context->m_dependencyTracker = new DependencyTracker( m_previousTracker.get() );
+}
+
+Context::ReadRecorder::~ReadRecorder()
+{
+	// Anything we recorded is also a dependency of
+	// whatever computation is currently being tracked.
+	m_context->m_dependencyTracker->mergeIntoParent();
+	m_context->m_dependencyTracker = m_previousTracker;
+}
+
+bool Context::ReadRecorder::read( const IECore::InternedString &name ) const
+{
+	DependencyTracker::Names names;
+	if( !m_context->m_dependencyTracker->names( names ) )
+	{
+		return true;
+	}
+	return names.find( name ) != names.end();
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Scope and current context implementation
 //////////////////////////////////////////////////////////////////////////
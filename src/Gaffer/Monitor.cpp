@@ -65,6 +65,10 @@ bool Monitor::getActive() const
 	return Process::monitorRegistered( this );
 }
 
+void Monitor::cacheHit( const IECore::InternedString &processType, const Plug *plug )
+{
+}
+
 Monitor::Scope::Scope( Monitor *monitor )
 	:	m_monitor( monitor )
 {
@@ -203,6 +203,40 @@ struct HashesPerComputeMetric
 
 };
 
+struct HashCacheHitsMetric
+{
+
+	typedef size_t ResultType;
+
+	ResultType operator() ( const PerformanceMonitor::Statistics &s ) const
+	{
+		return s.hashCacheHits;
+	}
+
+	const char *description() const
+	{
+		return "number of hashes retrieved from the cache";
+	}
+
+};
+
+struct ComputeCacheHitsMetric
+{
+
+	typedef size_t ResultType;
+
+	ResultType operator() ( const PerformanceMonitor::Statistics &s ) const
+	{
+		return s.computeCacheHits;
+	}
+
+	const char *description() const
+	{
+		return "number of values retrieved from the cache";
+	}
+
+};
+
 // Utility for invoking a templated functor with a particular metric.
 template<typename F>
 typename F::ResultType dispatchMetric( const F &f, PerformanceMetric performanceMetric )
@@ -225,6 +259,10 @@ typename F::ResultType dispatchMetric( const F &f, PerformanceMetric performance
 			return f( PerComputeDurationMetric() );
 		case HashesPerCompute :
 			return f( HashesPerComputeMetric() );
+		case HashCacheHits :
+			return f( HashCacheHitsMetric() );
+		case ComputeCacheHits :
+			return f( ComputeCacheHitsMetric() );
 		default :
 			return f( InvalidMetric() );
 	}
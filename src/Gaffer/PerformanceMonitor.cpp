@@ -50,8 +50,8 @@ static PerformanceMonitor::Statistics g_emptyStatistics;
 // PerformanceMonitor::Statistics
 //////////////////////////////////////////////////////////////////////////
 
-PerformanceMonitor::Statistics::Statistics( size_t hashCount, size_t computeCount, boost::chrono::nanoseconds hashDuration, boost::chrono::nanoseconds computeDuration )
-	:	hashCount( hashCount ), computeCount( computeCount ), hashDuration( hashDuration ), computeDuration( computeDuration )
+PerformanceMonitor::Statistics::Statistics( size_t hashCount, size_t computeCount, boost::chrono::nanoseconds hashDuration, boost::chrono::nanoseconds computeDuration, size_t hashCacheHits, size_t computeCacheHits )
+	:	hashCount( hashCount ), computeCount( computeCount ), hashDuration( hashDuration ), computeDuration( computeDuration ), hashCacheHits( hashCacheHits ), computeCacheHits( computeCacheHits )
 {
 }
 
@@ -61,6 +61,8 @@ PerformanceMonitor::Statistics & PerformanceMonitor::Statistics::operator += ( c
 	computeCount += rhs.computeCount;
 	hashDuration += rhs.hashDuration;
 	computeDuration += rhs.computeDuration;
+	hashCacheHits += rhs.hashCacheHits;
+	computeCacheHits += rhs.computeCacheHits;
 	return *this;
 }
 
@@ -70,7 +72,9 @@ bool PerformanceMonitor::Statistics::operator == ( const Statistics &rhs )
 		hashCount == rhs.hashCount &&
 		computeCount == rhs.computeCount &&
 		hashDuration == rhs.hashDuration &&
-		computeDuration == rhs.computeDuration
+		computeDuration == rhs.computeDuration &&
+		hashCacheHits == rhs.hashCacheHits &&
+		computeCacheHits == rhs.computeCacheHits
 	;
 }
 
@@ -153,6 +157,24 @@ void PerformanceMonitor::processFinished( const Process *process )
 	threadData.then = now;
 }
 
+void PerformanceMonitor::cacheHit( const IECore::InternedString &processType, const Plug *plug )
+{
+	if( processType != g_hashType && processType != g_computeType )
+	{
+		return;
+	}
+
+	Statistics &s = m_threadData.local().statistics[plug];
+	if( processType == g_hashType )
+	{
+		s.hashCacheHits++;
+	}
+	else
+	{
+		s.computeCacheHits++;
+	}
+}
+
 void PerformanceMonitor::collate() const
 {
 	tbb::enumerable_thread_specific<ThreadData, tbb::cache_aligned_allocator<ThreadData>, tbb::ets_key_per_instance>::iterator it, eIt;
@@ -92,6 +92,14 @@ Process::~Process()
 	}
 }
 
+void Process::cacheHit( const IECore::InternedString &type, const Plug *plug )
+{
+	for( Monitors::const_iterator it = g_activeMonitors.begin(), eIt = g_activeMonitors.end(); it != eIt; ++it )
+	{
+		(*it)->cacheHit( type, plug );
+	}
+}
+
 const Process *Process::current()
 {
 	const ThreadData::Stack &stack = g_threadData.local().stack;
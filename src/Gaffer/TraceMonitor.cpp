@@ -0,0 +1,283 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include <fstream>
+#include <iomanip>
+
+#include "boost/lexical_cast.hpp"
+
+#include "IECore/SimpleTypedData.h"
+#include "IECore/VectorTypedData.h"
+
+#include "Gaffer/TraceMonitor.h"
+#include "Gaffer/Process.h"
+#include "Gaffer/Plug.h"
+#include "Gaffer/Context.h"
+
+using namespace Gaffer;
+
+//////////////////////////////////////////////////////////////////////////
+// Utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Limits the length of the summary of any individual
+// context variable, so that large values don't bloat
+// the trace.
+const size_t g_maxValueLength = 64;
+
+template<typename T>
+std::string formatVec( const T &v )
+{
+	std::string result;
+	for( unsigned i = 0; i < T::dimensions(); ++i )
+	{
+		result += i ? " " : "";
+		result += boost::lexical_cast<std::string>( v[i] );
+	}
+	return result;
+}
+
+std::string formatData( const IECore::Data *data )
+{
+	switch( data->typeId() )
+	{
+		case IECore::StringDataTypeId :
+			return static_cast<const IECore::StringData *>( data )->readable();
+		case IECore::FloatDataTypeId :
+			return boost::lexical_cast<std::string>( static_cast<const IECore::FloatData *>( data )->readable() );
+		case IECore::IntDataTypeId :
+			return boost::lexical_cast<std::string>( static_cast<const IECore::IntData *>( data )->readable() );
+		case IECore::BoolDataTypeId :
+			return static_cast<const IECore::BoolData *>( data )->readable() ? "true" : "false";
+		case IECore::V2iDataTypeId :
+			return formatVec( static_cast<const IECore::V2iData *>( data )->readable() );
+		case IECore::V2fDataTypeId :
+			return formatVec( static_cast<const IECore::V2fData *>( data )->readable() );
+		case IECore::V3fDataTypeId :
+			return formatVec( static_cast<const IECore::V3fData *>( data )->readable() );
+		case IECore::InternedStringVectorDataTypeId :
+		{
+			// Most commonly a scene path, so we format it as such.
+			const std::vector<IECore::InternedString> &v = static_cast<const IECore::InternedStringVectorData *>( data )->readable();
+			std::string result;
+			for( std::vector<IECore::InternedString>::const_iterator it = v.begin(), eIt = v.end(); it != eIt; ++it )
+			{
+				result += "/" + it->string();
+			}
+			return result.size() ? result : "/";
+		}
+		default :
+			return data->typeName();
+	}
+}
+
+void writeEscaped( std::ostream &stream, const std::string &s )
+{
+	for( std::string::const_iterator it = s.begin(), eIt = s.end(); it != eIt; ++it )
+	{
+		switch( *it )
+		{
+			case '"' :
+				stream << "\\\"";
+				break;
+			case '\\' :
+				stream << "\\\\";
+				break;
+			case '\n' :
+				stream << "\\n";
+				break;
+			case '\t' :
+				stream << "\\t";
+				break;
+			default :
+				if( (unsigned char)*it < 0x20 )
+				{
+					stream << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << (int)*it << std::dec;
+				}
+				else
+				{
+					stream << *it;
+				}
+		}
+	}
+}
+
+double microseconds( boost::chrono::nanoseconds ns )
+{
+	return ns.count() / 1000.0;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// TraceMonitor
+//////////////////////////////////////////////////////////////////////////
+
+TraceMonitor::TraceMonitor()
+	:	m_startTime( boost::chrono::high_resolution_clock::now() )
+{
+}
+
+TraceMonitor::~TraceMonitor()
+{
+}
+
+std::vector<TraceMonitor::Events> TraceMonitor::allEvents() const
+{
+	std::vector<Events> result;
+	tbb::enumerable_thread_specific<ThreadData, tbb::cache_aligned_allocator<ThreadData>, tbb::ets_key_per_instance>::const_iterator it, eIt;
+	for( it = m_threadData.begin(), eIt = m_threadData.end(); it != eIt; ++it )
+	{
+		if( it->events.size() )
+		{
+			result.push_back( it->events );
+		}
+	}
+	return result;
+}
+
+void TraceMonitor::writeTrace( std::ostream &stream ) const
+{
+	stream << std::fixed << std::setprecision( 3 );
+	stream << "{\"traceEvents\":[\n";
+
+	bool first = true;
+	int threadIndex = 0;
+	tbb::enumerable_thread_specific<ThreadData, tbb::cache_aligned_allocator<ThreadData>, tbb::ets_key_per_instance>::const_iterator it, eIt;
+	for( it = m_threadData.begin(), eIt = m_threadData.end(); it != eIt; ++it )
+	{
+		const Events &events = it->events;
+		if( events.empty() )
+		{
+			continue;
+		}
+
+		stream << ( first ? "" : ",\n" );
+		stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadIndex << ",\"args\":{\"name\":\"Thread " << threadIndex << "\"}}";
+		first = false;
+
+		for( Events::const_iterator eventIt = events.begin(), eventEIt = events.end(); eventIt != eventEIt; ++eventIt )
+		{
+			stream << ",\n{\"name\":\"";
+			writeEscaped( stream, eventIt->plug->fullName() );
+			stream << "\",\"cat\":\"";
+			writeEscaped( stream, eventIt->type.string() );
+			stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadIndex;
+			stream << ",\"ts\":" << microseconds( eventIt->startTime );
+			stream << ",\"dur\":" << microseconds( eventIt->endTime - eventIt->startTime );
+			stream << ",\"args\":{\"context\":\"";
+			writeEscaped( stream, eventIt->context );
+			stream << "\"}}";
+		}
+
+		threadIndex++;
+	}
+
+	stream << "\n]}\n";
+}
+
+void TraceMonitor::writeTrace( const std::string &fileName ) const
+{
+	std::ofstream stream( fileName.c_str() );
+	if( !stream.good() )
+	{
+		throw IECore::Exception( "Unable to open file \"" + fileName + "\" for writing" );
+	}
+	writeTrace( stream );
+}
+
+std::string TraceMonitor::contextSummary( const Context *context )
+{
+	// We mustn't let the monitor change the result of the computation
+	// being monitored. Reading directly from `context` would record
+	// dependencies on every variable in it, changing the way hashes are
+	// cached, so we read from an untracked copy instead.
+	const ContextPtr untrackedContext = new Context( *context, Context::Borrowed, /* tracked = */ false );
+
+	std::vector<IECore::InternedString> names;
+	untrackedContext->names( names );
+
+	std::string result;
+	for( std::vector<IECore::InternedString>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+	{
+		const std::string &name = it->string();
+		if( name.compare( 0, 3, "ui:" ) == 0 )
+		{
+			continue;
+		}
+		std::string value = formatData( untrackedContext->get<IECore::Data>( *it ) );
+		if( value.size() > g_maxValueLength )
+		{
+			value = value.substr( 0, g_maxValueLength - 3 ) + "...";
+		}
+		result += result.size() ? ", " : "";
+		result += name + " : " + value;
+	}
+	return result;
+}
+
+void TraceMonitor::processStarted( const Process *process )
+{
+	ThreadData &threadData = m_threadData.local();
+	threadData.running.push( threadData.events.size() );
+	threadData.events.push_back( Event() );
+
+	Event &event = threadData.events.back();
+	event.type = process->type();
+	event.plug = process->plug();
+	event.context = contextSummary( Context::current() );
+	event.startTime = boost::chrono::high_resolution_clock::now() - m_startTime;
+	event.endTime = event.startTime;
+}
+
+void TraceMonitor::processFinished( const Process *process )
+{
+	const boost::chrono::high_resolution_clock::time_point now = boost::chrono::high_resolution_clock::now();
+
+	ThreadData &threadData = m_threadData.local();
+	if( threadData.running.empty() )
+	{
+		// We were activated while the process was running.
+		return;
+	}
+
+	threadData.events[threadData.running.top()].endTime = now - m_startTime;
+	threadData.running.pop();
+}
@@ -35,11 +35,22 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <deque>
+
+#include "tbb/atomic.h"
+#include "tbb/concurrent_hash_map.h"
+#include "tbb/task.h"
+#include "tbb/task_arena.h"
 #include "tbb/enumerable_thread_specific.h"
 
 #include "boost/bind.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/condition_variable.hpp"
 #include "boost/format.hpp"
-#include "boost/unordered_map.hpp"
+#include "boost/scoped_ptr.hpp"
+#include "boost/functional/hash.hpp"
 
 #include "Gaffer/Private/IECorePreview/LRUCache.h"
 
@@ -77,8 +88,44 @@ inline const ValuePlug *sourcePlug( const ValuePlug *p )
 	return p;
 }
 
+// Source for ValuePlug::m_dirtyCount. Because this is shared by all
+// plugs, dirty counts are unique across plugs as well as across time.
+tbb::atomic<uint64_t> g_dirtyCount;
+
 } // namespace
 
+//////////////////////////////////////////////////////////////////////////
+// HashDependencies records the context variables which a plug's hash
+// has been found to depend on. Each time a HashProcess runs, the names
+// of the variables it reads (either directly or via upstream hashes and
+// computes) are added. The hash cache is then keyed using only those
+// variables, allowing a plug which doesn't depend on "frame" (for instance)
+// to share a single entry between all frames.
+//
+// This is safe even though the dependencies are discovered incrementally :
+// an entry is only ever stored with a key which includes all the variables
+// read in computing it, and a computation in another context with the same
+// values for those variables would necessarily read the same variables and
+// arrive at the same result.
+//////////////////////////////////////////////////////////////////////////
+
+struct ValuePlug::HashDependencies : public IECore::RefCounted
+{
+
+	IE_CORE_DECLAREMEMBERPTR( HashDependencies )
+
+	HashDependencies()
+		:	all( false )
+	{
+	}
+
+	// True if the hash depends on the whole context,
+	// in which case `names` is unused.
+	bool all;
+	Context::DependencyTracker::Names names;
+
+};
+
 //////////////////////////////////////////////////////////////////////////
 // The HashProcess manages the task of calling ComputeNode::hash() and
 // managing a cache of recently computed hashes.
@@ -118,69 +165,79 @@ class ValuePlug::HashProcess : public Process
 			// one per context, computed by ComputeNode::hash(). First we see if we can retrieve the hash
 			// from our cache, and if we can't we'll compute it using a HashProcess instance.
 
-			ThreadData &threadData = g_threadData.local();
-			if( !Process::current() )
+			// The cache is keyed using only the context variables that the hash
+			// has been found to depend on, so that contexts differing only in
+			// unrelated variables share a single entry. See HashDependencies
+			// for more details.
+
+			const Context *context = Context::current();
+			HashDependencies::ConstPtr dependencies = p->hashDependencies();
+			const HashCacheKey key( p, contextHash( context, dependencies.get() ) );
+			IECore::MurmurHash result;
+			if( g_cache.cached( key, result ) )
 			{
-				// Starting a new root computation.
-				if( ++(threadData.cacheClearCount) == 3200 )
+				// We didn't run a HashProcess, so must tell any downstream
+				// process about the variables the cached result depends on.
+				if( context->m_dependencyTracker )
 				{
-					// Prevent unbounded growth in the hash cache
-					// if many computations are being performed
-					// without any plugs being dirtied in between,
-					// by clearing it after every Nth computation.
-					// N == 3200 was observed to be 6x faster than
-					// N == 100 for a procedural instancing scene at
-					// a memory cost of about 100 mb.
-					threadData.clearCache = 1;
+					if( dependencies && !dependencies->all )
+					{
+						context->m_dependencyTracker->read( dependencies->names );
+					}
+					else
+					{
+						context->m_dependencyTracker->readAll();
+					}
 				}
+				cacheHit( staticType, p );
+				return result;
 			}
 
-			if( threadData.clearCache )
+			HashProcess process( p, plug, dependencies.get() );
+			if( process.m_dependencies == dependencies )
 			{
-				threadData.cache.clear();
-				threadData.cacheClearCount = 0;
-				threadData.clearCache = 0;
+				// Nothing new was read, so the key we probed
+				// with is the right one to store the result with.
+				g_cache.set( key, process.m_result, 1 );
 			}
-
-			const CacheKey key( p, Context::current()->hash() );
-			Cache::iterator it = threadData.cache.find( key );
-			if( it != threadData.cache.end() )
+			else
 			{
-				return it->second;
+				g_cache.set( HashCacheKey( p, contextHash( context, process.m_dependencies.get() ) ), process.m_result, 1 );
 			}
-
-			HashProcess process( p, plug );
-			threadData.cache[key] = process.m_result;
 			return process.m_result;
 		}
 
+		static size_t getCacheSizeLimit()
+		{
+			return g_cache.getMaxCost();
+		}
+
+		static void setCacheSizeLimit( size_t maxEntries )
+		{
+			g_cache.setMaxCost( maxEntries );
+		}
+
+		static size_t cacheTotalUsage()
+		{
+			return g_cache.currentCost();
+		}
+
+		static size_t cacheEvictions()
+		{
+			return g_cache.evictions();
+		}
+
 		static void clearCache()
 		{
-			// The docs for enumerable_thread_specific aren't particularly clear
-			// on whether or not it's ok to iterate an e_t_s while concurrently using
-			// local(), which is what we do here. So far in practice it seems to be
-			// OK.
-			tbb::enumerable_thread_specific<ThreadData>::iterator it, eIt;
-			for( it = g_threadData.begin(), eIt = g_threadData.end(); it != eIt; ++it )
-			{
-				// We can't clear the cache now, because it is most likely
-				// in use by the owning thread. Instead we set this flag to
-				// politely request that the thread clears the cache itself
-				// at its earliest convenience - in the HashProcess constructor.
-				// This delay in clearing is OK, because it is illegal to modify
-				// a graph while a computation is being performed with it, and
-				// we know that the plug requesting the clear will be removed
-				// from the cache before the next computation starts.
-				it->clearCache = 1;
-			}
+			g_cache.clear();
 		}
 
 		static const IECore::InternedString staticType;
 
 	private :
 
-		HashProcess( const ValuePlug *plug, const ValuePlug *downstream )
-			:	Process( staticType, plug, downstream )
+		HashProcess( const ValuePlug *plug, const ValuePlug *downstream, const HashDependencies *dependencies )
+			:	Process( staticType, plug, downstream ), m_dependencies( dependencies )
 		{
 			try
 			{
@@ -190,7 +247,34 @@ class ValuePlug::HashProcess : public Process
 					throw IECore::Exception( boost::str( boost::format( "Unable to compute hash for Plug \"%s\" as it has no ComputeNode." ) % plug->fullName() ) );
 				}
 
-				n->hash( plug, Context::current(), m_result );
+				const Context *context = Context::current();
+				if( dependencies && dependencies->all )
+				{
+					// We already know that the hash depends on the whole
+					// context, so there is nothing more to discover, and
+					// we can skip the overhead of tracking.
+					if( context->m_dependencyTracker )
+					{
+						context->m_dependencyTracker->readAll();
+					}
+					n->hash( plug, context, m_result );
+				}
+				else
+				{
+					// Hash in a copy of the current context which records the
+					// variables that are read, so we know what we depend on.
+					TrackingScope trackingScope( context );
+					Context::Scope scope( trackingScope.context() );
+					n->hash( plug, trackingScope.context(), m_result );
+					const Context::DependencyTracker *tracker = trackingScope.tracker();
+					tracker->mergeIntoParent();
+					if( !dependencies || !tracker->readOnly( dependencies->names ) )
+					{
+						HashDependencies::Ptr processDependencies = new HashDependencies;
+						processDependencies->all = !tracker->names( processDependencies->names );
+						m_dependencies = plug->addHashDependencies( processDependencies );
+					}
+				}
 
 				if( m_result == IECore::MurmurHash() )
 				{
@@ -203,6 +287,106 @@ class ValuePlug::HashProcess : public Process
 			}
 		}
 
+		// Provides a temporary copy of the current context with its own
+		// DependencyTracker. Allocating these for every HashProcess would be
+		// costly, so each thread keeps a stack of them for reuse, with one
+		// entry for each level of nested HashProcess. An entry can only be
+		// reused if nothing else has kept a reference to it.
+		class TrackingScope : boost::noncopyable
+		{
+
+			public :
+
+				TrackingScope( const Context *context )
+					:	m_threadData( g_threadData.local() )
+				{
+					if( m_threadData.depth == m_threadData.entries.size() )
+					{
+						m_threadData.entries.push_back( Entry() );
+					}
+					m_entry = &m_threadData.entries[m_threadData.depth++];
+
+					Context::DependencyTracker *parent = context->m_dependencyTracker.get();
+					if( m_entry->tracker && m_entry->tracker->refCount() == 1 )
+					{
+						m_entry->tracker->reset( parent );
+					}
+					else
+					{
+						m_entry->tracker = new Context::DependencyTracker( parent );
+					}
+
+					if( m_entry->context && m_entry->context->refCount() == 1 )
+					{
+						m_entry->context->borrow( *context );
+					}
+					else
+					{
+						m_entry->context = new Context( *context, Context::Borrowed );
+					}
+					m_entry->context->m_dependencyTracker = m_entry->tracker;
+				}
+
+				~TrackingScope()
+				{
+					// Drop our internal references, so that refCount()
+					// tells us if anything else is holding on to the
+					// context or tracker when we next want to reuse them.
+					m_entry->context->m_dependencyTracker = NULL;
+					m_entry->tracker->reset( NULL );
+					m_threadData.depth--;
+				}
+
+				const Context *context() const
+				{
+					return m_entry->context.get();
+				}
+
+				const Context::DependencyTracker *tracker() const
+				{
+					return m_entry->tracker.get();
+				}
+
+			private :
+
+				struct Entry
+				{
+					ContextPtr context;
+					Context::DependencyTracker::Ptr tracker;
+				};
+
+				struct ThreadData
+				{
+					ThreadData() : depth( 0 ) {}
+					// A deque, so that pushing new entries doesn't
+					// invalidate the ones in use further up the stack.
+					std::deque<Entry> entries;
+					size_t depth;
+				};
+
+				typedef tbb::enumerable_thread_specific<ThreadData> ThreadSpecificData;
+				static ThreadSpecificData g_threadData;
+
+				ThreadData &m_threadData;
+				Entry *m_entry;
+
+		};
+
+		static IECore::MurmurHash contextHash( const Context *context, const HashDependencies *dependencies )
+		{
+			if( !dependencies || dependencies->all )
+			{
+				return context->hashInternal();
+			}
+			return context->variablesHash( dependencies->names );
+		}
+
+		static IECore::MurmurHash nullGetter( const HashCacheKey &key, size_t &cost )
+		{
+			cost = 0;
+			return IECore::MurmurHash();
+		}
+
 		// During a single graph evaluation, we actually call ValuePlug::hash()
 		// many times for the same plugs. First hash() is called for the terminating plug,
 		// which will call hash() for all the upstream plugs, and then compute() is called
@@ -212,33 +396,57 @@ class ValuePlug::HashProcess : public Process
 		// in the length of the chain of nodes - not good. Thanks is due to David Minor for
 		// being the first to point this out.
 		//
-		// We address this problem by keeping a per-thread cache of hashes, indexed
-		// by the plug the hash is for and the context the hash was performed in. The
-		// typedefs below describe that data structure. We use Plug::dirty() to empty
-		// the caches, because they are invalidated whenever an upstream value or
-		// connection is changed. We also clear the cache unconditionally every N
-		// computations, to prevent unbounded growth.
-		typedef std::pair<const ValuePlug *, IECore::MurmurHash> CacheKey;
-		typedef boost::unordered_map<CacheKey, IECore::MurmurHash> Cache;
-
-		// To support multithreading, each thread has it's own state.
-		struct ThreadData
-		{
-			ThreadData() : cacheClearCount( 0 ) {}
-			int cacheClearCount;
-			Cache cache;
-			// Flag to request that hashCache be cleared.
-			tbb::atomic<int> clearCache;
+		// We address this problem by keeping a cache of hashes, shared between all threads,
+		// and indexed by the plug the hash is for, the dirty count of that plug and the
+		// relevant variables from the context the hash was performed in. Since ValuePlug::dirty()
+		// gives the plug a new dirty count, entries are never invalidated explicitly - stale
+		// entries are simply never accessed again, and are evicted by the LRU mechanism in
+		// due course. Dirty counts are unique across all plugs, so a new plug which happens
+		// to reuse the address of a deleted one can't inadvertently reuse its entries either.
+		struct HashCacheKey
+		{
+			HashCacheKey()
+				:	plug( NULL ), dirtyCount( 0 )
+			{
+			}
+
+			HashCacheKey( const ValuePlug *plug, const IECore::MurmurHash &contextHash )
+				:	plug( plug ), contextHash( contextHash ), dirtyCount( plug->m_dirtyCount )
+			{
+			}
+
+			bool operator == ( const HashCacheKey &other ) const
+			{
+				return dirtyCount == other.dirtyCount && plug == other.plug && contextHash == other.contextHash;
+			}
+
+			friend size_t hash_value( const HashCacheKey &key )
+			{
+				size_t result = 0;
+				boost::hash_combine( result, key.plug );
+				boost::hash_combine( result, key.contextHash );
+				boost::hash_combine( result, key.dirtyCount );
+				return result;
+			}
+
+			const ValuePlug *plug;
+			IECore::MurmurHash contextHash;
+			uint64_t dirtyCount;
 		};
 
-		static tbb::enumerable_thread_specific<ThreadData, tbb::cache_aligned_allocator<ThreadData>, tbb::ets_key_per_instance > g_threadData;
+		// Each cache entry is given a cost of 1, so the maximum cost of
+		// the cache is simply the maximum number of entries.
+		typedef IECorePreview::LRUCache<HashCacheKey, IECore::MurmurHash> Cache;
+		static Cache g_cache;
 
 		IECore::MurmurHash m_result;
+		HashDependencies::ConstPtr m_dependencies;
 
 };
 
 const IECore::InternedString ValuePlug::HashProcess::staticType( "computeNode:hash" );
-tbb::enumerable_thread_specific<ValuePlug::HashProcess::ThreadData, tbb::cache_aligned_allocator<ValuePlug::HashProcess::ThreadData>, tbb::ets_key_per_instance > ValuePlug::HashProcess::g_threadData;
+ValuePlug::HashProcess::Cache ValuePlug::HashProcess::g_cache( nullGetter, 100000 );
+ValuePlug::HashProcess::TrackingScope::ThreadSpecificData ValuePlug::HashProcess::TrackingScope::g_threadData;
 
 //////////////////////////////////////////////////////////////////////////
 // The ComputeProcess manages the task of calling ComputeNode::compute()
@@ -265,6 +473,11 @@ class ValuePlug::ComputeProcess : public Process
 			return g_cache.currentCost();
 		}
 
+		static size_t cacheEvictions()
+		{
+			return g_cache.evictions();
+		}
+
 		static IECore::ConstObjectPtr value( const ValuePlug *plug, const IECore::MurmurHash *precomputedHash )
 		{
 			const ValuePlug *p = sourcePlug( plug );
@@ -283,42 +496,98 @@ class ValuePlug::ComputeProcess : public Process
 			// A plug with an input connection or an output plug on a ComputeNode. There can be many values -
 			// one per context, computed via ComputeNode::compute().
 
-			if( p->getFlags( Plug::Cacheable ) )
+			const CachePolicy cachePolicy = computeCachePolicy( p );
+			if( cachePolicy == Uncached )
 			{
-				// First see if we've done this computation already, and reuse the
-				// result if we have.
-				IECore::MurmurHash hash = precomputedHash ? *precomputedHash : p->hash();
-				IECore::ConstObjectPtr result = g_cache.get( hash );
-				if( result )
-				{
-					return result;
-				}
+				// Plug has requested no caching, so we compute from scratch every
+				// time.
+				return ComputeProcess( p, plug ).m_result;
+			}
+
+			// First see if we've done this computation already, and reuse the
+			// result if we have.
+			IECore::MurmurHash hash = precomputedHash ? *precomputedHash : p->hash();
+			IECore::ConstObjectPtr result = g_cache.get( hash );
+			if( result )
+			{
+				cacheHit( staticType, p );
+				return result;
+			}
 
-				// Otherwise, use a ComputeProcess instance to do the work.
+			if( cachePolicy == Legacy )
+			{
+				// Compute without any regard for other threads which may
+				// be computing the same thing concurrently.
 				ComputeProcess process( p, plug );
-				// Store the value in the cache, after first checking that this hasn't
-				// been done already. The check is useful because it's common for an
-				// upstream compute triggered by to have already
-				// done the work, and calling memoryUsage() can be very expensive for some
-				// datatypes. A prime example of this is the attribute state passed around
-				// in GafferScene - it's common for a selective filter to mean that the
-				// attribute compute is implemented as a pass-through (thus an upstream node
-				// will already have computed the same result) and the attribute data itself
-				// consists of many small objects for which computing memory usage is slow.
-				/// \todo Accessing the LRUCache multiple times like this does have an
-				/// overhead, and at some point we'll need to address that.
-				if( !g_cache.get( hash ) )
+				storeInCache( hash, process.m_result );
+				return process.m_result;
+			}
+
+			if( threadIsComputing( hash ) )
+			{
+				// This thread is already computing the same hash further up
+				// the stack. This is the norm for pass-through computes, which
+				// return their input's hash from hash() and then call getValue()
+				// on that input from compute(). Waiting on our own computation
+				// would deadlock, so we compute directly instead.
+				ComputeProcess process( p, plug );
+				storeInCache( hash, process.m_result );
+				return process.m_result;
+			}
+
+			// Otherwise, see if another thread is already computing the
+			// same value. If it is, we wait for its result rather than
+			// duplicating the work.
+			InFlightComputationPtr computation;
+			if( !acquireInFlightComputation( hash, cachePolicy, computation ) )
+			{
+				if( computation->wait() )
 				{
-					g_cache.set( hash, process.m_result, process.m_result->memoryUsage() );
+					// Although we don't retrieve the value from the cache, we
+					// report a hit because we're not paying for the compute.
+					cacheHit( staticType, p );
+					return computation->result();
 				}
+				// The computation failed on the owning thread. We don't transport
+				// the exception itself, because we have no means of copying an
+				// arbitrary exception, and some can't be rethrown on another
+				// thread anyway (a Python error is held in thread-specific
+				// interpreter state, for instance). Instead we repeat the compute,
+				// so that the error is thrown from this thread with its original
+				// type, and Node::errorSignal() is emitted for our own downstream
+				// plugs just as it was for the owning thread. This is the same
+				// behaviour as for concurrent computes of the Legacy policy.
+				ComputeProcess process( p, plug );
+				storeInCache( hash, process.m_result );
 				return process.m_result;
 			}
-			else
+
+			// We're the first thread to want this value, so it's up to
+			// us to compute it on behalf of any others that follow. The
+			// guard releases the computation (and any waiting threads)
+			// however we exit, including via an exception.
+			InFlightComputationOwner owner( hash, computation.get() );
+
+			// Another thread may have completed the same computation in
+			// between our cache lookup and now, so check again first.
+			result = g_cache.get( hash );
+			if( result )
 			{
-				// Plug has requested no caching, so we compute from scratch every
-				// time.
-				return ComputeProcess( p, plug ).m_result;
+				cacheHit( staticType, p );
+				computation->complete( result );
+				return result;
 			}
+
+			// The functor is executed directly on this thread, so any
+			// exception thrown by the compute propagates to our caller
+			// unchanged, having been reported via Node::errorSignal() by
+			// the ComputeProcess in the usual way.
+			ComputeFunctor computeFunctor( p, plug );
+			computation->execute( computeFunctor );
+
+			storeInCache( hash, computeFunctor.result );
+			computation->complete( computeFunctor.result );
+			return computeFunctor.result;
 		}
 
 		static void receiveResult( const ValuePlug *plug, IECore::ConstObjectPtr result )
@@ -384,6 +653,323 @@ class ValuePlug::ComputeProcess : public Process
 			return NULL;
 		}
 
+		static CachePolicy computeCachePolicy( const ValuePlug *plug )
+		{
+			if( !plug->getFlags( Plug::Cacheable ) )
+			{
+				return Uncached;
+			}
+
+			if( plug->getInput<ValuePlug>() )
+			{
+				// Type conversion via setFrom(). This is quick
+				// and never spawns tasks.
+				return Standard;
+			}
+
+			if( const ComputeNode *n = plug->ancestor<ComputeNode>() )
+			{
+				return n->computeCachePolicy( plug );
+			}
+
+			// Nothing to compute with. The ComputeProcess will
+			// throw an appropriate exception, so the policy is
+			// irrelevant.
+			return Legacy;
+		}
+
+		static void storeInCache( const IECore::MurmurHash &hash, const IECore::ConstObjectPtr &value )
+		{
+			// Store the value in the cache, after first checking that this hasn't
+			// been done already. The check is useful because it's common for an
+			// upstream compute triggered by to have already
+			// done the work, and calling memoryUsage() can be very expensive for some
+			// datatypes. A prime example of this is the attribute state passed around
+			// in GafferScene - it's common for a selective filter to mean that the
+			// attribute compute is implemented as a pass-through (thus an upstream node
+			// will already have computed the same result) and the attribute data itself
+			// consists of many small objects for which computing memory usage is slow.
+			/// \todo Accessing the LRUCache multiple times like this does have an
+			/// overhead, and at some point we'll need to address that.
+			if( !g_cache.get( hash ) )
+			{
+				g_cache.set( hash, value, value->memoryUsage() );
+			}
+		}
+
+		// When several threads request the same value concurrently (as is common
+		// when parallelProcessTiles() or parallelProcessLocations() fan out over
+		// a shared upstream input), we want only one of them to perform the
+		// computation. The InFlightComputation class allows the others to wait for
+		// the result.
+		//
+		// For the TaskCollaboration policy, the computation is performed inside its
+		// own task_arena, and waiting threads join the arena to help with any TBB
+		// tasks it spawns. The arena also isolates the computation from unrelated
+		// tasks; without isolation the computing thread could steal an outer task
+		// which then waits on a computation owned by one of the threads that is
+		// waiting on us, resulting in deadlock. For the Standard policy we avoid
+		// the overhead of the arena, and waiting threads simply block.
+		class InFlightComputation : public IECore::RefCounted
+		{
+
+			public :
+
+				enum Status
+				{
+					Running,
+					Complete,
+					Failed
+				};
+
+				InFlightComputation( bool taskCollaboration )
+					:	m_arena( taskCollaboration ? new tbb::task_arena : NULL ), m_status( Running )
+				{
+				}
+
+				IE_CORE_DECLAREMEMBERPTR( InFlightComputation )
+
+				Status status() const
+				{
+					Mutex::scoped_lock lock( m_mutex );
+					return m_status;
+				}
+
+				// Only valid once status() is Complete.
+				const IECore::ConstObjectPtr &result() const
+				{
+					return m_result;
+				}
+
+				// Called by the owning thread to perform the computation.
+				// The functor is run on the calling thread, so exceptions
+				// propagate to the caller.
+				template<typename F>
+				void execute( F &f )
+				{
+					if( m_arena )
+					{
+						m_arena->execute( f );
+					}
+					else
+					{
+						f();
+					}
+				}
+
+				void complete( IECore::ConstObjectPtr result )
+				{
+					Mutex::scoped_lock lock( m_mutex );
+					m_result = result;
+					finish( Complete );
+				}
+
+				void fail()
+				{
+					Mutex::scoped_lock lock( m_mutex );
+					finish( Failed );
+				}
+
+				// Waits for the owning thread to finish the computation,
+				// returning true if it succeeded and false if it failed.
+				// When collaborating, the calling thread helps with the
+				// tasks spawned by the computation while it waits, and
+				// otherwise it blocks.
+				bool wait()
+				{
+					if( m_arena )
+					{
+						HelpingWait helpingWait( this );
+						m_arena->execute( helpingWait );
+					}
+					else
+					{
+						Mutex::scoped_lock lock( m_mutex );
+						while( m_status == Running )
+						{
+							m_condition.wait( lock );
+						}
+					}
+					return status() == Complete;
+				}
+
+			private :
+
+				typedef boost::mutex Mutex;
+
+				// Must be called with m_mutex locked.
+				void finish( Status status )
+				{
+					if( m_status != Running )
+					{
+						return;
+					}
+					m_status = status;
+					for( std::vector<tbb::task *>::const_iterator it = m_waiters.begin(), eIt = m_waiters.end(); it != eIt; ++it )
+					{
+						(*it)->decrement_ref_count();
+					}
+					m_waiters.clear();
+					m_condition.notify_all();
+				}
+
+				// Executed inside the arena by waiting threads. Waiting on a
+				// root task with an outstanding reference allows the scheduler
+				// to steal tasks from the arena until finish() removes the
+				// reference. A task_group can't be used for this, because its
+				// wait() returns immediately unless tasks have already been
+				// added to the group.
+				struct HelpingWait
+				{
+
+					HelpingWait( InFlightComputation *computation )
+						:	m_computation( computation )
+					{
+					}
+
+					void operator()() const
+					{
+						tbb::task *root = new( tbb::task::allocate_root() ) tbb::empty_task;
+						root->set_ref_count( 2 );
+						{
+							Mutex::scoped_lock lock( m_computation->m_mutex );
+							if( m_computation->m_status != Running )
+							{
+								tbb::task::destroy( *root );
+								return;
+							}
+							m_computation->m_waiters.push_back( root );
+						}
+						root->wait_for_all();
+						tbb::task::destroy( *root );
+					}
+
+					InFlightComputation *m_computation;
+
+				};
+
+				boost::scoped_ptr<tbb::task_arena> m_arena;
+
+				mutable Mutex m_mutex;
+				boost::condition_variable m_condition;
+				Status m_status;
+				std::vector<tbb::task *> m_waiters;
+				IECore::ConstObjectPtr m_result;
+
+		};
+
+		IE_CORE_DECLAREPTR( InFlightComputation )
+
+		// Functor used by the owning thread to run a ComputeProcess for an
+		// InFlightComputation.
+		struct ComputeFunctor
+		{
+
+			ComputeFunctor( const ValuePlug *plug, const ValuePlug *downstream )
+				:	m_plug( plug ), m_downstream( downstream )
+			{
+			}
+
+			void operator()()
+			{
+				ComputeProcess process( m_plug, m_downstream );
+				result = process.m_result;
+			}
+
+			IECore::ConstObjectPtr result;
+
+			private :
+
+				const ValuePlug *m_plug;
+				const ValuePlug *m_downstream;
+
+		};
+
+		// The hashes of the computations owned by each thread, innermost last.
+		typedef std::vector<IECore::MurmurHash> HashStack;
+		typedef tbb::enumerable_thread_specific<HashStack, tbb::cache_aligned_allocator<HashStack>, tbb::ets_key_per_instance> ThreadHashStack;
+		static ThreadHashStack g_threadComputations;
+
+		static bool threadIsComputing( const IECore::MurmurHash &hash )
+		{
+			const HashStack &stack = g_threadComputations.local();
+			return std::find( stack.begin(), stack.end(), hash ) != stack.end();
+		}
+
+		// Scoped ownership of an InFlightComputation. Records the hash as
+		// being computed by the current thread, and on destruction removes
+		// the computation from g_inFlightComputations, failing it if it
+		// wasn't completed (because an exception was thrown).
+		class InFlightComputationOwner : boost::noncopyable
+		{
+
+			public :
+
+				InFlightComputationOwner( const IECore::MurmurHash &hash, InFlightComputation *computation )
+					:	m_hash( hash ), m_computation( computation ), m_stack( g_threadComputations.local() )
+				{
+					m_stack.push_back( hash );
+				}
+
+				~InFlightComputationOwner()
+				{
+					m_stack.pop_back();
+					// Mark the computation as failed before releasing it, so
+					// that waiting threads are woken even if we're unwinding
+					// due to an exception. This is a no-op if the computation
+					// was completed.
+					m_computation->fail();
+					// Now the result is in the cache (or the computation has
+					// failed), we no longer need to advertise the computation to
+					// other threads. Any threads already waiting hold their own
+					// reference to it.
+					releaseInFlightComputation( m_hash );
+				}
+
+			private :
+
+				IECore::MurmurHash m_hash;
+				InFlightComputation *m_computation;
+				HashStack &m_stack;
+
+		};
+
+		struct HashCompare
+		{
+			static size_t hash( const IECore::MurmurHash &h )
+			{
+				return boost::hash<IECore::MurmurHash>()( h );
+			}
+
+			static bool equal( const IECore::MurmurHash &a, const IECore::MurmurHash &b )
+			{
+				return a == b;
+			}
+		};
+
+		typedef tbb::concurrent_hash_map<IECore::MurmurHash, InFlightComputationPtr, HashCompare> InFlightComputations;
+		static InFlightComputations g_inFlightComputations;
+
+		// Returns true if the calling thread is now responsible for performing
+		// the computation, and false if another thread already is. In either
+		// case, `computation` is filled with the shared InFlightComputation.
+		static bool acquireInFlightComputation( const IECore::MurmurHash &hash, CachePolicy cachePolicy, InFlightComputationPtr &computation )
+		{
+			InFlightComputations::accessor accessor;
+			const bool inserted = g_inFlightComputations.insert( accessor, hash );
+			if( inserted )
+			{
+				accessor->second = new InFlightComputation( cachePolicy == TaskCollaboration );
+			}
+			computation = accessor->second;
+			return inserted;
+		}
+
+		static void releaseInFlightComputation( const IECore::MurmurHash &hash )
+		{
+			g_inFlightComputations.erase( hash );
+		}
+
 		// A cache mapping from ValuePlug::hash() to the result of the previous computation
 		// for that hash. This allows us to cache results for faster repeat evaluation
 		typedef IECorePreview::LRUCache<IECore::MurmurHash, IECore::ConstObjectPtr> Cache;
@@ -395,6 +981,8 @@ class ValuePlug::ComputeProcess : public Process
 
 const IECore::InternedString ValuePlug::ComputeProcess::staticType( "computeNode:compute" );
 ValuePlug::ComputeProcess::Cache ValuePlug::ComputeProcess::g_cache( nullGetter, 1024 * 1024 * 500 );
+ValuePlug::ComputeProcess::InFlightComputations ValuePlug::ComputeProcess::g_inFlightComputations;
+ValuePlug::ComputeProcess::ThreadHashStack ValuePlug::ComputeProcess::g_threadComputations;
 
 //////////////////////////////////////////////////////////////////////////
 // SetValueAction implementation
@@ -467,14 +1055,14 @@ IE_CORE_DEFINERUNTIMETYPED( ValuePlug );
 /// even creating the values before figuring out if we've already got them somewhere).
 ValuePlug::ValuePlug( const std::string &name, Direction direction,
 	IECore::ConstObjectPtr defaultValue, unsigned flags )
-	:	Plug( name, direction, flags ), m_defaultValue( defaultValue ), m_staticValue( defaultValue )
+	:	Plug( name, direction, flags ), m_defaultValue( defaultValue ), m_staticValue( defaultValue ), m_dirtyCount( ++g_dirtyCount )
 {
 	assert( m_defaultValue );
 	assert( m_staticValue );
 }
 
 ValuePlug::ValuePlug( const std::string &name, Direction direction, unsigned flags )
-	:	Plug( name, direction, flags ), m_defaultValue( NULL ), m_staticValue( NULL )
+	:	Plug( name, direction, flags ), m_defaultValue( NULL ), m_staticValue( NULL ), m_dirtyCount( ++g_dirtyCount )
 {
 	// We expect to have children added/removed, so arrange to deal with that
 	// appropriately. The other constructor above is for leaf plugs (this is
@@ -485,10 +1073,6 @@ ValuePlug::ValuePlug( const std::string &name, Direction direction, unsigned fla
 
 ValuePlug::~ValuePlug()
 {
-	// Clear hash cache, so that a newly created plug that just
-	// happens to reuse our address won't end up inadvertently also
-	// reusing our cache entries.
-	HashProcess::clearCache();
 }
 
 bool ValuePlug::acceptsChild( const GraphComponent *potentialChild ) const
@@ -774,10 +1358,46 @@ void ValuePlug::emitPlugSet()
 
 void ValuePlug::dirty()
 {
-	/// \todo We might want to investigate methods of doing a
-	/// more fine grained clearing of only the dirtied plugs,
-	/// rather than clearing the whole cache.
-	HashProcess::clearCache();
+	// Taking a new dirty count means that we will no longer
+	// find any of our previous entries in the hash cache.
+	m_dirtyCount = ++g_dirtyCount;
+	// And since the graph has changed, our hash may now
+	// depend on different context variables.
+	tbb::spin_mutex::scoped_lock lock( m_hashDependenciesMutex );
+	m_hashDependencies = NULL;
+}
+
+ValuePlug::HashDependencies::ConstPtr ValuePlug::hashDependencies() const
+{
+	tbb::spin_mutex::scoped_lock lock( m_hashDependenciesMutex );
+	return m_hashDependencies;
+}
+
+ValuePlug::HashDependencies::ConstPtr ValuePlug::addHashDependencies( HashDependencies::Ptr dependencies ) const
+{
+	tbb::spin_mutex::scoped_lock lock( m_hashDependenciesMutex );
+	if( m_hashDependencies )
+	{
+		// Merge with the existing dependencies, which may
+		// have been discovered in a different context.
+		if( m_hashDependencies->all || dependencies->all )
+		{
+			dependencies->all = true;
+			dependencies->names.clear();
+		}
+		else
+		{
+			dependencies->names.insert( m_hashDependencies->names.begin(), m_hashDependencies->names.end() );
+		}
+
+		if( dependencies->all == m_hashDependencies->all && dependencies->names == m_hashDependencies->names )
+		{
+			return m_hashDependencies;
+		}
+	}
+
+	m_hashDependencies = dependencies;
+	return m_hashDependencies;
 }
 
 size_t ValuePlug::getCacheMemoryLimit()
@@ -794,3 +1414,33 @@ size_t ValuePlug::cacheMemoryUsage()
 {
 	return ComputeProcess::cacheMemoryUsage();
 }
+
+size_t ValuePlug::cacheEvictions()
+{
+	return ComputeProcess::cacheEvictions();
+}
+
+size_t ValuePlug::getHashCacheSizeLimit()
+{
+	return HashProcess::getCacheSizeLimit();
+}
+
+void ValuePlug::setHashCacheSizeLimit( size_t maxEntries )
+{
+	HashProcess::setCacheSizeLimit( maxEntries );
+}
+
+size_t ValuePlug::hashCacheTotalUsage()
+{
+	return HashProcess::cacheTotalUsage();
+}
+
+size_t ValuePlug::hashCacheEvictions()
+{
+	return HashProcess::cacheEvictions();
+}
+
+void ValuePlug::clearHashCache()
+{
+	HashProcess::clearCache();
+}
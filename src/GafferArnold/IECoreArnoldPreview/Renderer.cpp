@@ -416,6 +416,96 @@ IECore::ConstObjectVectorPtr ArnoldAttributes::g_defaultShader = defaultShader()
 
 } // namespace
 
+//////////////////////////////////////////////////////////////////////////
+// InstanceCache
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef boost::shared_ptr<AtNode> SharedAtNodePtr;
+
+// Stores the AtNodes converted for instanced objects, so that each
+// unique object is converted only once, and then referenced by a
+// ginstance node for each location it appears at.
+class InstanceCache : public IECore::RefCounted
+{
+
+	public :
+
+		// Can be called concurrently with other get() calls.
+		SharedAtNodePtr get( const IECore::Object *object, const IECore::MurmurHash &hash )
+		{
+			Cache::accessor a;
+			m_cache.insert( a, hash );
+			if( !a->second )
+			{
+				a->second = master( NodeAlgo::convert( object ), hash );
+			}
+			return a->second;
+		}
+
+		// Can be called concurrently with other get() calls.
+		SharedAtNodePtr get( const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash )
+		{
+			Cache::accessor a;
+			m_cache.insert( a, hash );
+			if( !a->second )
+			{
+				a->second = master( NodeAlgo::convert( samples, times ), hash );
+			}
+			return a->second;
+		}
+
+		// Must not be called concurrently with anything.
+		void clearUnused()
+		{
+			vector<IECore::MurmurHash> toErase;
+			for( Cache::iterator it = m_cache.begin(), eIt = m_cache.end(); it != eIt; ++it )
+			{
+				if( it->second.use_count() <= 1 )
+				{
+					// Only one reference - this is ours, so
+					// nothing outside of the cache is using the
+					// node.
+					toErase.push_back( it->first );
+				}
+			}
+			for( vector<IECore::MurmurHash>::const_iterator it = toErase.begin(), eIt = toErase.end(); it != eIt; ++it )
+			{
+				m_cache.erase( *it );
+			}
+		}
+
+	private :
+
+		SharedAtNodePtr master( AtNode *node, const IECore::MurmurHash &hash )
+		{
+			if( !node )
+			{
+				return SharedAtNodePtr();
+			}
+
+			// The master node is only rendered via the ginstance
+			// nodes which reference it, so must be invisible itself.
+			AiNodeSetStr( node, "name", ( "instance:" + hash.toString() ).c_str() );
+			if( AiNodeEntryGetType( AiNodeGetNodeEntry( node ) ) == AI_NODE_SHAPE )
+			{
+				AiNodeSetByte( node, "visibility", 0 );
+			}
+
+			return SharedAtNodePtr( node, AiNodeDestroy );
+		}
+
+		typedef tbb::concurrent_hash_map<IECore::MurmurHash, SharedAtNodePtr> Cache;
+		Cache m_cache;
+
+};
+
+IE_CORE_DECLAREPTR( InstanceCache )
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // ArnoldObject
 //////////////////////////////////////////////////////////////////////////
@@ -454,6 +544,19 @@ class ArnoldObject : public IECoreScenePreview::Renderer::ObjectInterface
 			}
 		}
 
+		// Creates a ginstance node referencing an object shared
+		// with other instances.
+		ArnoldObject( const std::string &name, const SharedAtNodePtr &master )
+			:	m_node( NULL ), m_master( master )
+		{
+			if( m_master )
+			{
+				m_node = AiNode( "ginstance" );
+				AiNodeSetStr( m_node, "name", name.c_str() );
+				AiNodeSetPtr( m_node, "node", m_master.get() );
+			}
+		}
+
 		virtual ~ArnoldObject()
 		{
 			if( m_node )
@@ -517,6 +620,9 @@ class ArnoldObject : public IECoreScenePreview::Renderer::ObjectInterface
 
 		AtNode *m_node;
 		ArnoldShaderPtr m_shader;
+		// Keeps the instanced object alive as
+		// long as we are alive.
+		SharedAtNodePtr m_master;
 
 };
 
@@ -603,6 +709,7 @@ class ArnoldRenderer : public IECoreScenePreview::Renderer
 			:	m_renderType( renderType ),
 				m_universeBlock( boost::make_shared<UniverseBlock>() ),
 				m_shaderCache( new ShaderCache ),
+				m_instanceCache( new InstanceCache ),
 				m_assFileName( fileName )
 		{
 			/// \todo Control with an option.
@@ -731,10 +838,21 @@ class ArnoldRenderer : public IECoreScenePreview::Renderer
 			return store( new ArnoldObject( name, samples, times ) );
 		}
 
+		virtual ObjectInterfacePtr instance( const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash )
+		{
+			return store( new ArnoldObject( name, m_instanceCache->get( object, hash ) ) );
+		}
+
+		virtual ObjectInterfacePtr instance( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash )
+		{
+			return store( new ArnoldObject( name, m_instanceCache->get( samples, times, hash ) ) );
+		}
+
 		virtual void render()
 		{
 			updateCamera();
 			m_shaderCache->clearUnused();
+			m_instanceCache->clearUnused();
 
 			// Do the appropriate render based on
 			// m_renderType.
@@ -866,6 +984,7 @@ class ArnoldRenderer : public IECoreScenePreview::Renderer
 		ObjectInterfacePtr m_defaultCamera;
 
 		ShaderCachePtr m_shaderCache;
+		InstanceCachePtr m_instanceCache;
 
 		// Members used by batch renders
 
@@ -39,6 +39,7 @@
 
 #include "Gaffer/Monitor.h"
 #include "Gaffer/PerformanceMonitor.h"
+#include "Gaffer/TraceMonitor.h"
 #include "Gaffer/MonitorAlgo.h"
 #include "Gaffer/Plug.h"
 
@@ -64,11 +65,13 @@ void exitScope( Monitor &m, object type, object value, object traceBack )
 std::string repr( PerformanceMonitor::Statistics &s )
 {
 	return boost::str(
-		boost::format( "Gaffer.PerformanceMonitor.Statistics( hashCount = %d, computeCount = %d, hashDuration = %d, computeDuration = %d )" )
+		boost::format( "Gaffer.PerformanceMonitor.Statistics( hashCount = %d, computeCount = %d, hashDuration = %d, computeDuration = %d, hashCacheHits = %d, computeCacheHits = %d )" )
 			% s.hashCount
 			% s.computeCount
 			% s.hashDuration.count()
 			% s.computeDuration.count()
+			% s.hashCacheHits
+			% s.computeCacheHits
 	);
 }
 
@@ -76,10 +79,12 @@ PerformanceMonitor::Statistics *statisticsConstructor(
 	size_t hashCount,
 	size_t computeCount,
 	boost::chrono::nanoseconds::rep hashDuration,
-	boost::chrono::nanoseconds::rep computeDuration
+	boost::chrono::nanoseconds::rep computeDuration,
+	size_t hashCacheHits,
+	size_t computeCacheHits
 )
 {
-	return new PerformanceMonitor::Statistics( hashCount, computeCount, boost::chrono::nanoseconds( hashDuration ), boost::chrono::nanoseconds( computeDuration ) );
+	return new PerformanceMonitor::Statistics( hashCount, computeCount, boost::chrono::nanoseconds( hashDuration ), boost::chrono::nanoseconds( computeDuration ), hashCacheHits, computeCacheHits );
 }
 
 boost::chrono::nanoseconds::rep getHashDuration( PerformanceMonitor::Statistics &s )
@@ -128,6 +133,8 @@ void GafferBindings::bindMonitor()
 		.value( "PerHashDuration", PerHashDuration )
 		.value( "PerComputeDuration", PerComputeDuration )
 		.value( "HashesPerCompute", HashesPerCompute )
+		.value( "HashCacheHits", HashCacheHits )
+		.value( "ComputeCacheHits", ComputeCacheHits )
 	;
 
 	def(
@@ -156,6 +163,10 @@ void GafferBindings::bindMonitor()
 		.def( "__exit__", &exitScope )
 	;
 
+	class_<TraceMonitor, bases<Monitor>, boost::noncopyable >( "TraceMonitor" )
+		.def( "writeTrace", ( void (TraceMonitor::*)( const std::string & ) const )&TraceMonitor::writeTrace )
+	;
+
 	scope s = class_<PerformanceMonitor, bases<Monitor>, boost::noncopyable >( "PerformanceMonitor" )
 		.def( "allStatistics", &allStatistics )
 		.def( "plugStatistics", &PerformanceMonitor::plugStatistics, return_value_policy<copy_const_reference>() )
@@ -167,7 +178,9 @@ void GafferBindings::bindMonitor()
 					arg( "hashCount" ) = 0,
 					arg( "computeCount" ) = 0,
 					arg( "hashDuration" ) = 0,
-					arg( "computeDuration" ) = 0
+					arg( "computeDuration" ) = 0,
+					arg( "hashCacheHits" ) = 0,
+					arg( "computeCacheHits" ) = 0
 				)
 			)
 		)
@@ -175,6 +188,8 @@ void GafferBindings::bindMonitor()
 		.def_readwrite( "computeCount", &PerformanceMonitor::Statistics::computeCount )
 		.add_property( "hashDuration", &getHashDuration, &setHashDuration )
 		.add_property( "computeDuration", &getComputeDuration, &setComputeDuration )
+		.def_readwrite( "hashCacheHits", &PerformanceMonitor::Statistics::hashCacheHits )
+		.def_readwrite( "computeCacheHits", &PerformanceMonitor::Statistics::computeCacheHits )
 		.def( self == self )
 		.def( self != self )
 		.def( "__repr__", &repr )
@@ -269,7 +269,7 @@ bool ValuePlugSerialiser::valueNeedsSerialisation( const Gaffer::ValuePlug *plug
 
 void GafferBindings::bindValuePlug()
 {
-	PlugClass<ValuePlug, PlugWrapper<ValuePlug> >()
+	scope s = PlugClass<ValuePlug, PlugWrapper<ValuePlug> >()
 		.def( boost::python::init<const std::string &, Plug::Direction, unsigned>(
 				(
 					boost::python::arg_( "name" ) = GraphComponent::defaultName<ValuePlug>(),
@@ -290,8 +290,27 @@ void GafferBindings::bindValuePlug()
 		.staticmethod( "setCacheMemoryLimit" )
 		.def( "cacheMemoryUsage", &ValuePlug::cacheMemoryUsage )
 		.staticmethod( "cacheMemoryUsage" )
+		.def( "cacheEvictions", &ValuePlug::cacheEvictions )
+		.staticmethod( "cacheEvictions" )
+		.def( "getHashCacheSizeLimit", &ValuePlug::getHashCacheSizeLimit )
+		.staticmethod( "getHashCacheSizeLimit" )
+		.def( "setHashCacheSizeLimit", &ValuePlug::setHashCacheSizeLimit )
+		.staticmethod( "setHashCacheSizeLimit" )
+		.def( "hashCacheTotalUsage", &ValuePlug::hashCacheTotalUsage )
+		.staticmethod( "hashCacheTotalUsage" )
+		.def( "hashCacheEvictions", &ValuePlug::hashCacheEvictions )
+		.staticmethod( "hashCacheEvictions" )
+		.def( "clearHashCache", &ValuePlug::clearHashCache )
+		.staticmethod( "clearHashCache" )
 		.def( "__repr__", &repr )
 	;
 
+	enum_<ValuePlug::CachePolicy>( "CachePolicy" )
+		.value( "Uncached", ValuePlug::Uncached )
+		.value( "Standard", ValuePlug::Standard )
+		.value( "TaskCollaboration", ValuePlug::TaskCollaboration )
+		.value( "Legacy", ValuePlug::Legacy )
+	;
+
 	Serialisation::registerSerialiser( Gaffer::ValuePlug::staticTypeId(), new ValuePlugSerialiser );
 }
@@ -34,15 +34,161 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+#include <algorithm>
+
+#include "tbb/parallel_for.h"
+
+#include "Gaffer/Context.h"
 #include "Gaffer/StringPlug.h"
 
 #include "GafferImage/Blur.h"
 #include "GafferImage/Resample.h"
+#include "GafferImage/Sampler.h"
+#include "GafferImage/BufferAlgo.h"
 
+using namespace std;
 using namespace Imath;
+using namespace IECore;
 using namespace Gaffer;
 using namespace GafferImage;
 
+//////////////////////////////////////////////////////////////////////////
+// Utilities for the Fast mode
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// The radii of three box filters which, applied in succession,
+// approximate a gaussian. See "Fast Almost-Gaussian Filtering"
+// by Peter Kovesi.
+struct BoxRadii
+{
+
+	BoxRadii( float radius )
+	{
+		// Match the standard deviation of the SmoothGaussian2D filter used
+		// by the internal Resample in Accurate mode, which has a width of
+		// 2 * ( 1 + radius ).
+		const float sigma = ( 1.0f + radius ) / sqrtf( 10.0f );
+
+		int lower = (int)floorf( sqrtf( 4.0f * sigma * sigma + 1.0f ) );
+		if( lower % 2 == 0 )
+		{
+			lower--;
+		}
+		const int upper = lower + 2;
+		const int numLower = (int)roundf(
+			( 12.0f * sigma * sigma - 3 * lower * lower - 12 * lower - 9 ) / ( -4.0f * lower - 4.0f )
+		);
+
+		support = 0;
+		for( int i = 0; i < 3; ++i )
+		{
+			radii[i] = ( ( i < numLower ? lower : upper ) - 1 ) / 2;
+			support += radii[i];
+		}
+	}
+
+	int radii[3];
+	// The distance a pixel's value spreads
+	// once all three filters are applied.
+	int support;
+
+};
+
+// Filters `buffer` in place with the three box filters, using running sums
+// so that the cost is independent of the filter radii. Each filter shrinks
+// the buffer by twice its radius, so the result is `2 * boxRadii.support`
+// values shorter than the input.
+void boxFilter( vector<float> &buffer, const BoxRadii &boxRadii, vector<float> &scratch )
+{
+	for( int i = 0; i < 3; ++i )
+	{
+		const int radius = boxRadii.radii[i];
+		if( radius == 0 )
+		{
+			continue;
+		}
+
+		const int width = 2 * radius + 1;
+		const float normalisation = 1.0f / width;
+		scratch.resize( buffer.size() - 2 * radius );
+
+		double sum = 0;
+		for( int x = 0; x < width; ++x )
+		{
+			sum += buffer[x];
+		}
+
+		for( size_t x = 0, e = scratch.size(); x < e; ++x )
+		{
+			scratch[x] = sum * normalisation;
+			if( x + 1 < e )
+			{
+				sum += buffer[x+width] - buffer[x];
+			}
+		}
+
+		buffer.swap( scratch );
+	}
+}
+
+// The data window for the Fast mode. This matches the data window produced
+// by the internal Resample in Accurate mode, rather than the support of the
+// box filters, so that the two modes are interchangeable. In particular, the
+// Resample's filter has a width of 2 even on an axis with a zero radius, so
+// that axis is still expanded, with the extra pixels taking their values
+// from the bounding mode.
+Box2i fastDataWindow( const Box2i &inputDataWindow, const V2f &radius, bool expand )
+{
+	if( !expand || empty( inputDataWindow ) )
+	{
+		return inputDataWindow;
+	}
+	const V2i expansion( (int)ceilf( 1.0f + radius.x ), (int)ceilf( 1.0f + radius.y ) );
+	return Box2i( inputDataWindow.min - expansion, inputDataWindow.max + expansion );
+}
+
+// Computes the horizontal strips needed by a vertical strip,
+// in parallel.
+class HorizontalStrips
+{
+
+	public :
+
+		HorizontalStrips( const FloatVectorDataPlug *plug, int firstTileY, vector<ConstFloatVectorDataPtr> &strips )
+			:	m_plug( plug ), m_firstTileY( firstTileY ), m_strips( strips ), m_parentContext( Context::current() )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			ContextPtr context = new Context( *m_parentContext, Context::Borrowed );
+			Context::Scope scope( context.get() );
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				context->set( ImagePlug::tileOriginContextName, V2i( 0, m_firstTileY + i * ImagePlug::tileSize() ) );
+				m_strips[i] = m_plug->getValue();
+			}
+		}
+
+	private :
+
+		const FloatVectorDataPlug *m_plug;
+		const int m_firstTileY;
+		vector<ConstFloatVectorDataPtr> &m_strips;
+		const Context *m_parentContext;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Blur
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Blur );
 
 size_t Blur::g_firstPlugIndex = 0;
@@ -57,6 +203,7 @@ Blur::Blur( const std::string &name )
 	addChild( new V2fPlug( "radius", Plug::In, V2f( 0 ), V2f( 0 ) ) );
 	addChild( resample->boundingModePlug()->createCounterpart( "boundingMode", Plug::In ) );
 	addChild( new BoolPlug( "expandDataWindow" ) );
+	addChild( new IntPlug( "mode", Plug::In, Accurate, Accurate, Fast ) );
 
 	addChild( new AtomicBox2fPlug( "__dataWindow", Plug::Out ) );
 	addChild( new V2fPlug( "__filterWidth", Plug::Out ) );
@@ -66,6 +213,9 @@ Blur::Blur( const std::string &name )
 
 	addChild( resample );
 
+	addChild( new FloatVectorDataPlug( "__horizontalStrip", Plug::Out, ImagePlug::blackTile() ) );
+	addChild( new FloatVectorDataPlug( "__verticalStrip", Plug::Out, ImagePlug::blackTile() ) );
+
 	resample->inPlug()->setInput( inPlug() );
 	resample->filterPlug()->setValue( "smoothGaussian" );
 	resample->boundingModePlug()->setInput( boundingModePlug() );
@@ -115,54 +265,84 @@ const Gaffer::BoolPlug *Blur::expandDataWindowPlug() const
 	return getChild<BoolPlug>( g_firstPlugIndex + 2 );
 }
 
+Gaffer::IntPlug *Blur::modePlug()
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 3 );
+}
+
+const Gaffer::IntPlug *Blur::modePlug() const
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 3 );
+}
+
 Gaffer::AtomicBox2fPlug *Blur::dataWindowPlug()
 {
-	return getChild<AtomicBox2fPlug>( g_firstPlugIndex + 3 );
+	return getChild<AtomicBox2fPlug>( g_firstPlugIndex + 4 );
 }
 
 const Gaffer::AtomicBox2fPlug *Blur::dataWindowPlug() const
 {
-	return getChild<AtomicBox2fPlug>( g_firstPlugIndex + 3 );
+	return getChild<AtomicBox2fPlug>( g_firstPlugIndex + 4 );
 }
 
 Gaffer::V2fPlug *Blur::filterWidthPlug()
 {
-	return getChild<V2fPlug>( g_firstPlugIndex + 4 );
+	return getChild<V2fPlug>( g_firstPlugIndex + 5 );
 }
 
 const Gaffer::V2fPlug *Blur::filterWidthPlug() const
 {
-	return getChild<V2fPlug>( g_firstPlugIndex + 4 );
+	return getChild<V2fPlug>( g_firstPlugIndex + 5 );
 }
 
 Gaffer::AtomicBox2iPlug *Blur::resampledDataWindowPlug()
 {
-	return getChild<AtomicBox2iPlug>( g_firstPlugIndex + 5 );
+	return getChild<AtomicBox2iPlug>( g_firstPlugIndex + 6 );
 }
 
 const Gaffer::AtomicBox2iPlug *Blur::resampledDataWindowPlug() const
 {
-	return getChild<AtomicBox2iPlug>( g_firstPlugIndex + 5 );
+	return getChild<AtomicBox2iPlug>( g_firstPlugIndex + 6 );
 }
 
 Gaffer::FloatVectorDataPlug *Blur::resampledChannelDataPlug()
 {
-	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 6 );
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 7 );
 }
 
 const Gaffer::FloatVectorDataPlug *Blur::resampledChannelDataPlug() const
 {
-	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 6 );
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 7 );
 }
 
 Resample *Blur::resample()
 {
-	return getChild<Resample>( g_firstPlugIndex + 7 );
+	return getChild<Resample>( g_firstPlugIndex + 8 );
 }
 
 const Resample *Blur::resample() const
 {
-	return getChild<Resample>( g_firstPlugIndex + 7 );
+	return getChild<Resample>( g_firstPlugIndex + 8 );
+}
+
+Gaffer::FloatVectorDataPlug *Blur::horizontalStripPlug()
+{
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 9 );
+}
+
+const Gaffer::FloatVectorDataPlug *Blur::horizontalStripPlug() const
+{
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 9 );
+}
+
+Gaffer::FloatVectorDataPlug *Blur::verticalStripPlug()
+{
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 10 );
+}
+
+const Gaffer::FloatVectorDataPlug *Blur::verticalStripPlug() const
+{
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex + 10 );
 }
 
 void Blur::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
@@ -173,11 +353,20 @@ void Blur::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs )
 	{
 		outputs.push_back( dataWindowPlug() );
 		outputs.push_back( outPlug()->dataWindowPlug() );
+		outputs.push_back( horizontalStripPlug() );
+		outputs.push_back( verticalStripPlug() );
 	}
-	else if(
-		input == expandDataWindowPlug() ||
-		input == resampledDataWindowPlug()
-	)
+	else if( input == inPlug()->channelDataPlug() )
+	{
+		outputs.push_back( horizontalStripPlug() );
+	}
+	else if( input == expandDataWindowPlug() )
+	{
+		outputs.push_back( outPlug()->dataWindowPlug() );
+		outputs.push_back( horizontalStripPlug() );
+		outputs.push_back( verticalStripPlug() );
+	}
+	else if( input == resampledDataWindowPlug() )
 	{
 		outputs.push_back( outPlug()->dataWindowPlug() );
 	}
@@ -186,9 +375,26 @@ void Blur::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs )
 		outputs.push_back( filterWidthPlug()->getChild<ValuePlug>( input->getName() ) );
 		outputs.push_back( outPlug()->dataWindowPlug() );
 		outputs.push_back( outPlug()->channelDataPlug() );
+		outputs.push_back( horizontalStripPlug() );
+		outputs.push_back( verticalStripPlug() );
+	}
+	else if( input == boundingModePlug() )
+	{
+		outputs.push_back( horizontalStripPlug() );
+		outputs.push_back( verticalStripPlug() );
+	}
+	else if( input == modePlug() )
+	{
+		outputs.push_back( outPlug()->dataWindowPlug() );
+		outputs.push_back( outPlug()->channelDataPlug() );
+	}
+	else if( input == horizontalStripPlug() )
+	{
+		outputs.push_back( verticalStripPlug() );
 	}
 	else if(
-		input == resampledChannelDataPlug()
+		input == resampledChannelDataPlug() ||
+		input == verticalStripPlug()
 	)
 	{
 		outputs.push_back( outPlug()->channelDataPlug() );
@@ -207,6 +413,55 @@ void Blur::hash( const ValuePlug *output, const Context *context, IECore::Murmur
 	{
 		radiusPlug()->getChild<ValuePlug>( output->getName() )->hash( h );
 	}
+	else if( output == horizontalStripPlug() )
+	{
+		const BoxRadii boxRadiiX( radiusPlug()->getChild( 0 )->getValue() );
+		const Box2i inputDataWindow = inPlug()->dataWindowPlug()->getValue();
+		const Box2i outputDataWindow = fastDataWindow( inputDataWindow, radiusPlug()->getValue(), expandDataWindowPlug()->getValue() );
+		const int tileY = context->get<V2i>( ImagePlug::tileOriginContextName ).y;
+
+		h.append( boxRadiiX.radii, 3 );
+		h.append( outputDataWindow );
+		h.append( tileY );
+
+		const Box2i rows(
+			V2i( outputDataWindow.min.x - boxRadiiX.support, std::max( tileY, inputDataWindow.min.y ) ),
+			V2i( outputDataWindow.max.x + boxRadiiX.support, std::min( tileY + ImagePlug::tileSize(), inputDataWindow.max.y ) )
+		);
+
+		if( !empty( rows ) )
+		{
+			Sampler sampler(
+				inPlug(),
+				context->get<std::string>( ImagePlug::channelNameContextName ),
+				rows,
+				(Sampler::BoundingMode)boundingModePlug()->getValue()
+			);
+			sampler.hash( h );
+		}
+	}
+	else if( output == verticalStripPlug() )
+	{
+		const BoxRadii boxRadiiY( radiusPlug()->getChild( 1 )->getValue() );
+		const Box2i inputDataWindow = inPlug()->dataWindowPlug()->getValue();
+		const Box2i outputDataWindow = fastDataWindow( inputDataWindow, radiusPlug()->getValue(), expandDataWindowPlug()->getValue() );
+
+		h.append( boxRadiiY.radii, 3 );
+		h.append( outputDataWindow );
+		h.append( context->get<V2i>( ImagePlug::tileOriginContextName ).x );
+		boundingModePlug()->hash( h );
+
+		if( !empty( inputDataWindow ) )
+		{
+			ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+			Context::Scope scopedContext( tmpContext.get() );
+			for( int y = ImagePlug::tileOrigin( inputDataWindow.min ).y; y < inputDataWindow.max.y; y += ImagePlug::tileSize() )
+			{
+				tmpContext->set( ImagePlug::tileOriginContextName, V2i( 0, y ) );
+				horizontalStripPlug()->hash( h );
+			}
+		}
+	}
 }
 
 void Blur::compute( ValuePlug *output, const Context *context ) const
@@ -224,6 +479,114 @@ void Blur::compute( ValuePlug *output, const Context *context ) const
 		);
 		return;
 	}
+	else if( output == horizontalStripPlug() )
+	{
+		// Filters all the rows of a row of tiles across the full width
+		// of the output data window. Rows outside the input data window
+		// are left empty, because the vertical pass deals with them.
+
+		const BoxRadii boxRadiiX( radiusPlug()->getChild( 0 )->getValue() );
+		const Box2i inputDataWindow = inPlug()->dataWindowPlug()->getValue();
+		const Box2i outputDataWindow = fastDataWindow( inputDataWindow, radiusPlug()->getValue(), expandDataWindowPlug()->getValue() );
+		const int tileY = context->get<V2i>( ImagePlug::tileOriginContextName ).y;
+		const int width = outputDataWindow.size().x;
+
+		FloatVectorDataPtr resultData = new FloatVectorData;
+		vector<float> &result = resultData->writable();
+		result.resize( width * ImagePlug::tileSize(), 0.0f );
+
+		const Box2i rows(
+			V2i( outputDataWindow.min.x - boxRadiiX.support, std::max( tileY, inputDataWindow.min.y ) ),
+			V2i( outputDataWindow.max.x + boxRadiiX.support, std::min( tileY + ImagePlug::tileSize(), inputDataWindow.max.y ) )
+		);
+
+		if( !empty( rows ) )
+		{
+			Sampler sampler(
+				inPlug(),
+				context->get<std::string>( ImagePlug::channelNameContextName ),
+				rows,
+				(Sampler::BoundingMode)boundingModePlug()->getValue()
+			);
+
+			vector<float> buffer, scratch;
+			for( int y = rows.min.y; y < rows.max.y; ++y )
+			{
+				buffer.resize( rows.size().x );
+				for( int x = rows.min.x; x < rows.max.x; ++x )
+				{
+					buffer[x-rows.min.x] = sampler.sample( x, y );
+				}
+				boxFilter( buffer, boxRadiiX, scratch );
+				std::copy( buffer.begin(), buffer.end(), result.begin() + ( y - tileY ) * width );
+			}
+		}
+
+		static_cast<FloatVectorDataPlug *>( output )->setValue( resultData );
+		return;
+	}
+	else if( output == verticalStripPlug() )
+	{
+		// Filters all the columns of a column of tiles across the full
+		// height of the output data window, taking the input from the
+		// horizontal strips.
+
+		const BoxRadii boxRadiiY( radiusPlug()->getChild( 1 )->getValue() );
+		const Box2i inputDataWindow = inPlug()->dataWindowPlug()->getValue();
+		const Box2i outputDataWindow = fastDataWindow( inputDataWindow, radiusPlug()->getValue(), expandDataWindowPlug()->getValue() );
+		const Sampler::BoundingMode boundingMode = (Sampler::BoundingMode)boundingModePlug()->getValue();
+		const int tileX = context->get<V2i>( ImagePlug::tileOriginContextName ).x;
+		const int height = outputDataWindow.size().y;
+
+		FloatVectorDataPtr resultData = new FloatVectorData;
+		vector<float> &result = resultData->writable();
+		result.resize( height * ImagePlug::tileSize(), 0.0f );
+
+		const int columnsBegin = std::max( tileX, outputDataWindow.min.x );
+		const int columnsEnd = std::min( tileX + ImagePlug::tileSize(), outputDataWindow.max.x );
+		if( empty( inputDataWindow ) || columnsBegin >= columnsEnd )
+		{
+			static_cast<FloatVectorDataPlug *>( output )->setValue( resultData );
+			return;
+		}
+
+		const int firstTileY = ImagePlug::tileOrigin( inputDataWindow.min ).y;
+		vector<ConstFloatVectorDataPtr> strips( ( ImagePlug::tileOrigin( inputDataWindow.max - V2i( 1 ) ).y - firstTileY ) / ImagePlug::tileSize() + 1 );
+		HorizontalStrips horizontalStrips( horizontalStripPlug(), firstTileY, strips );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, strips.size() ), horizontalStrips );
+
+		const int stripWidth = outputDataWindow.size().x;
+		const int rowsBegin = outputDataWindow.min.y - boxRadiiY.support;
+		const int rowsEnd = outputDataWindow.max.y + boxRadiiY.support;
+
+		vector<float> buffer, scratch;
+		for( int x = columnsBegin; x < columnsEnd; ++x )
+		{
+			buffer.resize( rowsEnd - rowsBegin );
+			for( int y = rowsBegin; y < rowsEnd; ++y )
+			{
+				int sourceY = y;
+				if( y < inputDataWindow.min.y || y >= inputDataWindow.max.y )
+				{
+					if( boundingMode == Sampler::Black )
+					{
+						buffer[y-rowsBegin] = 0.0f;
+						continue;
+					}
+					sourceY = std::max( inputDataWindow.min.y, std::min( y, inputDataWindow.max.y - 1 ) );
+				}
+
+				const int stripIndex = ( ImagePlug::tileOrigin( V2i( 0, sourceY ) ).y - firstTileY ) / ImagePlug::tileSize();
+				const int stripRow = sourceY - ImagePlug::tileOrigin( V2i( 0, sourceY ) ).y;
+				buffer[y-rowsBegin] = strips[stripIndex]->readable()[stripRow * stripWidth + x - outputDataWindow.min.x];
+			}
+			boxFilter( buffer, boxRadiiY, scratch );
+			std::copy( buffer.begin(), buffer.end(), result.begin() + ( x - tileX ) * height );
+		}
+
+		static_cast<FloatVectorDataPlug *>( output )->setValue( resultData );
+		return;
+	}
 
 	ImageProcessor::compute( output, context );
 }
@@ -232,7 +595,16 @@ void Blur::hashDataWindow( const GafferImage::ImagePlug *parent, const Gaffer::C
 {
 	if( radiusPlug()->getValue() != V2f( 0 ) && expandDataWindowPlug()->getValue() )
 	{
-		h = resampledDataWindowPlug()->hash();
+		if( modePlug()->getValue() == Fast )
+		{
+			ImageProcessor::hashDataWindow( parent, context, h );
+			inPlug()->dataWindowPlug()->hash( h );
+			radiusPlug()->hash( h );
+		}
+		else
+		{
+			h = resampledDataWindowPlug()->hash();
+		}
 	}
 	else
 	{
@@ -242,9 +614,17 @@ void Blur::hashDataWindow( const GafferImage::ImagePlug *parent, const Gaffer::C
 
 Imath::Box2i Blur::computeDataWindow( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	if( radiusPlug()->getValue() != V2f( 0 ) && expandDataWindowPlug()->getValue() )
+	const V2f radius = radiusPlug()->getValue();
+	if( radius != V2f( 0 ) && expandDataWindowPlug()->getValue() )
 	{
-		return resampledDataWindowPlug()->getValue();
+		if( modePlug()->getValue() == Fast )
+		{
+			return fastDataWindow( inPlug()->dataWindowPlug()->getValue(), radius, true );
+		}
+		else
+		{
+			return resampledDataWindowPlug()->getValue();
+		}
 	}
 	else
 	{
@@ -256,7 +636,23 @@ void Blur::hashChannelData( const GafferImage::ImagePlug *parent, const Gaffer::
 {
 	if( radiusPlug()->getValue() != V2f( 0 ) )
 	{
-		h = resampledChannelDataPlug()->hash();
+		if( modePlug()->getValue() == Fast )
+		{
+			ImageProcessor::hashChannelData( parent, context, h );
+
+			const V2i tileOrigin = context->get<V2i>( ImagePlug::tileOriginContextName );
+			h.append( tileOrigin.y );
+			outPlug()->dataWindowPlug()->hash( h );
+
+			ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+			Context::Scope scopedContext( tmpContext.get() );
+			tmpContext->set( ImagePlug::tileOriginContextName, V2i( tileOrigin.x, 0 ) );
+			verticalStripPlug()->hash( h );
+		}
+		else
+		{
+			h = resampledChannelDataPlug()->hash();
+		}
 	}
 	else
 	{
@@ -268,7 +664,41 @@ IECore::ConstFloatVectorDataPtr Blur::computeChannelData( const std::string &cha
 {
 	if( radiusPlug()->getValue() != V2f( 0 ) )
 	{
-		return resampledChannelDataPlug()->getValue();
+		if( modePlug()->getValue() == Fast )
+		{
+			const Box2i dataWindow = outPlug()->dataWindowPlug()->getValue();
+
+			ConstFloatVectorDataPtr stripData;
+			{
+				ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+				Context::Scope scopedContext( tmpContext.get() );
+				tmpContext->set( ImagePlug::tileOriginContextName, V2i( tileOrigin.x, 0 ) );
+				stripData = verticalStripPlug()->getValue();
+			}
+			const vector<float> &strip = stripData->readable();
+			const int height = dataWindow.size().y;
+
+			FloatVectorDataPtr resultData = new FloatVectorData;
+			vector<float> &result = resultData->writable();
+			result.resize( ImagePlug::tileSize() * ImagePlug::tileSize(), 0.0f );
+
+			const Box2i tileBound( tileOrigin, tileOrigin + V2i( ImagePlug::tileSize() ) );
+			const Box2i b = intersection( tileBound, dataWindow );
+			for( int y = b.min.y; y < b.max.y; ++y )
+			{
+				vector<float>::iterator it = result.begin() + GafferImage::index( V2i( b.min.x, y ), tileBound );
+				for( int x = b.min.x; x < b.max.x; ++x )
+				{
+					*it++ = strip[( x - tileOrigin.x ) * height + y - dataWindow.min.y];
+				}
+			}
+
+			return resultData;
+		}
+		else
+		{
+			return resampledChannelDataPlug()->getValue();
+		}
 	}
 	else
 	{
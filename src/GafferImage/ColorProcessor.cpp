@@ -62,11 +62,6 @@ ColorProcessor::ColorProcessor( const std::string &name )
 		)
 	);
 
-	// Because our implementation of computeChannelData() is so simple,
-	// just copying data out of our intermediate colorDataPlug(), it is
-	// actually quicker not to cache the result.
-	outPlug()->channelDataPlug()->setFlags( Plug::Cacheable, false );
-
 	// We don't ever want to change the these, so we make pass-through connections.
 	outPlug()->formatPlug()->setInput( inPlug()->formatPlug() );
 	outPlug()->dataWindowPlug()->setInput( inPlug()->dataWindowPlug() );
@@ -121,19 +116,31 @@ void ColorProcessor::compute( Gaffer::ValuePlug *output, const Gaffer::Context *
 {
 	if( output == colorDataPlug() )
 	{
+		// Rather than pulling on the output of any ColorProcessors
+		// immediately upstream, which would compute and cache their own
+		// colour data, we fuse them into this computation, applying their
+		// processing directly to our copy of the input data. A chain of
+		// ColorProcessors therefore makes a single pass over memory per
+		// tile, and only the result at the end of the chain is cached.
+		vector<const ColorProcessor *> chain;
+		const ImagePlug *chainInPlug = fusedChain( chain );
+
 		FloatVectorDataPtr r, g, b;
 		{
 			ContextPtr tmpContext = new Context( *context, Context::Borrowed );
 			Context::Scope scopedContext( tmpContext.get() );
 			tmpContext->set( ImagePlug::channelNameContextName, string( "R" ) );
-			r = inPlug()->channelDataPlug()->getValue()->copy();
+			r = chainInPlug->channelDataPlug()->getValue()->copy();
 			tmpContext->set( ImagePlug::channelNameContextName, string( "G" ) );
-			g = inPlug()->channelDataPlug()->getValue()->copy();
+			g = chainInPlug->channelDataPlug()->getValue()->copy();
 			tmpContext->set( ImagePlug::channelNameContextName, string( "B" ) );
-			b = inPlug()->channelDataPlug()->getValue()->copy();
+			b = chainInPlug->channelDataPlug()->getValue()->copy();
 		}
 
-		processColorData( context, r.get(), g.get(), b.get() );
+		for( vector<const ColorProcessor *>::const_reverse_iterator it = chain.rbegin(), eIt = chain.rend(); it != eIt; ++it )
+		{
+			(*it)->processColorData( context, r.get(), g.get(), b.get() );
+		}
 
 		ObjectVectorPtr result = new ObjectVector();
 		result->members().push_back( r );
@@ -147,6 +154,18 @@ void ColorProcessor::compute( Gaffer::ValuePlug *output, const Gaffer::Context *
 	ImageProcessor::compute( output, context );
 }
 
+Gaffer::ValuePlug::CachePolicy ColorProcessor::computeCachePolicy( const Gaffer::ValuePlug *output ) const
+{
+	if( output == outPlug()->channelDataPlug() )
+	{
+		// Because our implementation of computeChannelData() is so simple,
+		// just copying data out of our intermediate colorDataPlug(), it is
+		// actually quicker not to cache the result.
+		return ValuePlug::Uncached;
+	}
+	return ImageProcessor::computeCachePolicy( output );
+}
+
 void ColorProcessor::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	const std::string &channel = context->get<std::string>( ImagePlug::channelNameContextName );
@@ -201,3 +220,37 @@ void ColorProcessor::hashColorData( const Gaffer::Context *context, IECore::Murm
 	tmpContext->set( ImagePlug::channelNameContextName, string( "B" ) );
 	inPlug()->channelDataPlug()->hash( h );
 }
+
+const ImagePlug *ColorProcessor::fusedChain( std::vector<const ColorProcessor *> &chain ) const
+{
+	chain.push_back( this );
+
+	const ImagePlug *chainInPlug = inPlug();
+	while( true )
+	{
+		const Plug *source = chainInPlug->channelDataPlug()->source<Plug>();
+		const ColorProcessor *upstream = runTimeCast<const ColorProcessor>( source->node() );
+		if( !upstream || source != upstream->outPlug()->channelDataPlug() )
+		{
+			break;
+		}
+
+		if( !upstream->enabled() )
+		{
+			// A disabled node passes through its input,
+			// so we can skip it and continue upstream.
+			chainInPlug = upstream->inPlug();
+			continue;
+		}
+
+		if( !upstream->channelEnabled( "R" ) || !upstream->channelEnabled( "G" ) || !upstream->channelEnabled( "B" ) )
+		{
+			break;
+		}
+
+		chain.push_back( upstream );
+		chainInPlug = upstream->inPlug();
+	}
+
+	return chainInPlug;
+}
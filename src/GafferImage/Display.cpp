@@ -50,6 +50,7 @@
 
 #include "GafferImage/Display.h"
 #include "GafferImage/FormatPlug.h"
+#include "GafferImage/BufferAlgo.h"
 
 using namespace std;
 using namespace Imath;
@@ -174,7 +175,7 @@ class GafferDisplayDriver : public IECore::DisplayDriver
 				}
 			}
 
-			dataReceivedSignal()( this, box );
+			dataReceivedSignal()( this, gafferBox );
 		}
 
 		virtual void imageClose()
@@ -211,6 +212,7 @@ class GafferDisplayDriver : public IECore::DisplayDriver
 			}
 		}
 
+		// The box is provided in Gaffer's pixel space.
 		typedef boost::signal<void ( GafferDisplayDriver *, const Imath::Box2i & )> DataReceivedSignal;
 		DataReceivedSignal &dataReceivedSignal()
 		{
@@ -293,7 +295,7 @@ IE_CORE_DEFINERUNTIMETYPED( Display );
 size_t Display::g_firstPlugIndex = 0;
 
 Display::Display( const std::string &name )
-	:	ImageNode( name )
+	:	ImageNode( name ), m_receivedDriver( false )
 {
 	storeIndexOfNextChild( g_firstPlugIndex );
 
@@ -312,10 +314,12 @@ Display::Display( const std::string &name )
 		)
 	);
 
-	// this plug is incremented when new data is received, triggering dirty signals
-	// and prompting reevaluation in the viewer. see GafferImageUI.DisplayUI for
-	// details of how it is set (we can't set it from dataReceived() because we're
-	// not on the ui thread at that point.
+	// these plugs are incremented by applyReceivedData() when new data is received,
+	// triggering dirty signals and prompting reevaluation in the viewer. see
+	// GafferImageUI.DisplayUI for details of how that is called (we can't set them
+	// from dataReceived() because we're not on the ui thread at that point). the
+	// first dirties the whole image when a new image arrives, and the second just
+	// the channel data when buckets arrive.
 	addChild(
 		new IntPlug(
 			"__updateCount",
@@ -327,6 +331,17 @@ Display::Display( const std::string &name )
 		)
 	);
 
+	addChild(
+		new IntPlug(
+			"__channelDataUpdateCount",
+			Plug::In,
+			0,
+			0,
+			Imath::limits<int>::max(),
+			Plug::Default & ~Plug::Serialisable
+		)
+	);
+
 	plugSetSignal().connect( boost::bind( &Display::plugSet, this, ::_1 ) );
 	GafferDisplayDriver::instanceCreatedSignal().connect( boost::bind( &Display::driverCreated, this, ::_1 ) );
 	setupServer();
@@ -356,6 +371,16 @@ const Gaffer::IntPlug *Display::updateCountPlug() const
 	return getChild<IntPlug>( g_firstPlugIndex + 1 );
 }
 
+Gaffer::IntPlug *Display::channelDataUpdateCountPlug()
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 2 );
+}
+
+const Gaffer::IntPlug *Display::channelDataUpdateCountPlug() const
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 2 );
+}
+
 void Display::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ImageNode::affects( input, outputs );
@@ -367,6 +392,10 @@ void Display::affects( const Gaffer::Plug *input, AffectedPlugsContainer &output
 			outputs.push_back( it->get() );
 		}
 	}
+	else if( input == channelDataUpdateCountPlug() )
+	{
+		outputs.push_back( outPlug()->channelDataPlug() );
+	}
 }
 
 Node::UnaryPlugSignal &Display::dataReceivedSignal()
@@ -381,6 +410,29 @@ Node::UnaryPlugSignal &Display::imageReceivedSignal()
 	return s;
 }
 
+void Display::applyReceivedData()
+{
+	bool receivedDriver;
+	Box2i receivedRegion;
+	{
+		tbb::spin_mutex::scoped_lock lock( m_receivedDataMutex );
+		receivedDriver = m_receivedDriver;
+		receivedRegion = m_receivedRegion;
+		m_receivedDriver = false;
+		m_receivedRegion = Box2i();
+	}
+
+	if( receivedDriver )
+	{
+		updateCountPlug()->setValue( updateCountPlug()->getValue() + 1 );
+	}
+	else if( !empty( receivedRegion ) )
+	{
+		ImagePlug::DirtyRegionScope dirtyRegionScope( outPlug(), receivedRegion );
+		channelDataUpdateCountPlug()->setValue( channelDataUpdateCountPlug()->getValue() + 1 );
+	}
+}
+
 void Display::hashFormat( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ImageNode::hashFormat( output, context, h );
@@ -470,6 +522,10 @@ void Display::hashChannelData( const GafferImage::ImagePlug *output, const Gaffe
 			context->get<std::string>( ImagePlug::channelNameContextName )
 		);
 	}
+	// Buckets only dirty the region they cover (see applyReceivedData()),
+	// and tiles outside it keep the same data, and therefore the same hash,
+	// so downstream values for them are reused from the cache. The hash
+	// itself is cheap, because the data caches it.
 	h = channelData->Object::hash();
 }
 
@@ -525,6 +581,13 @@ void Display::setupDriver( GafferDisplayDriverPtr driver )
 	}
 
 	m_driver = driver;
+
+	{
+		tbb::spin_mutex::scoped_lock lock( m_receivedDataMutex );
+		m_receivedDriver = true;
+		m_receivedRegion = Box2i();
+	}
+
 	if( m_driver )
 	{
 		m_driver->dataReceivedSignal().connect( boost::bind( &Display::dataReceived, this, _1, _2 ) );
@@ -534,6 +597,10 @@ void Display::setupDriver( GafferDisplayDriverPtr driver )
 
 void Display::dataReceived( GafferDisplayDriver *driver, const Imath::Box2i &bound )
 {
+	{
+		tbb::spin_mutex::scoped_lock lock( m_receivedDataMutex );
+		m_receivedRegion.extendBy( bound );
+	}
 	dataReceivedSignal()( outPlug() );
 }
 
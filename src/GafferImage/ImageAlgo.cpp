@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "GafferImage/ImageAlgo.h"
+#include "GafferImage/ImageTransform.h"
+#include "GafferImage/Resize.h"
+#include "GafferImage/Offset.h"
+
+using namespace Imath;
+using namespace IECore;
+using namespace Gaffer;
+using namespace GafferImage;
+
+namespace
+{
+
+bool axisAligned( const M33f &m )
+{
+	return m[0][1] == 0.0f && m[1][0] == 0.0f;
+}
+
+} // namespace
+
+const ImagePlug *GafferImage::concatenatedTransformInput( const ImagePlug *image, Imath::M33f &matrix )
+{
+	matrix = M33f();
+	while( true )
+	{
+		const Plug *source = image->channelDataPlug()->source<Plug>();
+		const ImageProcessor *upstream = runTimeCast<const ImageProcessor>( source->node() );
+		if(
+			!upstream ||
+			source != upstream->outPlug()->channelDataPlug() ||
+			image->dataWindowPlug()->source<Plug>() != upstream->outPlug()->dataWindowPlug()
+		)
+		{
+			break;
+		}
+
+		M33f upstreamMatrix;
+		if( !upstream->enabled() )
+		{
+			// A disabled node passes through its input,
+			// so we can skip it and continue upstream.
+		}
+		else if( const ImageTransform *imageTransform = runTimeCast<const ImageTransform>( upstream ) )
+		{
+			upstreamMatrix = imageTransform->matrix();
+		}
+		else if( const Resize *resize = runTimeCast<const Resize>( upstream ) )
+		{
+			upstreamMatrix = resize->matrix();
+		}
+		else if( const Offset *offset = runTimeCast<const Offset>( upstream ) )
+		{
+			upstreamMatrix.setTranslation( V2f( offset->offsetPlug()->getValue() ) );
+		}
+		else
+		{
+			break;
+		}
+
+		if( !axisAligned( upstreamMatrix ) )
+		{
+			break;
+		}
+
+		matrix = upstreamMatrix * matrix;
+		image = upstream->inPlug();
+	}
+
+	return image;
+}
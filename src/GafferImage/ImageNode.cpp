@@ -241,6 +241,27 @@ void ImageNode::compute( ValuePlug *output, const Context *context ) const
 	}
 }
 
+Gaffer::ValuePlug::CachePolicy ImageNode::computeCachePolicy( const Gaffer::ValuePlug *output ) const
+{
+	if( const ImagePlug *imagePlug = output->parent<ImagePlug>() )
+	{
+		if( output != imagePlug->channelDataPlug() )
+		{
+			// None of the computeFormat(), computeDataWindow(), computeMetadata()
+			// or computeChannelNames() implementations spawn tasks themselves.
+			// The parallel work in GafferImage is all per-tile, and is done in
+			// channel data computes, in ImageStats (whose outputs aren't part of
+			// an ImagePlug) and in ImageWriter::execute(). Should one of these
+			// computes pull on a value which does spawn tasks, that is done via
+			// getValue(), and the tasks are isolated by the TaskCollaboration
+			// policy of the upstream plug. Derived classes which do spawn tasks
+			// from these methods must reimplement computeCachePolicy().
+			return ValuePlug::Standard;
+		}
+	}
+	return ComputeNode::computeCachePolicy( output );
+}
+
 GafferImage::Format ImageNode::computeFormat( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
 	throw IECore::NotImplementedException( string( typeName() ) + "::computeFormat" );
@@ -35,12 +35,16 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/enumerable_thread_specific.h"
+
 #include "Gaffer/Context.h"
 
 #include "GafferImage/ImagePlug.h"
 #include "GafferImage/FormatPlug.h"
 #include "GafferImage/ImageAlgo.h"
 #include "GafferImage/BufferAlgo.h"
+#include "GafferImage/ChannelDataProcessor.h"
+#include "GafferImage/ColorProcessor.h"
 
 using namespace std;
 using namespace tbb;
@@ -326,6 +330,43 @@ IECore::MurmurHash ImagePlug::channelDataHash( const std::string &channelName, c
 	return channelDataPlug()->hash();
 }
 
+void ImagePlug::channelData( const std::vector<std::string> &channelNames, const Imath::V2i &tile, std::vector<IECore::ConstFloatVectorDataPtr> &channelData ) const
+{
+	channelData.clear();
+	channelData.reserve( channelNames.size() );
+
+	if( direction()==In && !getInput<Plug>() )
+	{
+		channelData.resize( channelNames.size(), channelDataPlug()->defaultValue() );
+		return;
+	}
+
+	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
+	tmpContext->set( ImagePlug::tileOriginContextName, tile );
+	Context::Scope scopedContext( tmpContext.get() );
+
+	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+	{
+		tmpContext->set( ImagePlug::channelNameContextName, *it );
+		channelData.push_back( channelDataPlug()->getValue() );
+	}
+}
+
+IECore::MurmurHash ImagePlug::channelDataHash( const std::vector<std::string> &channelNames, const Imath::V2i &tile ) const
+{
+	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
+	tmpContext->set( ImagePlug::tileOriginContextName, tile );
+	Context::Scope scopedContext( tmpContext.get() );
+
+	IECore::MurmurHash result;
+	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+	{
+		tmpContext->set( ImagePlug::channelNameContextName, *it );
+		channelDataPlug()->hash( result );
+	}
+	return result;
+}
+
 IECore::ImagePrimitivePtr ImagePlug::image() const
 {
 	Format format = formatPlug()->getValue();
@@ -412,3 +453,71 @@ void ImagePlug::compoundObjectToCompoundData( const CompoundObject *object, Comp
 		}
 	}
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Dirty regions
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef tbb::enumerable_thread_specific<const ImagePlug::DirtyRegionScope *> CurrentDirtyRegionScope;
+CurrentDirtyRegionScope g_currentDirtyRegionScope( (const ImagePlug::DirtyRegionScope *)NULL );
+
+const Box2i g_infiniteRegion( V2i( Imath::limits<int>::min() ), V2i( Imath::limits<int>::max() ) );
+
+} // namespace
+
+ImagePlug::DirtyRegionScope::DirtyRegionScope( const ImagePlug *image, const Imath::Box2i &region )
+	:	m_image( image ), m_region( region )
+{
+	const DirtyRegionScope *&current = g_currentDirtyRegionScope.local();
+	m_previous = current;
+	current = this;
+}
+
+ImagePlug::DirtyRegionScope::~DirtyRegionScope()
+{
+	g_currentDirtyRegionScope.local() = m_previous;
+}
+
+Imath::Box2i ImagePlug::dirtyRegion() const
+{
+	const DirtyRegionScope *scope = g_currentDirtyRegionScope.local();
+	if( !scope )
+	{
+		return g_infiniteRegion;
+	}
+
+	const ImagePlug *image = this;
+	while( image )
+	{
+		for( const DirtyRegionScope *s = scope; s; s = s->m_previous )
+		{
+			if( s->m_image == image )
+			{
+				return s->m_region;
+			}
+		}
+
+		if( const ImagePlug *input = image->getInput<ImagePlug>() )
+		{
+			image = input;
+			continue;
+		}
+
+		const ImageProcessor *processor = runTimeCast<const ImageProcessor>( image->node() );
+		if(
+			processor && image == processor->outPlug() &&
+			( runTimeCast<const ChannelDataProcessor>( processor ) || runTimeCast<const ColorProcessor>( processor ) )
+		)
+		{
+			image = processor->inPlug();
+			continue;
+		}
+
+		break;
+	}
+
+	return g_infiniteRegion;
+}
@@ -36,8 +36,12 @@
 
 #include "boost/bind.hpp"
 
+#include "OpenEXR/half.h"
+
 #include "OpenColorIO/OpenColorIO.h"
 
+#include "IECore/VectorTypedData.h"
+
 #include "Gaffer/StringPlug.h"
 
 #include "GafferImage/ColorSpace.h"
@@ -51,6 +55,53 @@ using namespace IECore;
 using namespace Gaffer;
 using namespace GafferImage;
 
+//////////////////////////////////////////////////////////////////////////
+// Utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Returns the tile in the most compact form which represents it exactly.
+// Tiles read from half precision files (the norm for EXR plates) survive
+// the round trip through half, so can be stored at half the cost of the
+// float tile.
+ConstObjectPtr packTile( ConstFloatVectorDataPtr tileData )
+{
+	const vector<float> &tile = tileData->readable();
+
+	HalfVectorDataPtr resultData = new HalfVectorData;
+	vector<half> &result = resultData->writable();
+	result.reserve( tile.size() );
+	for( vector<float>::const_iterator it = tile.begin(), eIt = tile.end(); it != eIt; ++it )
+	{
+		const half h( *it );
+		if( (float)h != *it )
+		{
+			return tileData;
+		}
+		result.push_back( h );
+	}
+
+	return resultData;
+}
+
+// Inverse of packTile().
+ConstFloatVectorDataPtr unpackTile( ConstObjectPtr tileData )
+{
+	if( const HalfVectorData *halfData = runTimeCast<const HalfVectorData>( tileData.get() ) )
+	{
+		const vector<half> &tile = halfData->readable();
+		FloatVectorDataPtr resultData = new FloatVectorData;
+		resultData->writable().assign( tile.begin(), tile.end() );
+		return resultData;
+	}
+
+	return boost::static_pointer_cast<const FloatVectorData>( tileData );
+}
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // ImageReader implementation
 //////////////////////////////////////////////////////////////////////////
@@ -99,7 +150,24 @@ ImageReader::ImageReader( const std::string &name )
 
 	ColorSpacePtr colorSpace = new ColorSpace( "__colorSpace" );
 	addChild( colorSpace );
-	colorSpace->inPlug()->setInput( oiioReader->outPlug() );
+
+	addChild( new ObjectPlug( "__tileData", Plug::Out, new FloatVectorData, Plug::Default & ~Plug::Serialisable ) );
+	addChild( new ImagePlug( "__fileImage", Plug::In, Plug::Default & ~Plug::Serialisable ) );
+	addChild( new ImagePlug( "__unpackedImage", Plug::Out, Plug::Default & ~Plug::Serialisable ) );
+
+	// The file data is packed into tileDataPlug() before it reaches the
+	// colour conversion, and unpacked again by unpackedImagePlug(). Everything
+	// but the channel data is passed straight through.
+	fileImagePlug()->setInput( oiioReader->outPlug() );
+	for( ValuePlugIterator it( unpackedImagePlug() ); !it.done(); ++it )
+	{
+		if( *it != unpackedImagePlug()->channelDataPlug() )
+		{
+			(*it)->setInput( fileImagePlug()->getChild<Plug>( (*it)->getName() ) );
+		}
+	}
+
+	colorSpace->inPlug()->setInput( unpackedImagePlug() );
 	colorSpace->inputSpacePlug()->setInput( intermediateColorSpacePlug() );
 	colorSpace->outputSpacePlug()->setValue( OpenColorIO::ROLE_SCENE_LINEAR );
 	intermediateImagePlug()->setInput( colorSpace->outPlug() );
@@ -229,6 +297,36 @@ const ColorSpace *ImageReader::colorSpace() const
 	return getChild<ColorSpace>( g_firstChildIndex + 9 );
 }
 
+ObjectPlug *ImageReader::tileDataPlug()
+{
+	return getChild<ObjectPlug>( g_firstChildIndex + 10 );
+}
+
+const ObjectPlug *ImageReader::tileDataPlug() const
+{
+	return getChild<ObjectPlug>( g_firstChildIndex + 10 );
+}
+
+ImagePlug *ImageReader::fileImagePlug()
+{
+	return getChild<ImagePlug>( g_firstChildIndex + 11 );
+}
+
+const ImagePlug *ImageReader::fileImagePlug() const
+{
+	return getChild<ImagePlug>( g_firstChildIndex + 11 );
+}
+
+ImagePlug *ImageReader::unpackedImagePlug()
+{
+	return getChild<ImagePlug>( g_firstChildIndex + 12 );
+}
+
+const ImagePlug *ImageReader::unpackedImagePlug() const
+{
+	return getChild<ImagePlug>( g_firstChildIndex + 12 );
+}
+
 size_t ImageReader::supportedExtensions( std::vector<std::string> &extensions )
 {
 	OpenImageIOReader::supportedExtensions( extensions );
@@ -243,6 +341,14 @@ void ImageReader::affects( const Plug *input, AffectedPlugsContainer &outputs )
 	{
 		outputs.push_back( intermediateColorSpacePlug() );
 	}
+	else if( input == fileImagePlug()->channelDataPlug() )
+	{
+		outputs.push_back( tileDataPlug() );
+	}
+	else if( input == tileDataPlug() )
+	{
+		outputs.push_back( unpackedImagePlug()->channelDataPlug() );
+	}
 	else if( input->parent<ImagePlug>() == intermediateImagePlug() )
 	{
 		outputs.push_back( outPlug()->getChild<ValuePlug>( input->getName() ) );
@@ -269,6 +375,14 @@ void ImageReader::hash( const ValuePlug *output, const Context *context, IECore:
 	{
 		intermediateMetadataPlug()->hash( h );
 	}
+	else if( output == tileDataPlug() )
+	{
+		fileImagePlug()->channelDataPlug()->hash( h );
+	}
+	else if( output == unpackedImagePlug()->channelDataPlug() )
+	{
+		tileDataPlug()->hash( h );
+	}
 	else if(
 		output == outPlug()->formatPlug() ||
 		output == outPlug()->dataWindowPlug()
@@ -306,6 +420,16 @@ void ImageReader::compute( ValuePlug *output, const Context *context ) const
 
 		static_cast<StringPlug *>( output )->setValue( intermediateSpace );
 	}
+	else if( output == tileDataPlug() )
+	{
+		static_cast<ObjectPlug *>( output )->setValue(
+			packTile( fileImagePlug()->channelDataPlug()->getValue() )
+		);
+	}
+	else if( output == unpackedImagePlug()->channelDataPlug() )
+	{
+		static_cast<FloatVectorDataPlug *>( output )->setValue( unpackTile( tileDataPlug()->getValue() ) );
+	}
 	else if(
 		output == outPlug()->formatPlug() ||
 		output == outPlug()->dataWindowPlug()
@@ -329,6 +453,24 @@ void ImageReader::compute( ValuePlug *output, const Context *context ) const
 	}
 }
 
+Gaffer::ValuePlug::CachePolicy ImageReader::computeCachePolicy( const Gaffer::ValuePlug *output ) const
+{
+	if( output == unpackedImagePlug()->channelDataPlug() )
+	{
+		// We cache the compact tileDataPlug() instead, and converting
+		// back to float is cheap enough to do on every request.
+		return ValuePlug::Uncached;
+	}
+	else if( output == outPlug()->channelDataPlug() )
+	{
+		// We're just passing through the data from colorSpace(), which
+		// is either cached already following colour conversion, or is
+		// the data from unpackedImagePlug(), which we don't want to cache.
+		return ValuePlug::Uncached;
+	}
+	return ImageNode::computeCachePolicy( output );
+}
+
 void ImageReader::hashMaskedOutput( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h, bool alwaysClampToFrame ) const
 {
 	ContextPtr maskedContext = NULL;
@@ -34,19 +34,166 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <limits>
+#include <algorithm>
+
+#include "IECore/VectorTypedData.h"
+
 #include "Gaffer/TypedPlug.h"
 #include "Gaffer/BoxPlug.h"
 #include "Gaffer/ScriptNode.h"
 
 #include "GafferImage/ImageStats.h"
-#include "GafferImage/Sampler.h"
 #include "GafferImage/ChannelMaskPlug.h"
 #include "GafferImage/FormatPlug.h"
 #include "GafferImage/ImageAlgo.h"
+#include "GafferImage/BufferAlgo.h"
 
+using namespace std;
+using namespace Imath;
+using namespace IECore;
 using namespace GafferImage;
 using namespace Gaffer;
 
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct Statistics
+{
+
+	Statistics()
+		:	min( std::numeric_limits<float>::max() ), max( -std::numeric_limits<float>::max() ), sum( 0 )
+	{
+	}
+
+	void add( float v )
+	{
+		min = std::min( min, v );
+		max = std::max( max, v );
+		sum += v;
+	}
+
+	void add( const Statistics &other )
+	{
+		min = std::min( min, other.min );
+		max = std::max( max, other.max );
+		sum += other.sum;
+	}
+
+	float min;
+	float max;
+	double sum;
+
+};
+
+struct HashTile
+{
+
+	typedef MurmurHash Result;
+
+	Result operator()( const ImagePlug *imagePlug, const string &channelName, const V2i &tileOrigin )
+	{
+		return imagePlug->channelDataPlug()->hash();
+	}
+
+};
+
+struct AppendHash
+{
+
+	AppendHash( MurmurHash &hash )
+		:	m_hash( hash )
+	{
+	}
+
+	void operator()( const ImagePlug *imagePlug, const string &channelName, const V2i &tileOrigin, const MurmurHash &tileHash )
+	{
+		m_hash.append( tileHash );
+	}
+
+	private :
+
+		MurmurHash &m_hash;
+
+};
+
+// Computes the statistics for the portion of
+// a tile which lies within the window.
+struct TileStatistics
+{
+
+	typedef Statistics Result;
+
+	TileStatistics( const Box2i &window )
+		:	m_window( window )
+	{
+	}
+
+	Result operator()( const ImagePlug *imagePlug, const string &channelName, const V2i &tileOrigin )
+	{
+		ConstFloatVectorDataPtr channelData = imagePlug->channelDataPlug()->getValue();
+		const vector<float> &channel = channelData->readable();
+
+		const Box2i tileBound( tileOrigin, tileOrigin + V2i( ImagePlug::tileSize() ) );
+		const Box2i b = intersection( tileBound, m_window );
+
+		Result result;
+		for( int y = b.min.y; y < b.max.y; ++y )
+		{
+			vector<float>::const_iterator it = channel.begin() + GafferImage::index( V2i( b.min.x, y ), tileBound );
+			for( int x = b.min.x; x < b.max.x; ++x )
+			{
+				result.add( *it++ );
+			}
+		}
+
+		return result;
+	}
+
+	private :
+
+		const Box2i m_window;
+
+};
+
+// Accumulates the statistics for each tile into
+// the totals for the appropriate channel.
+struct AccumulateStatistics
+{
+
+	AccumulateStatistics( const vector<string> &channelNames, vector<Statistics> &statistics )
+		:	m_channelNames( channelNames ), m_statistics( statistics )
+	{
+	}
+
+	void operator()( const ImagePlug *imagePlug, const string &channelName, const V2i &tileOrigin, const Statistics &tileStatistics )
+	{
+		const size_t i = find( m_channelNames.begin(), m_channelNames.end(), channelName ) - m_channelNames.begin();
+		m_statistics[i].add( tileStatistics );
+	}
+
+	private :
+
+		const vector<string> &m_channelNames;
+		vector<Statistics> &m_statistics;
+
+};
+
+float defaultValue( int componentIndex )
+{
+	return componentIndex == 3 ? 1.0f : 0.0f;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// ImageStats
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( ImageStats );
 
 size_t ImageStats::g_firstPlugIndex = 0;
@@ -68,6 +215,7 @@ ImageStats::ImageStats( const std::string &name )
 	addChild( new Color4fPlug( "average", Gaffer::Plug::Out ) );
 	addChild( new Color4fPlug( "min", Gaffer::Plug::Out ) );
 	addChild( new Color4fPlug( "max", Gaffer::Plug::Out ) );
+	addChild( new ObjectPlug( "__allStats", Gaffer::Plug::Out, new Color4fVectorData() ) );
 }
 
 ImageStats::~ImageStats()
@@ -134,6 +282,16 @@ const Color4fPlug *ImageStats::maxPlug() const
 	return getChild<Color4fPlug>( g_firstPlugIndex + 5 );
 }
 
+ObjectPlug *ImageStats::allStatsPlug()
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 6 );
+}
+
+const ObjectPlug *ImageStats::allStatsPlug() const
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 6 );
+}
+
 void ImageStats::parentChanging( Gaffer::GraphComponent *newParent )
 {
 	ComputeNode::parentChanging( newParent );
@@ -160,6 +318,10 @@ void ImageStats::affects( const Gaffer::Plug *input, AffectedPlugsContainer &out
 			input->parent<ImagePlug>() == inPlug() ||
 			regionOfInterestPlug()->isAncestorOf( input )
 	   )
+	{
+		outputs.push_back( allStatsPlug() );
+	}
+	else if( input == allStatsPlug() )
 	{
 		for( unsigned int i = 0; i < 4; ++i )
 		{
@@ -167,7 +329,6 @@ void ImageStats::affects( const Gaffer::Plug *input, AffectedPlugsContainer &out
 			outputs.push_back( averagePlug()->getChild(i) );
 			outputs.push_back( maxPlug()->getChild(i) );
 		}
-		return;
 	}
 }
 
@@ -175,167 +336,166 @@ void ImageStats::hash( const ValuePlug *output, const Context *context, IECore::
 {
 	ComputeNode::hash( output, context, h);
 
-	bool earlyOut = true;
-	for( int i = 0; i < 4; ++i )
+	if( output == allStatsPlug() )
 	{
-		if (
-				output == minPlug()->getChild(i) ||
-				output == maxPlug()->getChild(i) ||
-				output == averagePlug()->getChild(i)
-		   )
+		const Box2i regionOfInterest( regionOfInterestPlug()->getValue() );
+		h.append( regionOfInterest );
+		if( empty( regionOfInterest ) )
 		{
-			earlyOut = false;
-			break;
+			return;
 		}
-	}
-	if( earlyOut )
-	{
-		return;
-	}
 
-	const Imath::Box2i regionOfInterest( regionOfInterestPlug()->getValue() );
-	regionOfInterestPlug()->hash( h );
-	inPlug()->channelNamesPlug()->hash( h );
-	inPlug()->dataWindowPlug()->hash( h );
+		const vector<string> channelNames = componentChannelNames();
+		for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+		{
+			h.append( *it );
+		}
 
-	IECore::ConstStringVectorDataPtr channelNamesData = inPlug()->channelNamesPlug()->getValue();
-	std::vector<std::string> maskChannels = channelNamesData->readable();
-	channelsPlug()->maskChannels( maskChannels );
-	const int nChannels( maskChannels.size() );
+		const Box2i dataWindow = inPlug()->dataWindowPlug()->getValue();
+		const Box2i window = intersection( regionOfInterest, dataWindow );
+		h.append( window );
 
-	if ( nChannels > 0 )
-	{
-		std::vector<std::string> uniqueChannels = maskChannels;
-		GafferImage::ChannelMaskPlug::removeDuplicateIndices( uniqueChannels );
-		std::string channel;
-		channelNameFromOutput( output, channel );
+		vector<string> hashChannelNames;
+		for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+		{
+			if( !it->empty() )
+			{
+				hashChannelNames.push_back( *it );
+			}
+		}
 
-		if ( !channel.empty() )
+		if( hashChannelNames.size() && !empty( window ) )
 		{
-			h.append( channel );
-			Sampler s( inPlug(), channel, regionOfInterest );
-			s.hash( h );
-			return;
+			HashTile hashTile;
+			AppendHash appendHash( h );
+			parallelGatherTiles( inPlug(), hashChannelNames, hashTile, appendHash, window, BottomToTop );
 		}
+		return;
 	}
 
-	// If our node is not enabled then we just append the default value that we will give the plug.
-	if(
-			output == maxPlug()->getChild(3) ||
-			output == minPlug()->getChild(3) ||
-			output == averagePlug()->getChild(3)
-	  )
-	{
-		h.append( 0 );
-	}
-	else
+	const GraphComponent *parent = output->parent<GraphComponent>();
+	if( parent == minPlug() || parent == maxPlug() || parent == averagePlug() )
 	{
-		h.append( 1 );
+		allStatsPlug()->hash( h );
 	}
 }
 
-void ImageStats::channelNameFromOutput( const ValuePlug *output, std::string &channelName ) const
+void ImageStats::compute( ValuePlug *output, const Context *context ) const
 {
-	IECore::ConstStringVectorDataPtr channelNamesData = inPlug()->channelNamesPlug()->getValue();
-	std::vector<std::string> maskChannels = channelNamesData->readable();
-	channelsPlug()->maskChannels( maskChannels );
+	if( output == allStatsPlug() )
+	{
+		Color4fVectorDataPtr resultData = new Color4fVectorData;
+		vector<Color4f> &result = resultData->writable();
+		result.resize( 3 );
 
-	/// As the channelMaskPlug allows any combination of channels to be input we need to make sure that
-	/// the channels that it masks each have a distinct channelIndex. Otherwise multiple channels would be
-	/// outputting to the same plug.
-	std::vector<std::string> uniqueChannels = maskChannels;
-	GafferImage::ChannelMaskPlug::removeDuplicateIndices( uniqueChannels );
+		const Box2i regionOfInterest( regionOfInterestPlug()->getValue() );
+		const vector<string> channelNames = empty( regionOfInterest ) ? vector<string>( 4 ) : componentChannelNames();
 
-	for( int channelIndex = 0; channelIndex < 4; ++channelIndex )
-	{
-		if ( output == minPlug()->getChild( channelIndex ) ||
-			 output == maxPlug()->getChild( channelIndex ) ||
-			 output == averagePlug()->getChild( channelIndex )
-		   )
+		vector<string> computeChannelNames;
+		for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+		{
+			if( !it->empty() )
+			{
+				computeChannelNames.push_back( *it );
+			}
+		}
+
+		// Compute the statistics for all channels in a single
+		// parallel pass over the tiles within the region of interest.
+
+		vector<Statistics> statistics( computeChannelNames.size() );
+		const Box2i window = intersection( regionOfInterest, inPlug()->dataWindowPlug()->getValue() );
+		if( computeChannelNames.size() && !empty( window ) )
+		{
+			TileStatistics tileStatistics( window );
+			AccumulateStatistics accumulateStatistics( computeChannelNames, statistics );
+			parallelGatherTiles( inPlug(), computeChannelNames, tileStatistics, accumulateStatistics, window, BottomToTop );
+		}
+
+		// Pixels within the region of interest but outside the
+		// data window have a value of 0.
+
+		const bool outsideDataWindow = window.size() != regionOfInterest.size() || empty( window );
+		if( outsideDataWindow )
+		{
+			for( vector<Statistics>::iterator it = statistics.begin(), eIt = statistics.end(); it != eIt; ++it )
+			{
+				it->add( 0.0f );
+			}
+		}
+
+		const double numPixels = double( regionOfInterest.size().x ) * double( regionOfInterest.size().y );
+		for( int i = 0; i < 4; ++i )
 		{
-			for( std::vector<std::string>::iterator it( uniqueChannels.begin() ); it != uniqueChannels.end(); ++it )
+			vector<string>::const_iterator it = find( computeChannelNames.begin(), computeChannelNames.end(), channelNames[i] );
+			if( channelNames[i].empty() || it == computeChannelNames.end() )
 			{
-				if ( colorIndex( *it ) == channelIndex )
-				{
-					channelName = *it;
-					return;
-				}
+				result[0][i] = result[1][i] = result[2][i] = defaultValue( i );
+				continue;
 			}
+
+			const Statistics &s = statistics[it - computeChannelNames.begin()];
+			result[0][i] = s.min;
+			result[1][i] = s.max;
+			result[2][i] = s.sum / numPixels;
 		}
+
+		static_cast<ObjectPlug *>( output )->setValue( resultData );
+		return;
 	}
-	return;
-}
 
-void ImageStats::setOutputToDefault( FloatPlug *output ) const
-{
-	if (
-			output == minPlug()->getChild(3) ||
-			output == maxPlug()->getChild(3) ||
-			output == averagePlug()->getChild(3)
-	   )
+	const GraphComponent *parent = output->parent<GraphComponent>();
+	int statisticIndex = -1;
+	if( parent == minPlug() )
 	{
-		output->setValue( 1. );
+		statisticIndex = 0;
 	}
-	else
+	else if( parent == maxPlug() )
 	{
-		output->setValue( 0. );
+		statisticIndex = 1;
 	}
-}
-
-void ImageStats::compute( ValuePlug *output, const Context *context ) const
-{
-	const Imath::Box2i &regionOfInterest( regionOfInterestPlug()->getValue() );
-	if( regionOfInterest.isEmpty() )
+	else if( parent == averagePlug() )
 	{
-		setOutputToDefault( static_cast<FloatPlug*>( output ) );
-		return;
+		statisticIndex = 2;
 	}
 
-	std::string channelName;
-	channelNameFromOutput( output, channelName );
-	if ( channelName.empty() )
+	if( statisticIndex >= 0 )
 	{
-		setOutputToDefault( static_cast<FloatPlug*>( output ) );
-		return;
+		ConstColor4fVectorDataPtr allStats = boost::static_pointer_cast<const Color4fVectorData>( allStatsPlug()->getValue() );
+		for( int i = 0; i < 4; ++i )
+		{
+			if( parent->getChild<ValuePlug>( i ) == output )
+			{
+				static_cast<FloatPlug *>( output )->setValue( allStats->readable()[statisticIndex][i] );
+				return;
+			}
+		}
 	}
 
-	const int channelIndex = colorIndex( channelName );
+	ComputeNode::compute( output, context );
+}
 
-	// Loop over the ROI and compute the min, max and average channel values and then set our outputs.
-	Sampler s( inPlug(), channelName, regionOfInterest );
+std::vector<std::string> ImageStats::componentChannelNames() const
+{
+	vector<string> result( 4 );
 
-	float min = Imath::limits<float>::max();
-	float max = Imath::limits<float>::min();
+	IECore::ConstStringVectorDataPtr channelNamesData = inPlug()->channelNamesPlug()->getValue();
+	std::vector<std::string> maskChannels = channelNamesData->readable();
+	channelsPlug()->maskChannels( maskChannels );
 
-	float average = 0.f;
+	/// As the channelMaskPlug allows any combination of channels to be input we need to make sure that
+	/// the channels that it masks each have a distinct channelIndex. Otherwise multiple channels would be
+	/// outputting to the same plug.
+	GafferImage::ChannelMaskPlug::removeDuplicateIndices( maskChannels );
 
-	double sum = 0.;
-	for( int y = regionOfInterest.min.y; y < regionOfInterest.max.y; ++y )
+	for( std::vector<std::string>::const_iterator it = maskChannels.begin(), eIt = maskChannels.end(); it != eIt; ++it )
 	{
-		for( int x = regionOfInterest.min.x; x < regionOfInterest.max.x; ++x )
+		const int channelIndex = colorIndex( *it );
+		if( channelIndex >= 0 && result[channelIndex].empty() )
 		{
-			float v = s.sample( x, y );
-			min = std::min( v, min );
-			max = std::max( v, max );
-			sum += v;
+			result[channelIndex] = *it;
 		}
 	}
-	average = sum / double( (regionOfInterest.size().x) * (regionOfInterest.size().y) );
 
-	if ( minPlug()->getChild( channelIndex ) == output )
-	{
-		static_cast<FloatPlug *>( output )->setValue( min );
-	}
-	else if ( maxPlug()->getChild( channelIndex ) == output )
-	{
-		static_cast<FloatPlug *>( output )->setValue( max );
-	}
-	else if ( averagePlug()->getChild( channelIndex ) == output )
-	{
-		static_cast<FloatPlug *>( output )->setValue( average );
-	}
-	else
-	{
-		static_cast<FloatPlug *>( output )->setValue( 0 );
-	}
+	return result;
 }
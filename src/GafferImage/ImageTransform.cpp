@@ -44,6 +44,7 @@
 #include "GafferImage/ImagePlug.h"
 #include "GafferImage/Sampler.h"
 #include "GafferImage/Resample.h"
+#include "GafferImage/ImageAlgo.h"
 
 using namespace Imath;
 using namespace IECore;
@@ -103,14 +104,22 @@ ImageTransform::ImageTransform( const std::string &name )
 	// sampling of the translate and scale in one. Then,
 	// if we also have a rotation component we sample that
 	// from the intermediate result in computeChannelData().
+	// The translate and scale of any transforms upstream
+	// are concatenated into the same Resample, which reads
+	// from the head of the chain via concatenatedInPlug().
 
 	addChild( new AtomicBox2fPlug( "__resampleDataWindow", Plug::Out ) );
 	addChild( new ImagePlug( "__resampledIn", Plug::In, Plug::Default & ~Plug::Serialisable ) );
+	addChild( new ImagePlug( "__concatenatedIn", Plug::Out, Plug::Default & ~Plug::Serialisable ) );
 
 	ResamplePtr resample = new Resample( "__resample" );
 	addChild( resample );
 
-	resample->inPlug()->setInput( inPlug() );
+	concatenatedInPlug()->formatPlug()->setInput( inPlug()->formatPlug() );
+	concatenatedInPlug()->metadataPlug()->setInput( inPlug()->metadataPlug() );
+	concatenatedInPlug()->channelNamesPlug()->setInput( inPlug()->channelNamesPlug() );
+
+	resample->inPlug()->setInput( concatenatedInPlug() );
 	resample->filterPlug()->setInput( filterPlug() );
 	resample->dataWindowPlug()->setInput( resampleDataWindowPlug() );
 	resampledInPlug()->setInput( resample->outPlug() );
@@ -165,20 +174,47 @@ const ImagePlug *ImageTransform::resampledInPlug() const
 	return getChild<ImagePlug>( g_firstPlugIndex + 3 );
 }
 
+ImagePlug *ImageTransform::concatenatedInPlug()
+{
+	return getChild<ImagePlug>( g_firstPlugIndex + 4 );
+}
+
+const ImagePlug *ImageTransform::concatenatedInPlug() const
+{
+	return getChild<ImagePlug>( g_firstPlugIndex + 4 );
+}
+
 Resample *ImageTransform::resample()
 {
-	return getChild<Resample>( g_firstPlugIndex + 4 );
+	return getChild<Resample>( g_firstPlugIndex + 5 );
 }
 
 const Resample *ImageTransform::resample() const
 {
-	return getChild<Resample>( g_firstPlugIndex + 4 );
+	return getChild<Resample>( g_firstPlugIndex + 5 );
+}
+
+Imath::M33f ImageTransform::matrix() const
+{
+	M33f matrix, resampleMatrix;
+	operation( matrix, resampleMatrix );
+	return matrix;
 }
 
 void ImageTransform::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ImageProcessor::affects( input, outputs );
 
+	if( input == inPlug()->dataWindowPlug() || input == enabledPlug() )
+	{
+		outputs.push_back( concatenatedInPlug()->dataWindowPlug() );
+	}
+
+	if( input == inPlug()->channelDataPlug() || input == enabledPlug() )
+	{
+		outputs.push_back( concatenatedInPlug()->channelDataPlug() );
+	}
+
 	if(
 		input == inPlug()->dataWindowPlug() ||
 		input->parent<Plug>() == transformPlug()->translatePlug() ||
@@ -216,7 +252,9 @@ void ImageTransform::hash( const ValuePlug *output, const Context *context, IECo
 
 	if( output == resampleDataWindowPlug() )
 	{
-		inPlug()->dataWindowPlug()->hash( h );
+		M33f inputMatrix;
+		concatenatedTransformInput( inPlug(), inputMatrix )->dataWindowPlug()->hash( h );
+		h.append( inputMatrix );
 		transformPlug()->translatePlug()->hash( h );
 		transformPlug()->scalePlug()->hash( h );
 		transformPlug()->pivotPlug()->hash( h );
@@ -227,10 +265,11 @@ void ImageTransform::compute( ValuePlug *output, const Context *context ) const
 {
 	if( output == resampleDataWindowPlug() )
 	{
-		const Box2i in = inPlug()->dataWindowPlug()->getValue();
+		M33f inputMatrix;
+		const Box2i in = concatenatedTransformInput( inPlug(), inputMatrix )->dataWindowPlug()->getValue();
 		M33f matrix, resampleMatrix;
 		operation( matrix, resampleMatrix );
-		const Box2f out = transform( Box2f( in.min, in.max ), resampleMatrix );
+		const Box2f out = transform( Box2f( in.min, in.max ), inputMatrix * resampleMatrix );
 		static_cast<AtomicBox2fPlug *>( output )->setValue( out );
 	}
 
@@ -239,6 +278,13 @@ void ImageTransform::compute( ValuePlug *output, const Context *context ) const
 
 void ImageTransform::hashDataWindow( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
+	if( parent == concatenatedInPlug() )
+	{
+		M33f inputMatrix;
+		h = concatenatedTransformInput( inPlug(), inputMatrix )->dataWindowPlug()->hash();
+		return;
+	}
+
 	M33f matrix, resampleMatrix;
 	const unsigned op = operation( matrix, resampleMatrix );
 	if( !(op & Rotate) )
@@ -255,6 +301,12 @@ void ImageTransform::hashDataWindow( const GafferImage::ImagePlug *parent, const
 
 Imath::Box2i ImageTransform::computeDataWindow( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
+	if( parent == concatenatedInPlug() )
+	{
+		M33f inputMatrix;
+		return concatenatedTransformInput( inPlug(), inputMatrix )->dataWindowPlug()->getValue();
+	}
+
 	M33f matrix, resampleMatrix;
 	const unsigned op = operation( matrix, resampleMatrix );
 	if( !(op & Rotate) )
@@ -270,6 +322,13 @@ Imath::Box2i ImageTransform::computeDataWindow( const Gaffer::Context *context,
 
 void ImageTransform::hashChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
+	if( parent == concatenatedInPlug() )
+	{
+		M33f inputMatrix;
+		h = concatenatedTransformInput( inPlug(), inputMatrix )->channelDataPlug()->hash();
+		return;
+	}
+
 	M33f matrix, resampleMatrix;
 	const unsigned op = operation( matrix, resampleMatrix );
 	if( !(op & Rotate) )
@@ -297,6 +356,12 @@ void ImageTransform::hashChannelData( const GafferImage::ImagePlug *parent, cons
 
 IECore::ConstFloatVectorDataPtr ImageTransform::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
 {
+	if( parent == concatenatedInPlug() )
+	{
+		M33f inputMatrix;
+		return concatenatedTransformInput( inPlug(), inputMatrix )->channelDataPlug()->getValue();
+	}
+
 	M33f matrix, resampleMatrix;
 	const unsigned op = operation( matrix, resampleMatrix );
 	if( !(op & Rotate) )
@@ -374,7 +439,11 @@ Imath::Box2i ImageTransform::sampler( unsigned op, const Imath::M33f &matrix, co
 {
 	assert( op & Rotate );
 
-	if( op & ( Scale | Translate ) )
+	// If we're scaling or translating, or have upstream transforms concatenated
+	// into the internal Resample, then we rotate the resampled image. Otherwise
+	// we can sample the input directly and avoid filtering twice.
+	M33f inputMatrix;
+	if( op & ( Scale | Translate ) || concatenatedTransformInput( inPlug(), inputMatrix ) != inPlug() )
 	{
 		samplerImage = resampledInPlug();
 		samplerMatrix = matrix.inverse() * resampleMatrix;
@@ -64,6 +64,43 @@ float opSubtract( float A, float B, float a, float b){ return A - B; }
 float opDifference( float A, float B, float a, float b){ return fabs( A - B ); }
 float opUnder( float A, float B, float a, float b){ return A*(1.-b) + B; }
 
+// Sets the pixels of the tile which are outside validBound to 0.
+void maskInvalid( float *B, const Box2i &tileBound, const Box2i &validBound )
+{
+	for( int y = tileBound.min.y; y < tileBound.max.y; ++y )
+	{
+		const bool yValid = y >= validBound.min.y && y < validBound.max.y;
+		for( int x = tileBound.min.x; x < tileBound.max.x; ++x )
+		{
+			if( !yValid || x < validBound.min.x || x >= validBound.max.x )
+			{
+				*B = 0.0f;
+			}
+			++B;
+		}
+	}
+}
+
+// Composites the tile A with alpha a onto the tile B with alpha b, treating
+// pixels outside validBound as black. B and b may refer to the same tile,
+// which is how the intermediate alpha is itself composited.
+template<typename F>
+void composite( F f, const float *A, float *B, const float *a, const float *b, const Box2i &tileBound, const Box2i &validBound )
+{
+	for( int y = tileBound.min.y; y < tileBound.max.y; ++y )
+	{
+		const bool yValid = y >= validBound.min.y && y < validBound.max.y;
+		for( int x = tileBound.min.x; x < tileBound.max.x; ++x )
+		{
+			const bool valid = yValid && x >= validBound.min.x && x < validBound.max.x;
+
+			*B = f( valid ? *A : 0.0f, *B, valid ? *a : 0.0f, *b );
+
+			++A; ++B; ++a; ++b;
+		}
+	}
+}
+
 } // namespace
 
 IE_CORE_DEFINERUNTIMETYPED( Merge );
@@ -84,6 +121,8 @@ Merge::Merge( const std::string &name )
 		)
 	);
 
+	addChild( new ObjectPlug( "__mergedData", Gaffer::Plug::Out, new ObjectVector ) );
+
 	// We don't ever want to change these, so we make pass-through connections.
 	outPlug()->formatPlug()->setInput( inPlug()->formatPlug() );
 	outPlug()->metadataPlug()->setInput( inPlug()->metadataPlug() );
@@ -103,11 +142,25 @@ const Gaffer::IntPlug *Merge::operationPlug() const
 	return getChild<IntPlug>( g_firstPlugIndex );
 }
 
+Gaffer::ObjectPlug *Merge::mergedDataPlug()
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 1 );
+}
+
+const Gaffer::ObjectPlug *Merge::mergedDataPlug() const
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 1 );
+}
+
 void Merge::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ImageProcessor::affects( input, outputs );
 
 	if( input == operationPlug() )
+	{
+		outputs.push_back( mergedDataPlug() );
+	}
+	else if( input == mergedDataPlug() )
 	{
 		outputs.push_back( outPlug()->channelDataPlug() );
 	}
@@ -115,7 +168,14 @@ void Merge::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs
 	{
 		if( inputImage->parent<ArrayPlug>() == inPlugs() )
 		{
-			outputs.push_back( outPlug()->getChild<ValuePlug>( input->getName() ) );
+			if( input != inputImage->formatPlug() && input != inputImage->metadataPlug() )
+			{
+				outputs.push_back( mergedDataPlug() );
+			}
+			if( input != inputImage->channelDataPlug() )
+			{
+				outputs.push_back( outPlug()->getChild<ValuePlug>( input->getName() ) );
+			}
 		}
 	}
 }
@@ -184,14 +244,26 @@ IECore::ConstStringVectorDataPtr Merge::computeChannelNames( const Gaffer::Conte
 	return inPlug()->channelNamesPlug()->defaultValue();
 }
 
-void Merge::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+void Merge::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
-	ImageProcessor::hashChannelData( output, context, h );
+	ImageProcessor::hash( output, context, h );
+
+	if( output != mergedDataPlug() )
+	{
+		return;
+	}
+
+	std::vector<std::string> channelNames;
+	mergedChannelNames( context->get<std::string>( ImagePlug::channelNameContextName ), channelNames );
 
-	const std::string channelName = context->get<std::string>( ImagePlug::channelNameContextName );
 	const V2i tileOrigin = context->get<V2i>( ImagePlug::tileOriginContextName );
 	const Box2i tileBound( tileOrigin, tileOrigin + V2i( ImagePlug::tileSize() ) );
 
+	for( std::vector<std::string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+	{
+		h.append( *it );
+	}
+
 	for( ImagePlugIterator it( inPlugs() ); !it.done(); ++it )
 	{
 		if( !(*it)->getInput<ValuePlug>() )
@@ -199,19 +271,26 @@ void Merge::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer:
 			continue;
 		}
 
-		IECore::ConstStringVectorDataPtr channelNamesData = (*it)->channelNamesPlug()->getValue();
-		const std::vector<std::string> &channelNames = channelNamesData->readable();
+		IECore::ConstStringVectorDataPtr inChannelNamesData = (*it)->channelNamesPlug()->getValue();
+		const std::vector<std::string> &inChannelNames = inChannelNamesData->readable();
 
-		if( channelExists( channelNames, channelName ) )
+		std::vector<std::string> existingChannelNames;
+		for( std::vector<std::string>::const_iterator cIt = channelNames.begin(), eIt = channelNames.end(); cIt != eIt; ++cIt )
 		{
-			(*it)->channelDataPlug()->hash( h );
+			if( channelExists( inChannelNames, *cIt ) )
+			{
+				existingChannelNames.push_back( *cIt );
+				h.append( *cIt );
+			}
 		}
 
-		if( channelExists( channelNames, "A" ) )
+		if( channelExists( inChannelNames, "A" ) )
 		{
-			h.append( (*it)->channelDataHash( "A", tileOrigin ) );
+			existingChannelNames.push_back( "A" );
 		}
 
+		h.append( (*it)->channelDataHash( existingChannelNames, tileOrigin ) );
+
 		// The hash of the channel data we include above represents just the data in
 		// the tile itself, and takes no account of the possibility that parts of the
 		// tile may be outside of the data window. This simplifies the implementation of
@@ -220,8 +299,8 @@ void Merge::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer:
 		// matter, because they don't change the data window, or they use a Sampler to
 		// deal with invalid pixels. But because our data window is the union of all
 		// input data windows, we may be using/revealing the invalid parts of a tile. We
-		// deal with this in computeChannelData() by treating the invalid parts as black,
-		// and must therefore hash in the valid bound here to take that into account.
+		// deal with this in merge() by treating the invalid parts as black, and must
+		// therefore hash in the valid bound here to take that into account.
 		const Box2i validBound = boxIntersection( tileBound, (*it)->dataWindowPlug()->getValue() );
 		h.append( validBound );
 	}
@@ -229,48 +308,151 @@ void Merge::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer:
 	operationPlug()->hash( h );
 }
 
-IECore::ConstFloatVectorDataPtr Merge::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
+void Merge::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
 {
+	if( output != mergedDataPlug() )
+	{
+		ImageProcessor::compute( output, context );
+		return;
+	}
+
+	std::vector<std::string> channelNames;
+	mergedChannelNames( context->get<std::string>( ImagePlug::channelNameContextName ), channelNames );
+	const V2i tileOrigin = context->get<V2i>( ImagePlug::tileOriginContextName );
+
+	ObjectVectorPtr result;
 	switch( operationPlug()->getValue() )
 	{
 		case Add :
-			return merge( opAdd, channelName, tileOrigin);
+			result = merge( opAdd, channelNames, tileOrigin );
+			break;
 		case Atop :
-			return merge( opAtop, channelName, tileOrigin);
+			result = merge( opAtop, channelNames, tileOrigin );
+			break;
 		case Divide :
-			return merge( opDivide, channelName, tileOrigin);
+			result = merge( opDivide, channelNames, tileOrigin );
+			break;
 		case In :
-			return merge( opIn, channelName, tileOrigin);
+			result = merge( opIn, channelNames, tileOrigin );
+			break;
 		case Out :
-			return merge( opOut, channelName, tileOrigin);
+			result = merge( opOut, channelNames, tileOrigin );
+			break;
 		case Mask :
-			return merge( opMask, channelName, tileOrigin);
+			result = merge( opMask, channelNames, tileOrigin );
+			break;
 		case Matte :
-			return merge( opMatte, channelName, tileOrigin);
+			result = merge( opMatte, channelNames, tileOrigin );
+			break;
 		case Multiply :
-			return merge( opMultiply, channelName, tileOrigin);
+			result = merge( opMultiply, channelNames, tileOrigin );
+			break;
 		case Over :
-			return merge( opOver, channelName, tileOrigin);
+			result = merge( opOver, channelNames, tileOrigin );
+			break;
 		case Subtract :
-			return merge( opSubtract, channelName, tileOrigin);
+			result = merge( opSubtract, channelNames, tileOrigin );
+			break;
 		case Difference :
-			return merge( opDifference, channelName, tileOrigin);
+			result = merge( opDifference, channelNames, tileOrigin );
+			break;
 		case Under :
-			return merge( opUnder, channelName, tileOrigin);
+			result = merge( opUnder, channelNames, tileOrigin );
+			break;
+		default :
+			throw Exception( "Merge::compute : Invalid operation mode." );
+	}
+
+	static_cast<ObjectPlug *>( output )->setValue( result );
+}
+
+Gaffer::ValuePlug::CachePolicy Merge::computeCachePolicy( const Gaffer::ValuePlug *output ) const
+{
+	if( output == outPlug()->channelDataPlug() )
+	{
+		// We just extract the channel from mergedDataPlug(), which is
+		// cached, so it is quicker not to cache the result.
+		return ValuePlug::Uncached;
+	}
+	return ImageProcessor::computeCachePolicy( output );
+}
+
+void Merge::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	ImageProcessor::hashChannelData( output, context, h );
+
+	const std::string &channelName = context->get<std::string>( ImagePlug::channelNameContextName );
+	std::vector<std::string> channelNames;
+	mergedChannelNames( channelName, channelNames );
+
+	h.append( channelName );
+
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	Context::Scope scopedContext( tmpContext.get() );
+	tmpContext->set( ImagePlug::channelNameContextName, channelNames.front() );
+	mergedDataPlug()->hash( h );
+}
+
+IECore::ConstFloatVectorDataPtr Merge::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
+{
+	std::vector<std::string> channelNames;
+	mergedChannelNames( channelName, channelNames );
+
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	Context::Scope scopedContext( tmpContext.get() );
+	tmpContext->set( ImagePlug::channelNameContextName, channelNames.front() );
+
+	ConstObjectVectorPtr mergedData = boost::static_pointer_cast<const ObjectVector>( mergedDataPlug()->getValue() );
+	const size_t index = std::find( channelNames.begin(), channelNames.end(), channelName ) - channelNames.begin();
+	return boost::static_pointer_cast<const FloatVectorData>( mergedData->members()[index] );
+}
+
+void Merge::mergedChannelNames( const std::string &channelName, std::vector<std::string> &channelNames ) const
+{
+	channelNames.clear();
+
+	if( layerName( channelName ).empty() && colorIndex( channelName ) != -1 )
+	{
+		// Only include the RGBA channels which actually exist, so
+		// that we don't waste time merging black tiles.
+		IECore::ConstStringVectorDataPtr outChannelNamesData = outPlug()->channelNamesPlug()->getValue();
+		const std::vector<std::string> &outChannelNames = outChannelNamesData->readable();
+
+		static const char *rgba[] = { "R", "G", "B", "A" };
+		for( size_t i = 0; i < 4; ++i )
+		{
+			if( channelExists( outChannelNames, rgba[i] ) )
+			{
+				channelNames.push_back( rgba[i] );
+			}
+		}
+
+		if( std::find( channelNames.begin(), channelNames.end(), channelName ) != channelNames.end() )
+		{
+			return;
+		}
+
+		channelNames.clear();
 	}
 
-	throw Exception( "Merge::computeChannelData : Invalid operation mode." );
+	channelNames.push_back( channelName );
 }
 
 template<typename F>
-IECore::ConstFloatVectorDataPtr Merge::merge( F f, const std::string &channelName, const Imath::V2i &tileOrigin ) const
+IECore::ObjectVectorPtr Merge::merge( F f, const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin ) const
 {
-	FloatVectorDataPtr resultData = NULL;
+	const size_t numChannels = channelNames.size();
+
+	std::vector<FloatVectorDataPtr> resultData;
 	// Temporary buffer for computing the alpha of intermediate composited layers.
 	FloatVectorDataPtr resultAlphaData = NULL;
 
 	const Box2i tileBound( tileOrigin, tileOrigin + V2i( ImagePlug::tileSize() ) );
 
+	std::vector<std::string> inChannelNames;
+	std::vector<ConstFloatVectorDataPtr> inChannelData;
+	std::vector<ConstFloatVectorDataPtr> channelData( numChannels );
+
 	for( ImagePlugIterator it( inPlugs() ); !it.done(); ++it )
 	{
 		if( !(*it)->getInput<ValuePlug>() )
@@ -278,33 +460,45 @@ IECore::ConstFloatVectorDataPtr Merge::merge( F f, const std::string &channelNam
 			continue;
 		}
 
-		IECore::ConstStringVectorDataPtr channelNamesData = (*it)->channelNamesPlug()->getValue();
-		const std::vector<std::string> &channelNames = channelNamesData->readable();
+		IECore::ConstStringVectorDataPtr existingChannelNamesData = (*it)->channelNamesPlug()->getValue();
+		const std::vector<std::string> &existingChannelNames = existingChannelNamesData->readable();
 
-		ConstFloatVectorDataPtr channelData;
-		ConstFloatVectorDataPtr alphaData;
+		// Fetch all the channels we need from this input in one go,
+		// substituting black for any that don't exist.
 
-		if( channelExists( channelNames, channelName ) )
+		inChannelNames.clear();
+		for( size_t i = 0; i < numChannels; ++i )
 		{
-			channelData = (*it)->channelDataPlug()->getValue();
+			if( channelExists( existingChannelNames, channelNames[i] ) )
+			{
+				inChannelNames.push_back( channelNames[i] );
+			}
 		}
-		else
+		const bool alphaExists = channelExists( existingChannelNames, "A" );
+		if( alphaExists )
 		{
-			channelData = ImagePlug::blackTile();
+			inChannelNames.push_back( "A" );
 		}
 
-		if( channelExists( channelNames, "A" ) )
-		{
-			alphaData = (*it)->channelData( "A", tileOrigin );
-		}
-		else
+		(*it)->channelData( inChannelNames, tileOrigin, inChannelData );
+
+		std::vector<ConstFloatVectorDataPtr>::const_iterator inIt = inChannelData.begin();
+		for( size_t i = 0; i < numChannels; ++i )
 		{
-			alphaData = ImagePlug::blackTile();
+			if( channelExists( existingChannelNames, channelNames[i] ) )
+			{
+				channelData[i] = *inIt++;
+			}
+			else
+			{
+				channelData[i] = ImagePlug::blackTile();
+			}
 		}
+		ConstFloatVectorDataPtr alphaData = alphaExists ? *inIt : ConstFloatVectorDataPtr( ImagePlug::blackTile() );
 
 		const Box2i validBound = boxIntersection( tileBound, (*it)->dataWindowPlug()->getValue() );
 
-		if( !resultData )
+		if( !resultAlphaData )
 		{
 			// The first connected layer, with which we must initialise our result.
 			// There's no guarantee that this layer actually covers the full data
@@ -316,46 +510,43 @@ IECore::ConstFloatVectorDataPtr Merge::merge( F f, const std::string &channelNam
 			/// the operation for in[1:], even if in[0] is disconnected. In other
 			/// words, shouldn't multiplying a white constant over an unconnected
 			/// in[0] produce black?
-			resultData = channelData->copy();
 			resultAlphaData = alphaData->copy();
-			float *B = &resultData->writable().front();
-			float *b = &resultAlphaData->writable().front();
-			for( int y = tileBound.min.y; y < tileBound.max.y; ++y )
+			maskInvalid( &resultAlphaData->writable().front(), tileBound, validBound );
+			for( size_t i = 0; i < numChannels; ++i )
 			{
-				const bool yValid = y >= validBound.min.y && y < validBound.max.y;
-				for( int x = tileBound.min.x; x < tileBound.max.x; ++x )
-				{
-					if( !yValid || x < validBound.min.x || x >= validBound.max.x )
-					{
-						*B = *b = 0.0f;
-					}
-					++B; ++b;
-				}
+				resultData.push_back( channelData[i]->copy() );
+				maskInvalid( &resultData[i]->writable().front(), tileBound, validBound );
 			}
 		}
 		else
 		{
 			// A higher layer (A) which must be composited over the result (B).
-			const float *A = &channelData->readable().front();
-			float *B = &resultData->writable().front();
+			// All channels are composited using the alpha from the result so
+			// far, and only then is that alpha itself updated.
 			const float *a = &alphaData->readable().front();
 			float *b = &resultAlphaData->writable().front();
 
-			for( int y = tileBound.min.y; y < tileBound.max.y; ++y )
+			for( size_t i = 0; i < numChannels; ++i )
 			{
-				const bool yValid = y >= validBound.min.y && y < validBound.max.y;
-				for( int x = tileBound.min.x; x < tileBound.max.x; ++x )
-				{
-					const bool valid = yValid && x >= validBound.min.x && x < validBound.max.x;
+				composite( f, &channelData[i]->readable().front(), &resultData[i]->writable().front(), a, b, tileBound, validBound );
+			}
 
-					*B = f( valid ? *A : 0.0f, *B, valid ? *a : 0.0f, *b );
-					*b = f( valid ? *a : 0.0f, *b, valid ? *a : 0.0f, *b );
+			composite( f, a, b, a, b, tileBound, validBound );
+		}
+	}
 
-					++A; ++B; ++a; ++b;
-				}
-			}
+	ObjectVectorPtr result = new ObjectVector;
+	for( size_t i = 0; i < numChannels; ++i )
+	{
+		if( resultData.size() )
+		{
+			result->members().push_back( resultData[i] );
+		}
+		else
+		{
+			result->members().push_back( ImagePlug::blackTile()->copy() );
 		}
 	}
 
-	return resultData;
+	return result;
 }
@@ -40,6 +40,7 @@
 #include "IECore/SimpleTypedData.h"
 
 #include "Gaffer/Context.h"
+#include "Gaffer/Private/IECorePreview/LRUCache.h"
 
 #include "GafferImage/OpenColorIOTransform.h"
 
@@ -57,7 +58,8 @@ namespace
 // but still do the actual processing in parallel - this seems to
 // have negligible performance impact but a nice not-crashing impact.
 // On other platforms we use a null_mutex so there should be no
-// performance impact at all.
+// performance impact at all. Since processors are cached, the lock
+// is only taken when a new processor is required.
 #ifdef __APPLE__
 typedef tbb::mutex OCIOMutex;
 #else
@@ -68,6 +70,104 @@ static OCIOMutex g_ocioMutex;
 
 } // namespace
 
+//////////////////////////////////////////////////////////////////////////
+// ProcessorCache
+//////////////////////////////////////////////////////////////////////////
+
+// Creating an OpenColorIO Processor is expensive - it may load LUT files
+// from disk and will always build and optimise a list of operations. We
+// therefore cache processors, indexed by the hash of the transform and the
+// cache id of the config that created them. Each tile then only needs a
+// lookup in the cache, which is shared between all threads.
+class OpenColorIOTransform::ProcessorCache
+{
+
+	public :
+
+		static OpenColorIO::ConstProcessorRcPtr get( const OpenColorIOTransform *node, const Gaffer::Context *context )
+		{
+			OpenColorIO::ConstConfigRcPtr config = OpenColorIO::GetCurrentConfig();
+
+			// Different node types may hash their plugs identically,
+			// so we include the type to tell their transforms apart.
+			MurmurHash h;
+			h.append( node->typeId() );
+			node->hashTransform( context, h );
+			h.append( config->getCacheID() );
+
+			const Key key( node, config.get(), h );
+			try
+			{
+				return g_cache.get( key );
+			}
+			catch( ... )
+			{
+				// The cache would otherwise remember the failure and
+				// report it with a generic message on subsequent calls.
+				// Erasing the entry means that every call reports the
+				// original error from OpenColorIO.
+				g_cache.erase( key );
+				throw;
+			}
+		}
+
+	private :
+
+		// As with the ShadingEngine cache in GafferOSL, the key holds
+		// pointers to the node and config so that the getter can create
+		// the processor, but only the hash is used for comparison. The
+		// pointers are only valid for the duration of the call to get().
+		struct Key
+		{
+
+			Key( const OpenColorIOTransform *node, const OpenColorIO::Config *config, const MurmurHash &hash )
+				:	node( node ), config( config ), hash( hash )
+			{
+			}
+
+			bool operator == ( const Key &other ) const
+			{
+				return hash == other.hash;
+			}
+
+			friend size_t hash_value( const Key &key )
+			{
+				return boost::hash<MurmurHash>()( key.hash );
+			}
+
+			const OpenColorIOTransform *node;
+			const OpenColorIO::Config *config;
+			MurmurHash hash;
+
+		};
+
+		static OpenColorIO::ConstProcessorRcPtr getter( const Key &key, size_t &cost )
+		{
+			cost = 1;
+
+			OpenColorIO::ConstTransformRcPtr colorTransform = key.node->transform();
+			if( !colorTransform )
+			{
+				return OpenColorIO::ConstProcessorRcPtr();
+			}
+
+			OCIOMutex::scoped_lock lock( g_ocioMutex );
+			return key.config->getProcessor( colorTransform );
+		}
+
+		// Each cache entry is given a cost of 1, so the maximum cost of
+		// the cache is simply the maximum number of processors.
+		typedef IECorePreview::LRUCache<Key, OpenColorIO::ConstProcessorRcPtr> Cache;
+		static Cache g_cache;
+
+};
+
+OpenColorIOTransform::ProcessorCache::Cache OpenColorIOTransform::ProcessorCache::g_cache( getter, 1000 );
+
+//////////////////////////////////////////////////////////////////////////
+// OpenColorIOTransform
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( OpenColorIOTransform );
 
 OpenColorIOTransform::OpenColorIOTransform( const std::string &name )
@@ -110,19 +210,12 @@ void OpenColorIOTransform::hashColorData( const Gaffer::Context *context, IECore
 
 void OpenColorIOTransform::processColorData( const Gaffer::Context *context, IECore::FloatVectorData *r, IECore::FloatVectorData *g, IECore::FloatVectorData *b ) const
 {
-	OpenColorIO::ConstTransformRcPtr colorTransform = transform();
-	if( !colorTransform )
+	OpenColorIO::ConstProcessorRcPtr processor = this->processor( context );
+	if( !processor )
 	{
 		return;
 	}
 
-	OpenColorIO::ConstProcessorRcPtr processor;
-	{
-		OCIOMutex::scoped_lock lock( g_ocioMutex );
-		OpenColorIO::ConstConfigRcPtr config = OpenColorIO::GetCurrentConfig();
-		processor = config->getProcessor( colorTransform );
-	}
-
 	OpenColorIO::PlanarImageDesc image(
 		r->baseWritable(),
 		g->baseWritable(),
@@ -135,6 +228,11 @@ void OpenColorIOTransform::processColorData( const Gaffer::Context *context, IEC
 	processor->apply( image );
 }
 
+OpenColorIO::ConstProcessorRcPtr OpenColorIOTransform::processor( const Gaffer::Context *context ) const
+{
+	return ProcessorCache::get( this, context );
+}
+
 void OpenColorIOTransform::availableColorSpaces( std::vector<std::string> &colorSpaces )
 {
 	OpenColorIO::ConstConfigRcPtr config = OpenColorIO::GetCurrentConfig();
@@ -672,6 +672,18 @@ IECore::ConstFloatVectorDataPtr OpenImageIOReader::computeChannelData( const std
 	return resultData;
 }
 
+Gaffer::ValuePlug::CachePolicy OpenImageIOReader::computeCachePolicy( const Gaffer::ValuePlug *output ) const
+{
+	if( output == outPlug()->channelDataPlug() )
+	{
+		// The OpenImageIO cache already holds the tiles, typically at half
+		// precision for EXR files, so storing float copies as well would
+		// just use up memory. ImageReader caches a compact copy itself.
+		return Gaffer::ValuePlug::Uncached;
+	}
+	return ImageNode::computeCachePolicy( output );
+}
+
 size_t OpenImageIOReader::getCacheMemoryLimit()
 {
 	float memoryLimit;
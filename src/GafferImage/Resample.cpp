@@ -35,12 +35,16 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include <algorithm>
 
 #include "OpenImageIO/fmath.h"
 #include "OpenImageIO/filter.h"
 
+#include "boost/functional/hash.hpp"
+
 #include "Gaffer/Context.h"
 #include "Gaffer/StringPlug.h"
+#include "Gaffer/Private/IECorePreview/LRUCache.h"
 
 #include "GafferImage/Resample.h"
 #include "GafferImage/Sampler.h"
@@ -247,32 +251,155 @@ Filter2DPtr createFilter( const std::string &name, const V2f &filterWidth, const
 	throw Exception( boost::str( boost::format( "Unknown filter \"%s\"" ) % filterName ) );
 }
 
-// Precomputes all the filter weights for a whole row or column of a tile. For separable
-// filters these weights can then be reused across all rows/columns in the same tile.
-/// \todo The weights computed for a particular tile could also be reused for all
-/// tiles in the same tile column or row. We could achieve this by outputting
-/// the weights on an internal plug, and using Gaffer's caching to ensure they are
-/// only computed once and then reused. At the time of writing, profiles indicate that
-/// accessing pixels via the Sampler is the main bottleneck, but once that is optimised
-/// perhaps cached filter weights could have a benefit.
-void filterWeights( const OIIO::Filter2D *filter, const int filterRadius, const int x, const float ratio, const float offset, Passes pass, std::vector<float> &weights )
+// Filter weights for a whole row or column of output pixels in a tile.
+// For separable filters these can be reused across all rows/columns in
+// the same tile, and across all tiles in the same tile column/row.
+struct FilterWeights
+{
+	// Number of weights per output pixel.
+	int width;
+	// The first input pixel in the support of each output pixel.
+	std::vector<int> supportMin;
+	// `width` weights for each output pixel, the first applying to
+	// the input pixel at `supportMin`.
+	std::vector<float> weights;
+	// The sum of the weights for each output pixel.
+	std::vector<float> totals;
+};
+
+typedef boost::shared_ptr<const FilterWeights> ConstFilterWeightsPtr;
+
+struct FilterWeightsKey
+{
+
+	FilterWeightsKey( const OIIO::Filter2D *filter, Passes pass, int filterRadius, int origin, float ratio, float offset )
+		:	filter( filter ), filterName( filter->name().c_str() ), filterWidth( pass == Horizontal ? filter->width() : filter->height() ),
+			pass( pass ), filterRadius( filterRadius ), origin( origin ), ratio( ratio ), offset( offset )
+	{
+	}
+
+	bool operator == ( const FilterWeightsKey &other ) const
+	{
+		return
+			filterName == other.filterName &&
+			filterWidth == other.filterWidth &&
+			pass == other.pass &&
+			filterRadius == other.filterRadius &&
+			origin == other.origin &&
+			ratio == other.ratio &&
+			offset == other.offset
+		;
+	}
+
+	friend size_t hash_value( const FilterWeightsKey &key )
+	{
+		size_t result = 0;
+		boost::hash_combine( result, key.filterName );
+		boost::hash_combine( result, key.filterWidth );
+		boost::hash_combine( result, (int)key.pass );
+		boost::hash_combine( result, key.filterRadius );
+		boost::hash_combine( result, key.origin );
+		boost::hash_combine( result, key.ratio );
+		boost::hash_combine( result, key.offset );
+		return result;
+	}
+
+	// Used to compute the weights, but not used for comparison,
+	// so only valid for the duration of the call to get().
+	const OIIO::Filter2D *filter;
+
+	std::string filterName;
+	float filterWidth;
+	Passes pass;
+	int filterRadius;
+	int origin;
+	float ratio;
+	float offset;
+
+};
+
+ConstFilterWeightsPtr filterWeightsGetter( const FilterWeightsKey &key, size_t &cost )
 {
-	weights.reserve( ( 2 * filterRadius + 1 ) * ImagePlug::tileSize() );
+	boost::shared_ptr<FilterWeights> result( new FilterWeights );
+	result->width = 2 * key.filterRadius + 1;
+	result->supportMin.reserve( ImagePlug::tileSize() );
+	result->weights.reserve( result->width * ImagePlug::tileSize() );
+	result->totals.reserve( ImagePlug::tileSize() );
 
 	float iX; // input pixel position (floating point)
 	int iXI; // input pixel position (floored to int)
 	float iXF; // fractional part of input pixel position after flooring
-	for( int oX = x, eX = x + ImagePlug::tileSize(); oX < eX; ++oX )
+	for( int oX = key.origin, eX = key.origin + ImagePlug::tileSize(); oX < eX; ++oX )
 	{
-		iX = ( oX + 0.5 ) / ratio + offset;
+		iX = ( oX + 0.5 ) / key.ratio + key.offset;
 		iXF = OIIO::floorfrac( iX, &iXI );
+		result->supportMin.push_back( iXI - key.filterRadius );
 
 		int fX; // relative filter position
-		for( fX = -filterRadius; fX<= filterRadius; ++fX )
+		float totalW = 0.0f;
+		for( fX = -key.filterRadius; fX<= key.filterRadius; ++fX )
 		{
-			const float f = ratio * (fX - ( iXF - 0.5f ) );
-			const float w = pass == Horizontal ? filter->xfilt( f ) : filter->yfilt( f );
-			weights.push_back( w );
+			const float f = key.ratio * (fX - ( iXF - 0.5f ) );
+			const float w = key.pass == Horizontal ? key.filter->xfilt( f ) : key.filter->yfilt( f );
+			result->weights.push_back( w );
+			totalW += w;
+		}
+		result->totals.push_back( totalW );
+	}
+
+	cost = result->weights.size();
+	return result;
+}
+
+// Cost is measured in weights, so this limits the cache to around 16 megabytes.
+typedef IECorePreview::LRUCache<FilterWeightsKey, ConstFilterWeightsPtr> FilterWeightsCache;
+FilterWeightsCache g_filterWeightsCache( filterWeightsGetter, 4 * 1024 * 1024 );
+
+ConstFilterWeightsPtr filterWeights( const OIIO::Filter2D *filter, Passes pass, int filterRadius, int origin, float ratio, float offset )
+{
+	return g_filterWeightsCache.get( FilterWeightsKey( filter, pass, filterRadius, origin, ratio, offset ) );
+}
+
+// Applies separable filter weights to a buffer of input lines, each
+// containing `ImagePlug::tileSize()` values, with the first line
+// corresponding to input pixel `firstLine`. The filtered value for
+// pixel `j` of output line `i` is written to `output[i * lineStride + j * pixelStride]`.
+// The inner loop runs along a whole line at once, without branches or
+// indirection, so that the compiler can vectorise it.
+void convolve( const FilterWeights &weights, const std::vector<float> &lines, int firstLine, float *output, int lineStride, int pixelStride )
+{
+	const int tileSize = ImagePlug::tileSize();
+	std::vector<float> sum( tileSize );
+
+	for( int i = 0; i < tileSize; ++i )
+	{
+		std::fill( sum.begin(), sum.end(), 0.0f );
+
+		const float *w = &weights.weights[i * weights.width];
+		const float *line = &lines[( weights.supportMin[i] - firstLine ) * tileSize];
+		for( int k = 0; k < weights.width; ++k, line += tileSize )
+		{
+			const float wk = w[k];
+			if( wk == 0.0f )
+			{
+				continue;
+			}
+
+			float *s = &sum[0];
+			for( int j = 0; j < tileSize; ++j )
+			{
+				s[j] += wk * line[j];
+			}
+		}
+
+		const float totalW = weights.totals[i];
+		if( totalW != 0.0f )
+		{
+			float *o = output + i * lineStride;
+			for( int j = 0; j < tileSize; ++j )
+			{
+				o[j * pixelStride] = sum[j] / totalW;
+			}
 		}
 	}
 }
@@ -613,89 +740,51 @@ IECore::ConstFloatVectorDataPtr Resample::computeChannelData( const std::string
 		// debug mode causes this pass to be output directly for inspection.
 
 		// Pixels in the same column share the same filter weights, so
-		// we precompute the weights now to avoid repeating work later.
-		std::vector<float> weights;
-		filterWeights( filter.get(), filterRadius.x, tileBound.min.x, ratio.x, offset.x, Horizontal, weights );
-
-		V2i oP; // output pixel position
-		float iX; // input pixel x coordinate (floating point)
-		int iXI; // input pixel position (floored to int)
-
-		for( oP.y = tileBound.min.y; oP.y < tileBound.max.y; ++oP.y )
+		// we use precomputed weights to avoid repeating work.
+		ConstFilterWeightsPtr weights = filterWeights( filter.get(), Horizontal, filterRadius.x, tileBound.min.x, ratio.x, offset.x );
+
+		// Each input pixel contributes to several output pixels, so rather
+		// than use the sampler for every filter tap, we copy the input once
+		// into a buffer. We store it column by column, so the filter can
+		// then be applied to whole columns at a time.
+		const int tileSize = ImagePlug::tileSize();
+		const int xMin = weights->supportMin.front();
+		const int xMax = weights->supportMin.back() + weights->width;
+
+		std::vector<float> columns( ( xMax - xMin ) * tileSize );
+		for( int y = 0; y < tileSize; ++y )
 		{
-			std::vector<float>::const_iterator wIt = weights.begin();
-			for( oP.x = tileBound.min.x; oP.x < tileBound.max.x; ++oP.x )
+			for( int x = xMin; x < xMax; ++x )
 			{
-
-				iX = ( oP.x + 0.5 ) / ratio.x + offset.x;
-				OIIO::floorfrac( iX, &iXI );
-
-				int fX; // relative filter position
-				float v = 0.0f;
-				float totalW = 0.0f;
-				for( fX = -filterRadius.x; fX<= filterRadius.x; ++fX )
-				{
-					const float w = *wIt++;
-					if( w == 0.0f )
-					{
-						continue;
-					}
-
-					v += w * sampler.sample( iXI + fX, oP.y );
-					totalW += w;
-				}
-
-				if( totalW != 0.0f )
-				{
-					*pIt = v / totalW;
-				}
-
-				++pIt;
+				columns[( x - xMin ) * tileSize + y] = sampler.sample( x, tileBound.min.y + y );
 			}
 		}
+
+		convolve( *weights, columns, xMin, &resultData->writable().front(), 1, tileSize );
 	}
 	else if( passes == Vertical )
 	{
-		V2i oP; // output pixel position
-		float iY; // input pixel position (floating point)
-		int iYI; // input pixel position (floored to int)
-
 		// Pixels in the same row share the same filter weights, so
-		// we precompute the weights now to avoid repeating work later.
-		std::vector<float> weights;
-		filterWeights( filter.get(), filterRadius.y, tileBound.min.y, ratio.y, offset.y, Vertical, weights );
-
-		for( oP.y = tileBound.min.y; oP.y < tileBound.max.y; ++oP.y )
+		// we use precomputed weights to avoid repeating work.
+		ConstFilterWeightsPtr weights = filterWeights( filter.get(), Vertical, filterRadius.y, tileBound.min.y, ratio.y, offset.y );
+
+		// As for the horizontal pass, we copy the input into a buffer
+		// first, this time row by row.
+		const int tileSize = ImagePlug::tileSize();
+		const int yMin = weights->supportMin.front();
+		const int yMax = weights->supportMin.back() + weights->width;
+
+		std::vector<float> rows( ( yMax - yMin ) * tileSize );
+		std::vector<float>::iterator rIt = rows.begin();
+		for( int y = yMin; y < yMax; ++y )
 		{
-			iY = ( oP.y + 0.5 ) / ratio.y + offset.y;
-			OIIO::floorfrac( iY, &iYI );
-
-			for( oP.x = tileBound.min.x; oP.x < tileBound.max.x; ++oP.x )
+			for( int x = tileBound.min.x; x < tileBound.max.x; ++x )
 			{
-				int fY; // relative filter position
-				float v = 0.0f;
-				float totalW = 0.0f;
-				std::vector<float>::const_iterator wIt = weights.begin() + ( oP.y - tileBound.min.y ) * ( filterRadius.y * 2 + 1);
-				for( fY = -filterRadius.y; fY<= filterRadius.y; ++fY )
-				{
-					const float w = *wIt++;
-					if( w == 0.0f )
-					{
-						continue;
-					}
-
-					v += w * sampler.sample( oP.x, iYI + fY );
-					totalW += w;
-				}
-
-				if( totalW != 0.0f )
-				{
-					*pIt = v / totalW;
-				}
-
-				++pIt;
+				*rIt++ = sampler.sample( x, y );
 			}
 		}
+
+		convolve( *weights, rows, yMin, &resultData->writable().front(), tileSize, 1 );
 	}
 
 	return resultData;
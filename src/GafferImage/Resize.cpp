@@ -39,6 +39,7 @@
 #include "GafferImage/Resize.h"
 #include "GafferImage/Sampler.h"
 #include "GafferImage/Resample.h"
+#include "GafferImage/ImageAlgo.h"
 
 using namespace Imath;
 using namespace Gaffer;
@@ -58,15 +59,23 @@ Resize::Resize( const std::string &name )
 	addChild( new StringPlug( "filter" ) );
 	addChild( new AtomicBox2fPlug( "__dataWindow", Plug::Out ) );
 	addChild( new ImagePlug( "__resampledIn", Plug::In, Plug::Default & ~Plug::Serialisable ) );
+	addChild( new ImagePlug( "__concatenatedIn", Plug::Out, Plug::Default & ~Plug::Serialisable ) );
 
 	// We don't really do much work ourselves - we just
 	// defer to an internal Resample node to do the hard
 	// work of filtering everything into the right place.
+	// Rather than resampling our input, it resamples the
+	// head of any chain of transforms upstream, so the
+	// whole chain is filtered only once.
 
 	ResamplePtr resample = new Resample( "__resample" );
 	addChild( resample );
 
-	resample->inPlug()->setInput( inPlug() );
+	concatenatedInPlug()->formatPlug()->setInput( inPlug()->formatPlug() );
+	concatenatedInPlug()->metadataPlug()->setInput( inPlug()->metadataPlug() );
+	concatenatedInPlug()->channelNamesPlug()->setInput( inPlug()->channelNamesPlug() );
+
+	resample->inPlug()->setInput( concatenatedInPlug() );
 
 	resample->filterPlug()->setInput( filterPlug() );
 	resample->dataWindowPlug()->setInput( dataWindowPlug() );
@@ -133,10 +142,30 @@ const ImagePlug *Resize::resampledInPlug() const
 	return getChild<ImagePlug>( g_firstPlugIndex + 4 );
 }
 
+ImagePlug *Resize::concatenatedInPlug()
+{
+	return getChild<ImagePlug>( g_firstPlugIndex + 5 );
+}
+
+const ImagePlug *Resize::concatenatedInPlug() const
+{
+	return getChild<ImagePlug>( g_firstPlugIndex + 5 );
+}
+
 void Resize::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ImageProcessor::affects( input, outputs );
 
+	if( input == inPlug()->dataWindowPlug() || input == enabledPlug() )
+	{
+		outputs.push_back( concatenatedInPlug()->dataWindowPlug() );
+	}
+
+	if( input == inPlug()->channelDataPlug() || input == enabledPlug() )
+	{
+		outputs.push_back( concatenatedInPlug()->channelDataPlug() );
+	}
+
 	if(
 		formatPlug()->isAncestorOf( input ) ||
 		input == fitModePlug() ||
@@ -178,7 +207,9 @@ void Resize::hash( const ValuePlug *output, const Context *context, IECore::Murm
 		formatPlug()->hash( h );
 		fitModePlug()->hash( h );
 		inPlug()->formatPlug()->hash( h );
-		inPlug()->dataWindowPlug()->hash( h );
+		M33f inputMatrix;
+		concatenatedTransformInput( inPlug(), inputMatrix )->dataWindowPlug()->hash( h );
+		h.append( inputMatrix );
 	}
 }
 
@@ -186,39 +217,12 @@ void Resize::compute( ValuePlug *output, const Context *context ) const
 {
 	if( output == dataWindowPlug() )
 	{
-		const Format inFormat = inPlug()->formatPlug()->getValue();
-		const Format outFormat = formatPlug()->getValue();
-
-		const V2f inSize( inFormat.width(), inFormat.height() );
-		const V2f outSize( outFormat.width(), outFormat.height() );
-		const V2f formatScale = outSize / inSize;
-
-		V2f dataWindowScale( 1 );
-		switch( (FitMode)fitModePlug()->getValue() )
-		{
-			case Horizontal :
-				dataWindowScale = V2f( formatScale.x );
-				break;
-			case Vertical :
-				dataWindowScale = V2f( formatScale.y );
-				break;
-			case Fit :
-				dataWindowScale = V2f( std::min( formatScale.x, formatScale.y ) );
-				break;
-			case Fill :
-				dataWindowScale = V2f( std::max( formatScale.x, formatScale.y ) );
-				break;
-			case Distort :
-			default :
-				dataWindowScale = formatScale;
-				break;
-		}
-
-		const V2f dataWindowOffset = ( outSize - ( inSize * dataWindowScale ) ) / 2.0f;
-		const Box2i inDataWindow = inPlug()->dataWindowPlug()->getValue();
+		M33f inputMatrix;
+		const Box2i inDataWindow = concatenatedTransformInput( inPlug(), inputMatrix )->dataWindowPlug()->getValue();
+		const M33f m = inputMatrix * resizeMatrix();
 		Box2f outDataWindow(
-			V2f( inDataWindow.min ) * dataWindowScale + dataWindowOffset,
-			V2f( inDataWindow.max ) * dataWindowScale + dataWindowOffset
+			V2f( inDataWindow.min ) * m,
+			V2f( inDataWindow.max ) * m
 		);
 
 		// It's important that we use floating point data windows in the Resample node
@@ -264,26 +268,79 @@ GafferImage::Format Resize::computeFormat( const Gaffer::Context *context, const
 
 void Resize::hashDataWindow( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
-	h = source()->dataWindowPlug()->hash();
+	h = source( parent )->dataWindowPlug()->hash();
 }
 
 Imath::Box2i Resize::computeDataWindow( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	return source()->dataWindowPlug()->getValue();
+	return source( parent )->dataWindowPlug()->getValue();
 }
 
 void Resize::hashChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
-	h = source()->channelDataPlug()->hash();
+	h = source( parent )->channelDataPlug()->hash();
 }
 
 IECore::ConstFloatVectorDataPtr Resize::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	return source()->channelDataPlug()->getValue();
+	return source( parent )->channelDataPlug()->getValue();
 }
 
-const ImagePlug *Resize::source() const
+Imath::M33f Resize::matrix() const
 {
+	if( formatPlug()->getValue() == inPlug()->formatPlug()->getValue() )
+	{
+		// We pass through the input unchanged.
+		return M33f();
+	}
+	return resizeMatrix();
+}
+
+Imath::M33f Resize::resizeMatrix() const
+{
+	const Format inFormat = inPlug()->formatPlug()->getValue();
+	const Format outFormat = formatPlug()->getValue();
+
+	const V2f inSize( inFormat.width(), inFormat.height() );
+	const V2f outSize( outFormat.width(), outFormat.height() );
+	const V2f formatScale = outSize / inSize;
+
+	V2f dataWindowScale( 1 );
+	switch( (FitMode)fitModePlug()->getValue() )
+	{
+		case Horizontal :
+			dataWindowScale = V2f( formatScale.x );
+			break;
+		case Vertical :
+			dataWindowScale = V2f( formatScale.y );
+			break;
+		case Fit :
+			dataWindowScale = V2f( std::min( formatScale.x, formatScale.y ) );
+			break;
+		case Fill :
+			dataWindowScale = V2f( std::max( formatScale.x, formatScale.y ) );
+			break;
+		case Distort :
+		default :
+			dataWindowScale = formatScale;
+			break;
+	}
+
+	const V2f dataWindowOffset = ( outSize - ( inSize * dataWindowScale ) ) / 2.0f;
+
+	M33f scaleMatrix; scaleMatrix.setScale( dataWindowScale );
+	M33f translateMatrix; translateMatrix.setTranslation( dataWindowOffset );
+	return scaleMatrix * translateMatrix;
+}
+
+const ImagePlug *Resize::source( const ImagePlug *parent ) const
+{
+	if( parent == concatenatedInPlug() )
+	{
+		M33f inputMatrix;
+		return concatenatedTransformInput( inPlug(), inputMatrix );
+	}
+
 	if( formatPlug()->getValue() == inPlug()->formatPlug()->getValue() )
 	{
 		return inPlug();
@@ -216,6 +216,19 @@ IECore::ConstFloatVectorDataPtr Shuffle::computeChannelData( const std::string &
 	}
 }
 
+Gaffer::ValuePlug::CachePolicy Shuffle::computeCachePolicy( const Gaffer::ValuePlug *output ) const
+{
+	if( output == outPlug()->channelDataPlug() )
+	{
+		// We only ever pass through input tiles or return the constant
+		// black and white tiles, so caching would just store duplicates
+		// of data held elsewhere. This matters most when the input is
+		// itself uncached, as is the case for an ImageReader.
+		return ValuePlug::Uncached;
+	}
+	return ImageProcessor::computeCachePolicy( output );
+}
+
 std::string Shuffle::inChannelName( const std::string &outChannelName ) const
 {
 	for( ChannelPlugIterator it( channelsPlug() ); !it.done(); ++it )
@@ -47,7 +47,12 @@ namespace GafferImageBindings
 
 void bindBlur()
 {
-	GafferBindings::DependencyNodeClass<Blur>();
+	scope s = GafferBindings::DependencyNodeClass<Blur>();
+
+	enum_<Blur::Mode>( "Mode" )
+		.value( "Accurate", Blur::Accurate )
+		.value( "Fast", Blur::Fast )
+	;
 }
 
 } // namespace GafferImageBindings
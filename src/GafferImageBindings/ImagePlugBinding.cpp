@@ -35,6 +35,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/python.hpp"
+#include "boost/python/suite/indexing/container_utils.hpp"
 
 #include "GafferBindings/PlugBinding.h"
 
@@ -56,6 +57,34 @@ IECore::FloatVectorDataPtr channelData( const ImagePlug &plug,  const std::strin
 	return copy ? d->copy() : boost::const_pointer_cast<IECore::FloatVectorData>( d );
 }
 
+boost::python::list channelDatas( const ImagePlug &plug, boost::python::list channelNameList, const Imath::V2i &tile, bool copy )
+{
+	std::vector<std::string> channelNames;
+	container_utils::extend_container( channelNames, channelNameList );
+
+	std::vector<IECore::ConstFloatVectorDataPtr> d;
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		plug.channelData( channelNames, tile, d );
+	}
+
+	boost::python::list result;
+	for( std::vector<IECore::ConstFloatVectorDataPtr>::const_iterator it = d.begin(), eIt = d.end(); it != eIt; ++it )
+	{
+		result.append( copy ? (*it)->copy() : boost::const_pointer_cast<IECore::FloatVectorData>( *it ) );
+	}
+	return result;
+}
+
+IECore::MurmurHash channelDatasHash( const ImagePlug &plug, boost::python::list channelNameList, const Imath::V2i &tile )
+{
+	std::vector<std::string> channelNames;
+	container_utils::extend_container( channelNames, channelNameList );
+
+	IECorePython::ScopedGILRelease gilRelease;
+	return plug.channelDataHash( channelNames, tile );
+}
+
 IECore::ImagePrimitivePtr image( const ImagePlug &plug )
 {
 	IECorePython::ScopedGILRelease gilRelease;
@@ -79,11 +108,14 @@ void GafferImageBindings::bindImagePlug()
 			)
 		)
 		.def( "channelData", &channelData, ( arg( "_copy" ) = true ) )
-		.def( "channelDataHash", &ImagePlug::channelDataHash )
+		.def( "channelData", &channelDatas, ( arg( "_copy" ) = true ) )
+		.def( "channelDataHash", (IECore::MurmurHash (ImagePlug::*)( const std::string &, const Imath::V2i & ) const)&ImagePlug::channelDataHash )
+		.def( "channelDataHash", &channelDatasHash )
 		.def( "image", &image )
 		.def( "imageHash", &ImagePlug::imageHash )
 		.def( "tileSize", &ImagePlug::tileSize ).staticmethod( "tileSize" )
 		.def( "tileOrigin", &ImagePlug::tileOrigin ).staticmethod( "tileOrigin" )
+		.def( "dirtyRegion", &ImagePlug::dirtyRegion )
 	;
 
 }
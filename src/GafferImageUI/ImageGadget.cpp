@@ -38,6 +38,11 @@
 #include "boost/algorithm/string/predicate.hpp"
 #include "boost/lexical_cast.hpp"
 
+#include "tbb/parallel_for.h"
+#include "tbb/task_scheduler_init.h"
+
+#include "IECore/Timer.h"
+
 #include "IECoreGL/Selector.h"
 #include "IECoreGL/LuminanceTexture.h"
 #include "IECoreGL/IECoreGL.h"
@@ -46,13 +51,16 @@
 #include "IECoreGL/GL.h"
 
 #include "Gaffer/Node.h"
+#include "Gaffer/ComputeNode.h"
+#include "Gaffer/TypedPlug.h"
 #include "Gaffer/Context.h"
 
 #include "GafferUI/Style.h"
 #include "GafferUI/ViewportGadget.h"
 
 #include "GafferImage/ImagePlug.h"
-#include "GafferImage/ImageAlgo.h"
+#include "GafferImage/Resample.h"
+#include "GafferImage/Sampler.h"
 
 #include "GafferImageUI/ImageGadget.h"
 
@@ -66,6 +74,106 @@ using namespace GafferUI;
 using namespace GafferImage;
 using namespace GafferImageUI;
 
+//////////////////////////////////////////////////////////////////////////
+// ProxyImage implementation
+//////////////////////////////////////////////////////////////////////////
+
+// Generates a single proxy level from the image connected to inPlug().
+// The filtering is done by an internal Resample, whose data window is
+// computed from the data window of the input. Because everything is
+// connected rather than set by the ImageGadget, the proxy automatically
+// tracks any changes to the input image.
+class ImageGadget::ProxyImage : public Gaffer::ComputeNode
+{
+
+	public :
+
+		ProxyImage( int level )
+			:	ComputeNode( "ProxyImage" ), m_level( level )
+		{
+			addChild( new ImagePlug( "in" ) );
+			addChild( new AtomicBox2fPlug( "__dataWindow", Plug::Out ) );
+
+			ResamplePtr resample = new Resample( "__resample" );
+			addChild( resample );
+
+			resample->inPlug()->setInput( inPlug() );
+			resample->dataWindowPlug()->setInput( dataWindowPlug() );
+			// A box filter is sufficient for our power-of-two
+			// proxy levels, and is the cheapest to compute.
+			resample->filterPlug()->setValue( "box" );
+			resample->boundingModePlug()->setValue( Sampler::Clamp );
+		}
+
+		ImagePlug *inPlug()
+		{
+			return getChild<ImagePlug>( 0 );
+		}
+
+		const ImagePlug *inPlug() const
+		{
+			return getChild<ImagePlug>( 0 );
+		}
+
+		const ImagePlug *outPlug() const
+		{
+			return getChild<Resample>( 2 )->outPlug();
+		}
+
+		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
+		{
+			ComputeNode::affects( input, outputs );
+
+			if( input == inPlug()->dataWindowPlug() )
+			{
+				outputs.push_back( dataWindowPlug() );
+			}
+		}
+
+	protected :
+
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+		{
+			ComputeNode::hash( output, context, h );
+
+			if( output == dataWindowPlug() )
+			{
+				inPlug()->dataWindowPlug()->hash( h );
+				h.append( m_level );
+			}
+		}
+
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
+		{
+			if( output == dataWindowPlug() )
+			{
+				const Box2i inDataWindow = inPlug()->dataWindowPlug()->getValue();
+				const float scale = 1.0f / (float)( 1 << m_level );
+				static_cast<AtomicBox2fPlug *>( output )->setValue(
+					Box2f( V2f( inDataWindow.min ) * scale, V2f( inDataWindow.max ) * scale )
+				);
+				return;
+			}
+
+			ComputeNode::compute( output, context );
+		}
+
+	private :
+
+		AtomicBox2fPlug *dataWindowPlug()
+		{
+			return getChild<AtomicBox2fPlug>( 1 );
+		}
+
+		const AtomicBox2fPlug *dataWindowPlug() const
+		{
+			return getChild<AtomicBox2fPlug>( 1 );
+		}
+
+		const int m_level;
+
+};
+
 //////////////////////////////////////////////////////////////////////////
 // ImageGadget implementation
 //////////////////////////////////////////////////////////////////////////
@@ -74,7 +182,8 @@ ImageGadget::ImageGadget()
 	:	Gadget( defaultName<ImageGadget>() ),
 		m_image( NULL ),
 		m_soloChannel( -1 ),
-		m_dirtyFlags( AllDirty )
+		m_dirtyFlags( AllDirty ),
+		m_tilesLevel( 0 )
 {
 	/// \todo Expose accessors to allow the user
 	/// to choose which channels are displayed.
@@ -101,6 +210,13 @@ void ImageGadget::setImage( GafferImage::ConstImagePlugPtr image )
 	}
 
 	m_image = image;
+	for( vector<ProxyImagePtr>::const_iterator it = m_proxyImages.begin(), eIt = m_proxyImages.end(); it != eIt; ++it )
+	{
+		if( *it )
+		{
+			(*it)->inPlug()->setInput( const_cast<ImagePlug *>( image.get() ) );
+		}
+	}
 	if( Gaffer::Node *node = const_cast<Gaffer::Node *>( image->node() ) )
 	{
 		m_plugDirtiedConnection = node->plugDirtiedSignal().connect( boost::bind( &ImageGadget::plugDirtied, this, ::_1 ) );
@@ -110,8 +226,7 @@ void ImageGadget::setImage( GafferImage::ConstImagePlugPtr image )
 		m_plugDirtiedConnection.disconnect();
 	}
 
-	m_dirtyFlags = AllDirty;
-	requestRender();
+	dirty( AllDirty );
 }
 
 const GafferImage::ImagePlug *ImageGadget::getImage() const
@@ -129,8 +244,7 @@ void ImageGadget::setContext( Gaffer::ContextPtr context )
 	m_context = context;
 	m_contextChangedConnection = m_context->changedSignal().connect( boost::bind( &ImageGadget::contextChanged, this, ::_2 ) );
 
-	m_dirtyFlags = AllDirty;
-	requestRender();
+	dirty( AllDirty );
 }
 
 Gaffer::Context *ImageGadget::getContext()
@@ -161,9 +275,12 @@ void ImageGadget::setSoloChannel( int index )
 		// only updated the solo channel, so now
 		// we need to trigger a pass over all the
 		// channels.
-		m_dirtyFlags |= TilesDirty;
+		dirty( TilesDirty );
+	}
+	else
+	{
+		requestRender();
 	}
-	requestRender();
 }
 
 int ImageGadget::getSoloChannel() const
@@ -198,26 +315,27 @@ Imath::Box3f ImageGadget::bound() const
 
 void ImageGadget::plugDirtied( const Gaffer::Plug *plug )
 {
+	unsigned flags = NothingDirty;
 	if( plug == m_image->formatPlug() )
 	{
-		m_dirtyFlags |= FormatDirty;
+		flags = FormatDirty;
 	}
 	else if( plug == m_image->dataWindowPlug() )
 	{
-		m_dirtyFlags |= DataWindowDirty | TilesDirty;
+		flags = DataWindowDirty | TilesDirty;
 	}
 	else if( plug == m_image->channelNamesPlug() )
 	{
-		m_dirtyFlags |= ChannelNamesDirty | TilesDirty;
+		flags = ChannelNamesDirty | TilesDirty;
 	}
 	else if( plug == m_image->channelDataPlug() )
 	{
-		m_dirtyFlags |= TilesDirty;
+		dirtyTiles( m_image->dirtyRegion() );
 	}
 
-	if( m_dirtyFlags )
+	if( flags )
 	{
-		requestRender();
+		dirty( flags );
 	}
 }
 
@@ -225,9 +343,51 @@ void ImageGadget::contextChanged( const IECore::InternedString &name )
 {
 	if( !boost::starts_with( name.string(), "ui:" ) )
 	{
-		m_dirtyFlags = AllDirty;
-		requestRender();
+		dirty( AllDirty );
+	}
+}
+
+void ImageGadget::dirty( unsigned flags )
+{
+	if( flags & TilesDirty )
+	{
+		// Any tiles still queued from a previous update are now
+		// out of date, so we discard them and schedule a fresh
+		// update for the next idle event.
+		m_tileQueue.clear();
+		if( !m_idleConnection.connected() )
+		{
+			m_idleConnection = idleSignal().connect( boost::bind( &ImageGadget::updateTiles, this ) );
+		}
 	}
+
+	m_dirtyFlags |= flags;
+	requestRender();
+}
+
+void ImageGadget::dirtyTiles( const Imath::Box2i &region )
+{
+	if( region.isInfinite() )
+	{
+		// The whole image may have changed.
+		dirty( TilesDirty );
+		return;
+	}
+
+	if( empty( region ) )
+	{
+		return;
+	}
+
+	// Only part of the image has changed, so tiles already queued
+	// are still needed, and we just add the tiles from the region
+	// on the next idle event.
+	m_dirtyTilesRegion.extendBy( region );
+	if( !m_idleConnection.connected() )
+	{
+		m_idleConnection = idleSignal().connect( boost::bind( &ImageGadget::updateTiles, this ) );
+	}
+	requestRender();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -303,68 +463,286 @@ inline size_t GafferImageUI::tbb_hasher( const ImageGadget::TileIndex &tileIndex
 		tbb::tbb_hasher( tileIndex.channelName.c_str() );
 }
 
-// Tests to see if a tile needs updating, and if it does, computes
-// the channel data to go into it.
+namespace
+{
+
+// Time we're allowed to spend computing tiles in each call
+// to updateTiles(), before we must return control to the
+// event loop.
+const double g_tileUpdateBudget = 1.0 / 30.0;
+
+struct TileDistanceGreater
+{
+
+	bool operator()( const std::pair<float, V2i> &a, const std::pair<float, V2i> &b ) const
+	{
+		return a.first > b.first;
+	}
+
+};
+
+} // namespace
+
+// Tests to see if a queued tile needs updating, and if it does,
+// computes the channel data to go into it. Tiles are skipped once
+// the time budget has been used up, and `computed` records which
+// ones were actually dealt with, so that the rest can be left in
+// the queue for the next idle event.
 struct ImageGadget::TileFunctor
 {
 
-	TileFunctor( Tiles &tiles )
-		:	m_tiles( tiles )
+	TileFunctor( Tiles &tiles, const vector<TileIndex> &tileQueue, size_t batchBegin, vector<char> &computed, const Timer &timer, const ImagePlug *image, const Context *context )
+		:	m_tiles( tiles ), m_tileQueue( tileQueue ), m_batchBegin( batchBegin ), m_computed( computed ), m_timer( timer ), m_image( image ), m_parentContext( context )
 	{
 	}
 
-	void operator()( const ImagePlug *image, const string &channelName, const V2i &tileOrigin )
+	void operator()( const tbb::blocked_range<size_t> &r ) const
 	{
-		Tile &tile = m_tiles[TileIndex(tileOrigin, channelName)];
-		ConstFloatVectorDataPtr channelData;
-		const IECore::MurmurHash h = image->channelDataPlug()->hash();
-		if( !tile.texture || tile.channelDataHash != h )
+		ContextPtr context = new Context( *m_parentContext, Context::Borrowed );
+		Context::Scope scopedContext( context.get() );
+
+		for( size_t i = r.begin(); i != r.end(); ++i )
 		{
-			tile.channelDataToConvert = image->channelDataPlug()->getValue( &h );
-			tile.channelDataHash = h;
+			if( m_timer.totalElapsed() >= g_tileUpdateBudget )
+			{
+				return;
+			}
+
+			const TileIndex &tileIndex = m_tileQueue[i];
+			context->set( ImagePlug::tileOriginContextName, tileIndex.tileOrigin );
+			context->set( ImagePlug::channelNameContextName, tileIndex.channelName.string() );
+
+			Tile &tile = m_tiles[tileIndex];
+			const IECore::MurmurHash h = m_image->channelDataPlug()->hash();
+			if( !tile.texture || tile.channelDataHash != h )
+			{
+				tile.channelDataToConvert = m_image->channelDataPlug()->getValue( &h );
+				tile.channelDataHash = h;
+			}
+			m_computed[i - m_batchBegin] = true;
 		}
 	}
 
 	private :
 
 		Tiles &m_tiles;
+		const vector<TileIndex> &m_tileQueue;
+		const size_t m_batchBegin;
+		vector<char> &m_computed;
+		const Timer &m_timer;
+		const ImagePlug *m_image;
+		const Context *m_parentContext;
 
 };
 
-void ImageGadget::updateTiles() const
+void ImageGadget::updateTiles()
 {
-	if( !(m_dirtyFlags & TilesDirty) )
+	bool updated = false;
+	try
 	{
-		return;
+		if( m_dirtyFlags & TilesDirty )
+		{
+			updateTileQueue();
+			m_dirtyFlags &= ~TilesDirty;
+		}
+		else if( !empty( m_dirtyTilesRegion ) )
+		{
+			queueTiles( m_dirtyTilesRegion );
+		}
+		m_dirtyTilesRegion = Box2i();
+
+		// Compute batches of tiles from the back of the queue, where the
+		// most important ones are, until we've used up our time budget.
+		// Each batch is computed in parallel, with enough tiles to keep
+		// all the threads busy. The budget is also checked before each
+		// individual tile, so that a batch of slow tiles can't hold up
+		// the UI for longer than necessary.
+		const size_t batchSize = tbb::task_scheduler_init::default_num_threads() * 4;
+		Timer timer;
+		vector<char> computed;
+		while( !m_tileQueue.empty() && timer.totalElapsed() < g_tileUpdateBudget )
+		{
+			const size_t batchEnd = m_tileQueue.size();
+			const size_t batchBegin = batchEnd - std::min( batchSize, batchEnd );
+			computed.assign( batchEnd - batchBegin, false );
+			TileFunctor tileFunctor( m_tiles, m_tileQueue, batchBegin, computed, timer, tilesImage(), m_context.get() );
+			tbb::parallel_for( tbb::blocked_range<size_t>( batchBegin, batchEnd ), tileFunctor );
+
+			// Remove the tiles we computed, keeping any we skipped
+			// in their original order so they remain prioritised.
+			vector<TileIndex>::iterator queueEnd = m_tileQueue.begin() + batchBegin;
+			for( size_t i = batchBegin; i < batchEnd; ++i )
+			{
+				if( !computed[i - batchBegin] )
+				{
+					*queueEnd++ = m_tileQueue[i];
+				}
+			}
+			m_tileQueue.erase( queueEnd, m_tileQueue.end() );
+			updated = true;
+		}
+	}
+	catch( ... )
+	{
+		// Computation errors are reported elsewhere in the UI, so
+		// we simply abandon the update.
+		m_tileQueue.clear();
 	}
 
+	if( m_tileQueue.empty() )
+	{
+		m_idleConnection.disconnect();
+	}
+
+	if( updated )
+	{
+		requestRender();
+	}
+}
+
+void ImageGadget::updateTileQueue()
+{
+	m_tileQueue.clear();
+
+	// Decide which level to display the image at, and which
+	// region of that level is visible, then find the tiles
+	// we'll need to cover it.
+	Box2i dataWindow = this->dataWindow();
+	int level = 0;
+	Box2i region = dataWindow;
+	if( !empty( dataWindow ) && visibleRegion( region, level ) && level )
+	{
+		const ImagePlug *proxy = proxyImage( level );
+		Context::Scope scopedContext( m_context.get() );
+		dataWindow = proxy->dataWindowPlug()->getValue();
+	}
+
+	if( level != m_tilesLevel )
+	{
+		// Tiles from another level are drawn at the wrong
+		// scale, so can't be kept around.
+		m_tiles.clear();
+	}
+
+	m_tilesLevel = level;
+	m_tilesRegion = region;
+	m_tilesBound = intersection( dataWindow, region );
+
 	removeOutOfBoundsTiles();
+	if( empty( m_tilesBound ) )
+	{
+		return;
+	}
+
+	// Decide which channels to compute.
+	vector<InternedString> channelsToCompute;
+	this->channelsToCompute( channelsToCompute );
+	if( channelsToCompute.empty() )
+	{
+		return;
+	}
+
+	// Prioritise the tiles by their distance from the centre of the
+	// viewport, since that is where the user is most likely to be
+	// looking.
+	V2f focus = V2f( m_tilesBound.min + m_tilesBound.max ) / 2.0f;
+	if( const ViewportGadget *viewport = ancestor<ViewportGadget>() )
+	{
+		const LineSegment3f line = viewport->rasterToGadgetSpace( V2f( viewport->getViewport() ) / 2.0f, this );
+		focus = V2f( line.p0.x, line.p0.y ) / (float)( 1 << level );
+	}
+
+	vector<std::pair<float, V2i> > tiles;
+	const V2f tileCentreOffset( ImagePlug::tileSize() / 2.0f );
+	V2i tileOrigin = ImagePlug::tileOrigin( m_tilesBound.min );
+	for( ; tileOrigin.y < m_tilesBound.max.y; tileOrigin.y += ImagePlug::tileSize() )
+	{
+		for( tileOrigin.x = ImagePlug::tileOrigin( m_tilesBound.min ).x; tileOrigin.x < m_tilesBound.max.x; tileOrigin.x += ImagePlug::tileSize() )
+		{
+			const float distance2 = ( V2f( tileOrigin ) + tileCentreOffset - focus ).length2();
+			tiles.push_back( std::make_pair( distance2, tileOrigin ) );
+		}
+	}
+
+	// Furthest tiles first, so that we can pop the nearest ones
+	// from the back of the queue.
+	std::sort( tiles.begin(), tiles.end(), TileDistanceGreater() );
 
-	// Decide which channels to compute. This is the intersection
-	// of the available channels (channelNames) and the channels
-	// we want to display (m_rgbaChannels).
+	m_tileQueue.reserve( tiles.size() * channelsToCompute.size() );
+	for( vector<std::pair<float, V2i> >::const_iterator it = tiles.begin(), eIt = tiles.end(); it != eIt; ++it )
+	{
+		for( vector<InternedString>::const_iterator cIt = channelsToCompute.begin(), ceIt = channelsToCompute.end(); cIt != ceIt; ++cIt )
+		{
+			m_tileQueue.push_back( TileIndex( it->second, *cIt ) );
+		}
+	}
+}
+
+void ImageGadget::queueTiles( const Imath::Box2i &region )
+{
+	// Convert the region to the pixel space of the current level,
+	// growing it by a pixel to account for the filtering done when
+	// generating the proxy.
+	Box2i levelRegion = region;
+	if( m_tilesLevel )
+	{
+		const float scale = 1.0f / (float)( 1 << m_tilesLevel );
+		levelRegion.min = V2i(
+			Imath::floor( region.min.x * scale ) - 1,
+			Imath::floor( region.min.y * scale ) - 1
+		);
+		levelRegion.max = V2i(
+			Imath::ceil( region.max.x * scale ) + 1,
+			Imath::ceil( region.max.y * scale ) + 1
+		);
+	}
+
+	levelRegion = intersection( levelRegion, m_tilesBound );
+	if( empty( levelRegion ) )
+	{
+		return;
+	}
+
+	vector<InternedString> channelsToCompute;
+	this->channelsToCompute( channelsToCompute );
+
+	// The newly received tiles are appended to the back of the
+	// queue, so that they are updated first. Any of them which were
+	// already queued will be found to be up to date when they are
+	// reached for the second time, so we don't search for duplicates.
+	V2i tileOrigin = ImagePlug::tileOrigin( levelRegion.min );
+	for( ; tileOrigin.y < levelRegion.max.y; tileOrigin.y += ImagePlug::tileSize() )
+	{
+		for( tileOrigin.x = ImagePlug::tileOrigin( levelRegion.min ).x; tileOrigin.x < levelRegion.max.x; tileOrigin.x += ImagePlug::tileSize() )
+		{
+			for( vector<InternedString>::const_iterator cIt = channelsToCompute.begin(), ceIt = channelsToCompute.end(); cIt != ceIt; ++cIt )
+			{
+				m_tileQueue.push_back( TileIndex( tileOrigin, *cIt ) );
+			}
+		}
+	}
+}
+
+void ImageGadget::channelsToCompute( std::vector<IECore::InternedString> &channels ) const
+{
+	// This is the intersection of the available channels (channelNames)
+	// and the channels we want to display (m_rgbaChannels).
 	const vector<string> &channelNames = this->channelNames();
-	vector<string> channelsToCompute;
 	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
 	{
 		if( find( m_rgbaChannels.begin(), m_rgbaChannels.end(), *it ) != m_rgbaChannels.end() )
 		{
 			if( m_soloChannel == -1 || m_rgbaChannels[m_soloChannel] == *it )
 			{
-				channelsToCompute.push_back( *it );
+				channels.push_back( *it );
 			}
 		}
 	}
+}
 
-	// Use parallelGatherTiles() to do the hard work of launching
-	// threads and iterating over tiles to get any modified channelData.
-	TileFunctor tileFunctor( m_tiles );
-	{
-		Context::Scope scopedContext( m_context.get() );
-		parallelProcessTiles( m_image.get(), channelsToCompute, tileFunctor, dataWindow() );
-	}
-
-	// Now take the new channelData and convert it into textures for display.
+void ImageGadget::uploadTiles() const
+{
+	// Take any new channelData and convert it into textures for display.
 	// We must do this on the main thread because it involves OpenGL.
 	for( Tiles::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it )
 	{
@@ -387,7 +765,6 @@ void ImageGadget::updateTiles() const
 			it->second.channelDataToConvert = NULL;
 		}
 	}
-	m_dirtyFlags &= ~TilesDirty;
 }
 
 void ImageGadget::removeOutOfBoundsTiles() const
@@ -398,13 +775,12 @@ void ImageGadget::removeOutOfBoundsTiles() const
 	// we don't want to accumulate unbounded numbers of tiles either,
 	// so here we prune out any tiles that we know can't be useful for
 	// the current image, because they either have an invalid channel
-	// name or are outside the data window.
-	const Box2i &dw = dataWindow();
+	// name or are outside the visible part of the data window.
 	const vector<string> &ch = channelNames();
 	for( Tiles::iterator it = m_tiles.begin(); it != m_tiles.end(); )
 	{
 		const Box2i tileBound( it->first.tileOrigin, it->first.tileOrigin + V2i( ImagePlug::tileSize() ) );
-		if( !intersects( dw, tileBound ) || find( ch.begin(), ch.end(), it->first.channelName.string() ) == ch.end() )
+		if( !intersects( m_tilesBound, tileBound ) || find( ch.begin(), ch.end(), it->first.channelName.string() ) == ch.end() )
 		{
 			it = m_tiles.unsafe_erase( it );
 		}
@@ -415,6 +791,125 @@ void ImageGadget::removeOutOfBoundsTiles() const
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Viewport culling and proxy levels
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Level 8 is 256 times smaller than the original image, at
+// which point even the largest images fit in a handful of tiles.
+const int g_maxProxyLevel = 8;
+
+} // namespace
+
+bool ImageGadget::visibleRegion( Imath::Box2i &region, int &level ) const
+{
+	const ViewportGadget *viewport = ancestor<ViewportGadget>();
+	if( !viewport )
+	{
+		return false;
+	}
+
+	const V2f viewportSize( viewport->getViewport() );
+	if( viewportSize.x <= 0 || viewportSize.y <= 0 )
+	{
+		return false;
+	}
+
+	const LineSegment3f corner0 = viewport->rasterToGadgetSpace( V2f( 0 ), this );
+	const LineSegment3f corner1 = viewport->rasterToGadgetSpace( viewportSize, this );
+	Box2f visible;
+	visible.extendBy( V2f( corner0.p0.x, corner0.p0.y ) );
+	visible.extendBy( V2f( corner1.p0.x, corner1.p0.y ) );
+
+	// Choose the lowest resolution level which still provides
+	// at least one pixel for each pixel on screen.
+	const float pixelsPerRasterPixel = std::max( visible.size().x / viewportSize.x, visible.size().y / viewportSize.y );
+	level = 0;
+	while( level < g_maxProxyLevel && (float)( 2 << level ) <= pixelsPerRasterPixel )
+	{
+		level++;
+	}
+
+	// Convert to the pixel space of that level, rounding
+	// out to whole tiles.
+	const float scale = 1.0f / (float)( 1 << level );
+	const V2i min( Imath::floor( visible.min.x * scale ), Imath::floor( visible.min.y * scale ) );
+	const V2i max( Imath::ceil( visible.max.x * scale ), Imath::ceil( visible.max.y * scale ) );
+	region = Box2i(
+		ImagePlug::tileOrigin( min ),
+		ImagePlug::tileOrigin( max - V2i( 1 ) ) + V2i( ImagePlug::tileSize() )
+	);
+
+	return true;
+}
+
+void ImageGadget::viewportChanged()
+{
+	Box2i region;
+	int level;
+	if( !visibleRegion( region, level ) )
+	{
+		return;
+	}
+
+	// We only need new tiles if the level has changed or
+	// the user has panned or zoomed to reveal a region we
+	// don't yet have. Zooming in within a level can reuse
+	// the tiles we have already.
+	if( level != m_tilesLevel || !contains( m_tilesRegion, region ) )
+	{
+		dirty( TilesDirty );
+	}
+}
+
+const GafferImage::ImagePlug *ImageGadget::proxyImage( int level )
+{
+	if( !level )
+	{
+		return m_image.get();
+	}
+
+	if( m_proxyImages.size() <= (size_t)level )
+	{
+		m_proxyImages.resize( level + 1 );
+	}
+
+	ProxyImagePtr &proxy = m_proxyImages[level];
+	if( !proxy )
+	{
+		proxy = new ProxyImage( level );
+		proxy->inPlug()->setInput( const_cast<ImagePlug *>( m_image.get() ) );
+	}
+
+	return proxy->outPlug();
+}
+
+const GafferImage::ImagePlug *ImageGadget::tilesImage() const
+{
+	return m_tilesLevel ? m_proxyImages[m_tilesLevel]->outPlug() : m_image.get();
+}
+
+void ImageGadget::parentChanging( Gaffer::GraphComponent *newParent )
+{
+	Gadget::parentChanging( newParent );
+
+	// Track the viewport we're displayed in, so that we can
+	// update the visible tiles as it is panned and zoomed.
+	if( ViewportGadget *viewport = runTimeCast<ViewportGadget>( newParent ) )
+	{
+		m_viewportChangedConnection = viewport->viewportChangedSignal().connect( boost::bind( &ImageGadget::viewportChanged, this ) );
+		m_cameraChangedConnection = viewport->cameraChangedSignal().connect( boost::bind( &ImageGadget::viewportChanged, this ) );
+	}
+	else
+	{
+		m_viewportChangedConnection.disconnect();
+		m_cameraChangedConnection.disconnect();
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Rendering
 //////////////////////////////////////////////////////////////////////////
@@ -533,7 +1028,13 @@ void ImageGadget::renderTiles() const
 	glUniform1i( shader->uniformParameter( "blueTexture" )->location, textureUnits[2] );
 	glUniform1i( shader->uniformParameter( "alphaTexture" )->location, textureUnits[3] );
 
-	const Box2i dataWindow = this->dataWindow();
+	// Tiles are in the pixel space of the proxy level,
+	// so must be scaled up to match the full image.
+	glPushMatrix();
+	const float scale = (float)( 1 << m_tilesLevel );
+	glScalef( scale, scale, 1.0f );
+
+	const Box2i &dataWindow = m_tilesBound;
 
 	V2i tileOrigin = ImagePlug::tileOrigin( dataWindow.min );
 	for( ; tileOrigin.y < dataWindow.max.y; tileOrigin.y += ImagePlug::tileSize() )
@@ -587,6 +1088,8 @@ void ImageGadget::renderTiles() const
 		}
 	}
 
+	glPopMatrix();
+
 	glUseProgram( previousProgram );
 }
 
@@ -623,13 +1126,17 @@ void ImageGadget::doRender( const GafferUI::Style *style ) const
 	{
 		format = this->format();
 		dataWindow = this->dataWindow();
-		updateTiles();
 	}
 	catch( ... )
 	{
 		return;
 	}
 
+	// Upload any tiles computed since we were last drawn. The
+	// rest will be computed progressively by updateTiles().
+
+	uploadTiles();
+
 	// Render a black background the size of the image.
 
 	const Box2i &displayWindow = format.getDisplayWindow();
@@ -0,0 +1,301 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "GafferScene/Private/IECoreScenePreview/CapturingRenderer.h"
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+using namespace IECoreScenePreview;
+
+//////////////////////////////////////////////////////////////////////////
+// CapturingRenderer
+//////////////////////////////////////////////////////////////////////////
+
+Renderer::TypeDescription<CapturingRenderer> CapturingRenderer::g_typeDescription( "Capturing" );
+
+CapturingRenderer::CapturingRenderer( RenderType renderType, const std::string &fileName )
+	:	m_renderType( renderType ), m_numRenders( 0 )
+{
+}
+
+CapturingRenderer::~CapturingRenderer()
+{
+	// Detach any objects which will outlive us, so
+	// they don't try to release themselves from a
+	// destroyed renderer.
+	{
+		ObjectsMutex::scoped_lock lock( m_objectsMutex );
+		for( ObjectSet::const_iterator it = m_liveObjects.begin(), eIt = m_liveObjects.end(); it != eIt; ++it )
+		{
+			(*it)->m_renderer = NULL;
+		}
+		m_liveObjects.clear();
+		m_capturedObjects.clear();
+	}
+	m_retainedObjects.clear();
+}
+
+const IECore::Data *CapturingRenderer::capturedOption( const IECore::InternedString &name ) const
+{
+	OptionMap::const_iterator it = m_options.find( name );
+	return it != m_options.end() ? it->second.get() : NULL;
+}
+
+const Renderer::Output *CapturingRenderer::capturedOutput( const IECore::InternedString &name ) const
+{
+	OutputMap::const_iterator it = m_outputs.find( name );
+	return it != m_outputs.end() ? it->second.get() : NULL;
+}
+
+const CapturingRenderer::CapturedObject *CapturingRenderer::capturedObject( const std::string &name ) const
+{
+	ObjectsMutex::scoped_lock lock( m_objectsMutex );
+	ObjectMap::const_iterator it = m_capturedObjects.find( name );
+	return it != m_capturedObjects.end() ? it->second : NULL;
+}
+
+std::vector<std::string> CapturingRenderer::capturedObjectNames() const
+{
+	ObjectsMutex::scoped_lock lock( m_objectsMutex );
+	vector<string> result;
+	result.reserve( m_capturedObjects.size() );
+	for( ObjectMap::const_iterator it = m_capturedObjects.begin(), eIt = m_capturedObjects.end(); it != eIt; ++it )
+	{
+		result.push_back( it->first );
+	}
+	return result;
+}
+
+int CapturingRenderer::numRenders() const
+{
+	return m_numRenders;
+}
+
+void CapturingRenderer::option( const IECore::InternedString &name, const IECore::Data *value )
+{
+	if( value )
+	{
+		m_options[name] = value->copy();
+	}
+	else
+	{
+		m_options.erase( name );
+	}
+}
+
+void CapturingRenderer::output( const IECore::InternedString &name, const Output *output )
+{
+	if( output )
+	{
+		m_outputs[name] = output->copy();
+	}
+	else
+	{
+		m_outputs.erase( name );
+	}
+}
+
+Renderer::AttributesInterfacePtr CapturingRenderer::attributes( const IECore::CompoundObject *attributes )
+{
+	return new CapturedAttributes( attributes );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::camera( const std::string &name, const IECore::Camera *camera )
+{
+	return capture( name, vector<const Object *>( 1, camera ), vector<float>(), MurmurHash() );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::light( const std::string &name, const IECore::Object *object )
+{
+	return capture( name, object ? vector<const Object *>( 1, object ) : vector<const Object *>(), vector<float>(), MurmurHash() );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::object( const std::string &name, const IECore::Object *object )
+{
+	return capture( name, vector<const Object *>( 1, object ), vector<float>(), MurmurHash() );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times )
+{
+	return capture( name, samples, times, MurmurHash() );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::instance( const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash )
+{
+	return capture( name, vector<const Object *>( 1, object ), vector<float>(), hash );
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::instance( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash )
+{
+	return capture( name, samples, times, hash );
+}
+
+void CapturingRenderer::render()
+{
+	m_numRenders++;
+}
+
+void CapturingRenderer::pause()
+{
+}
+
+Renderer::ObjectInterfacePtr CapturingRenderer::capture( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash )
+{
+	CapturedObjectPtr result = new CapturedObject( this, name, samples, times, hash );
+
+	ObjectsMutex::scoped_lock lock( m_objectsMutex );
+	m_capturedObjects[name] = result.get();
+	m_liveObjects.insert( result.get() );
+	if( m_renderType != Interactive )
+	{
+		m_retainedObjects.push_back( result );
+	}
+
+	return result;
+}
+
+void CapturingRenderer::release( CapturedObject *object )
+{
+	ObjectsMutex::scoped_lock lock( m_objectsMutex );
+	m_liveObjects.erase( object );
+	ObjectMap::iterator it = m_capturedObjects.find( object->capturedName() );
+	if( it != m_capturedObjects.end() && it->second == object )
+	{
+		m_capturedObjects.erase( it );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// CapturingRenderer::CapturedAttributes
+//////////////////////////////////////////////////////////////////////////
+
+CapturingRenderer::CapturedAttributes::CapturedAttributes( const IECore::CompoundObject *attributes )
+	:	m_attributes( attributes->copy() )
+{
+}
+
+const IECore::CompoundObject *CapturingRenderer::CapturedAttributes::attributes() const
+{
+	return m_attributes.get();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// CapturingRenderer::CapturedObject
+//////////////////////////////////////////////////////////////////////////
+
+CapturingRenderer::CapturedObject::CapturedObject( CapturingRenderer *renderer, const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash )
+	:	m_renderer( renderer ), m_name( name ), m_capturedSampleTimes( times ), m_capturedHash( hash ), m_numTransformEdits( 0 ), m_numAttributeEdits( 0 )
+{
+	m_capturedSamples.reserve( samples.size() );
+	for( vector<const Object *>::const_iterator it = samples.begin(), eIt = samples.end(); it != eIt; ++it )
+	{
+		m_capturedSamples.push_back( (*it)->copy() );
+	}
+}
+
+CapturingRenderer::CapturedObject::~CapturedObject()
+{
+	if( m_renderer )
+	{
+		m_renderer->release( this );
+	}
+}
+
+const std::string &CapturingRenderer::CapturedObject::capturedName() const
+{
+	return m_name;
+}
+
+const std::vector<IECore::ConstObjectPtr> &CapturingRenderer::CapturedObject::capturedSamples() const
+{
+	return m_capturedSamples;
+}
+
+const std::vector<float> &CapturingRenderer::CapturedObject::capturedSampleTimes() const
+{
+	return m_capturedSampleTimes;
+}
+
+const IECore::MurmurHash &CapturingRenderer::CapturedObject::capturedHash() const
+{
+	return m_capturedHash;
+}
+
+const std::vector<Imath::M44f> &CapturingRenderer::CapturedObject::capturedTransforms() const
+{
+	return m_capturedTransforms;
+}
+
+const std::vector<float> &CapturingRenderer::CapturedObject::capturedTransformTimes() const
+{
+	return m_capturedTransformTimes;
+}
+
+const CapturingRenderer::CapturedAttributes *CapturingRenderer::CapturedObject::capturedAttributes() const
+{
+	return m_capturedAttributes.get();
+}
+
+int CapturingRenderer::CapturedObject::numTransformEdits() const
+{
+	return m_numTransformEdits;
+}
+
+int CapturingRenderer::CapturedObject::numAttributeEdits() const
+{
+	return m_numAttributeEdits;
+}
+
+void CapturingRenderer::CapturedObject::transform( const Imath::M44f &transform )
+{
+	m_capturedTransforms.assign( 1, transform );
+	m_capturedTransformTimes.clear();
+	m_numTransformEdits++;
+}
+
+void CapturingRenderer::CapturedObject::transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times )
+{
+	m_capturedTransforms = samples;
+	m_capturedTransformTimes = times;
+	m_numTransformEdits++;
+}
+
+void CapturingRenderer::CapturedObject::attributes( const AttributesInterface *attributes )
+{
+	m_capturedAttributes = static_cast<const CapturedAttributes *>( attributes );
+	m_numAttributeEdits++;
+}
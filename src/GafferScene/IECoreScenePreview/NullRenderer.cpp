@@ -0,0 +1,209 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/SimpleTypedData.h"
+
+#include "GafferScene/Private/IECoreScenePreview/NullRenderer.h"
+
+using namespace std;
+using namespace IECore;
+using namespace IECoreScenePreview;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Must be kept in sync with the NullRenderer::Call enum.
+const char *g_callNames[] = {
+	"option",
+	"output",
+	"attributes",
+	"camera",
+	"light",
+	"object",
+	"instance",
+	"transformEdit",
+	"attributesEdit",
+	"render",
+	"pause"
+};
+
+class NullAttributesInterface : public Renderer::AttributesInterface
+{
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// NullRenderer::NullObjectInterface
+//////////////////////////////////////////////////////////////////////////
+
+class NullRenderer::NullObjectInterface : public Renderer::ObjectInterface
+{
+
+	public :
+
+		NullObjectInterface( NullRenderer *renderer )
+			:	m_renderer( renderer )
+		{
+		}
+
+		virtual void transform( const Imath::M44f &transform )
+		{
+			m_renderer->count( TransformEditCall );
+		}
+
+		virtual void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times )
+		{
+			m_renderer->count( TransformEditCall );
+		}
+
+		virtual void attributes( const AttributesInterface *attributes )
+		{
+			m_renderer->count( AttributesEditCall );
+		}
+
+	private :
+
+		// Held by reference so that objects may safely
+		// outlive the client's reference to the renderer.
+		NullRendererPtr m_renderer;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// NullRenderer
+//////////////////////////////////////////////////////////////////////////
+
+Renderer::TypeDescription<NullRenderer> NullRenderer::g_typeDescription( "Null" );
+
+NullRenderer::NullRenderer( RenderType renderType, const std::string &fileName )
+	:	m_outputTime( 0 )
+{
+	for( int i = 0; i < NumCalls; ++i )
+	{
+		m_counts[i] = 0;
+	}
+}
+
+NullRenderer::~NullRenderer()
+{
+}
+
+IECore::CompoundDataPtr NullRenderer::statistics() const
+{
+	CompoundDataPtr result = new CompoundData;
+	for( int i = 0; i < NumCalls; ++i )
+	{
+		result->writable()[g_callNames[i]] = new UInt64Data( m_counts[i] );
+	}
+	result->writable()["outputTime"] = new DoubleData( m_outputTime );
+	return result;
+}
+
+void NullRenderer::option( const IECore::InternedString &name, const IECore::Data *value )
+{
+	count( OptionCall );
+}
+
+void NullRenderer::output( const IECore::InternedString &name, const Output *output )
+{
+	count( OutputCall );
+}
+
+Renderer::AttributesInterfacePtr NullRenderer::attributes( const IECore::CompoundObject *attributes )
+{
+	count( AttributesCall );
+	return new NullAttributesInterface;
+}
+
+Renderer::ObjectInterfacePtr NullRenderer::camera( const std::string &name, const IECore::Camera *camera )
+{
+	return nullObject( CameraCall );
+}
+
+Renderer::ObjectInterfacePtr NullRenderer::light( const std::string &name, const IECore::Object *object )
+{
+	return nullObject( LightCall );
+}
+
+Renderer::ObjectInterfacePtr NullRenderer::object( const std::string &name, const IECore::Object *object )
+{
+	return nullObject( ObjectCall );
+}
+
+Renderer::ObjectInterfacePtr NullRenderer::object( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times )
+{
+	return nullObject( ObjectCall );
+}
+
+Renderer::ObjectInterfacePtr NullRenderer::instance( const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash )
+{
+	return nullObject( InstanceCall );
+}
+
+Renderer::ObjectInterfacePtr NullRenderer::instance( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash )
+{
+	return nullObject( InstanceCall );
+}
+
+void NullRenderer::render()
+{
+	count( RenderCall );
+	m_outputTime = m_timer.totalElapsed();
+}
+
+void NullRenderer::pause()
+{
+	count( PauseCall );
+	// Start timing the edits which will
+	// follow, up until the next render().
+	m_timer = IECore::Timer();
+}
+
+void NullRenderer::count( Call call )
+{
+	++m_counts[call];
+}
+
+Renderer::ObjectInterfacePtr NullRenderer::nullObject( Call call )
+{
+	count( call );
+	return new NullObjectInterface( this );
+}
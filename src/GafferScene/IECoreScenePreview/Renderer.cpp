@@ -87,6 +87,16 @@ Renderer::ObjectInterface::~ObjectInterface()
 
 }
 
+Renderer::ObjectInterfacePtr Renderer::instance( const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash )
+{
+	return this->object( name, object );
+}
+
+Renderer::ObjectInterfacePtr Renderer::instance( const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const IECore::MurmurHash &hash )
+{
+	return this->object( name, samples, times );
+}
+
 const std::vector<IECore::InternedString> &Renderer::types()
 {
 	return ::types();
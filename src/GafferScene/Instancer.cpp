@@ -36,17 +36,21 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "tbb/parallel_reduce.h"
+#include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 
 #include "boost/lexical_cast.hpp"
+#include "boost/format.hpp"
 
 #include "IECore/VectorTypedData.h"
 #include "IECore/Primitive.h"
 
 #include "Gaffer/Context.h"
 #include "Gaffer/StringPlug.h"
+#include "Gaffer/TypedObjectPlug.h"
 
 #include "GafferScene/Instancer.h"
+#include "GafferScene/InstancerCapsule.h"
 
 using namespace std;
 using namespace tbb;
@@ -55,6 +59,364 @@ using namespace IECore;
 using namespace Gaffer;
 using namespace GafferScene;
 
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+InternedString g_idContextName( "instancer:id" );
+
+template<typename T>
+const typename T::ValueType *primitiveVariable( const Primitive *primitive, const std::string &name, size_t size )
+{
+	if( name.empty() )
+	{
+		return NULL;
+	}
+
+	const T *data = primitive->variableData<T>( name );
+	if( !data )
+	{
+		return NULL;
+	}
+
+	if( data->readable().size() != size )
+	{
+		throw IECore::Exception( boost::str(
+			boost::format( "Primitive variable \"%s\" has wrong size (%d, but should be %d to match P)" ) % name % data->readable().size() % size
+		) );
+	}
+
+	return &data->readable();
+}
+
+// Unlike the other primitive variables, the prototype index is mandatory
+// when it has been specified, since we can't sensibly choose prototypes
+// without it.
+const vector<int> &prototypeIndices( const Primitive *primitive, const std::string &name, size_t size )
+{
+	const vector<int> *indices = primitiveVariable<IntVectorData>( primitive, name, size );
+	if( !indices )
+	{
+		throw IECore::Exception( boost::str(
+			boost::format( "Prototype index primitive variable \"%s\" does not exist or is not of type IntVectorData" ) % name
+		) );
+	}
+	return *indices;
+}
+
+// Wraps out of range indices, so that every instance gets a prototype.
+size_t wrapPrototypeIndex( int index, size_t numPrototypes )
+{
+	const int n = numPrototypes;
+	const int i = index % n;
+	return i < 0 ? i + n : i;
+}
+
+void hashHierarchy( const ScenePlug *scene, const ScenePlug::ScenePath &path, MurmurHash &h );
+
+// Hashes the hierarchies below a range of children in parallel,
+// storing the results so they may be combined in a deterministic
+// order.
+struct ChildHierarchyHash
+{
+
+	ChildHierarchyHash( const ScenePlug *scene, const Context *context, const ScenePlug::ScenePath &parentPath, const vector<InternedString> &childNames, vector<MurmurHash> &hashes )
+		:	m_scene( scene ), m_context( context ), m_parentPath( parentPath ), m_childNames( childNames ), m_hashes( hashes )
+	{
+	}
+
+	void operator() ( const blocked_range<size_t> &r ) const
+	{
+		Context::Scope scopedContext( m_context );
+		ScenePlug::ScenePath childPath( m_parentPath );
+		childPath.push_back( InternedString() ); // room for the child name
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			childPath.back() = m_childNames[i];
+			hashHierarchy( m_scene, childPath, m_hashes[i] );
+		}
+	}
+
+	private :
+
+		const ScenePlug *m_scene;
+		const Context *m_context;
+		const ScenePlug::ScenePath &m_parentPath;
+		const vector<InternedString> &m_childNames;
+		vector<MurmurHash> &m_hashes;
+
+};
+
+void hashHierarchy( const ScenePlug *scene, const ScenePlug::ScenePath &path, MurmurHash &h )
+{
+	h.append( scene->boundHash( path ) );
+	h.append( scene->transformHash( path ) );
+	h.append( scene->attributesHash( path ) );
+	h.append( scene->objectHash( path ) );
+
+	ConstInternedStringVectorDataPtr childNamesData = scene->childNames( path );
+	childNamesData->hash( h );
+
+	const vector<InternedString> &childNames = childNamesData->readable();
+	if( childNames.empty() )
+	{
+		return;
+	}
+
+	vector<MurmurHash> childHashes( childNames.size() );
+	parallel_for(
+		blocked_range<size_t>( 0, childNames.size() ),
+		ChildHierarchyHash( scene, Context::current(), path, childNames, childHashes )
+	);
+
+	for( vector<MurmurHash>::const_iterator it = childHashes.begin(), eIt = childHashes.end(); it != eIt; ++it )
+	{
+		h.append( *it );
+	}
+}
+
+// Bits recording which children of a ScenePlug read "instancer:id"
+// somewhere within a hierarchy.
+enum IdDependency
+{
+	BoundDependsOnId = 1,
+	TransformDependsOnId = 2,
+	AttributesDependsOnId = 4,
+	ObjectDependsOnId = 8,
+	ChildNamesDependsOnId = 16
+};
+
+int idDependency( const ScenePlug *scene, const ValuePlug *plug )
+{
+	if( plug == scene->boundPlug() )
+	{
+		return BoundDependsOnId;
+	}
+	else if( plug == scene->transformPlug() )
+	{
+		return TransformDependsOnId;
+	}
+	else if( plug == scene->attributesPlug() )
+	{
+		return AttributesDependsOnId;
+	}
+	else if( plug == scene->objectPlug() )
+	{
+		return ObjectDependsOnId;
+	}
+	else if( plug == scene->childNamesPlug() )
+	{
+		return ChildNamesDependsOnId;
+	}
+	return 0;
+}
+
+int idDependencies( const ScenePlug *scene, const ScenePlug::ScenePath &path );
+
+// Finds the id dependencies of the hierarchies below a range
+// of children in parallel.
+struct ChildIdDependencies
+{
+
+	ChildIdDependencies( const ScenePlug *scene, const Context *context, const ScenePlug::ScenePath &parentPath, const vector<InternedString> &childNames, vector<int> &dependencies )
+		:	m_scene( scene ), m_context( context ), m_parentPath( parentPath ), m_childNames( childNames ), m_dependencies( dependencies )
+	{
+	}
+
+	void operator() ( const blocked_range<size_t> &r ) const
+	{
+		Context::Scope scopedContext( m_context );
+		ScenePlug::ScenePath childPath( m_parentPath );
+		childPath.push_back( InternedString() ); // room for the child name
+		for( size_t i = r.begin(); i != r.end(); ++i )
+		{
+			childPath.back() = m_childNames[i];
+			m_dependencies[i] = idDependencies( m_scene, childPath );
+		}
+	}
+
+	private :
+
+		const ScenePlug *m_scene;
+		const Context *m_context;
+		const ScenePlug::ScenePath &m_parentPath;
+		const vector<InternedString> &m_childNames;
+		vector<int> &m_dependencies;
+
+};
+
+// Returns a combination of IdDependency bits for the
+// hierarchy below `path`.
+int idDependencies( const ScenePlug *scene, const ScenePlug::ScenePath &path )
+{
+	ContextPtr context = new Context( *Context::current(), Context::Borrowed );
+	context->set( ScenePlug::scenePathContextName, path );
+	context->set( g_idContextName, 0 );
+	Context::Scope scopedContext( context.get() );
+
+	// The hash of a plug accounts for every context variable read
+	// in computing it, including those read by upstream nodes, so
+	// a single hash is enough to tell us whether or not the id is
+	// used. The hashes are cached, so are reused when the instances
+	// themselves are evaluated.
+	const ValuePlug *plugs[] = {
+		scene->boundPlug(),
+		scene->transformPlug(),
+		scene->attributesPlug(),
+		scene->objectPlug(),
+		scene->childNamesPlug()
+	};
+
+	int result = 0;
+	for( size_t i = 0; i < sizeof( plugs ) / sizeof( plugs[0] ); ++i )
+	{
+		Context::ReadRecorder readRecorder( context.get() );
+		plugs[i]->hash();
+		if( readRecorder.read( g_idContextName ) )
+		{
+			result |= idDependency( scene, plugs[i] );
+		}
+	}
+
+	ConstInternedStringVectorDataPtr childNamesData = scene->childNamesPlug()->getValue();
+	const vector<InternedString> &childNames = childNamesData->readable();
+	if( childNames.empty() )
+	{
+		return result;
+	}
+
+	vector<int> childDependencies( childNames.size(), 0 );
+	parallel_for(
+		blocked_range<size_t>( 0, childNames.size() ),
+		ChildIdDependencies( scene, context.get(), path, childNames, childDependencies )
+	);
+
+	for( vector<int>::const_iterator it = childDependencies.begin(), eIt = childDependencies.end(); it != eIt; ++it )
+	{
+		result |= *it;
+	}
+
+	return result;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Instances implementation
+//////////////////////////////////////////////////////////////////////////
+
+Instancer::Instances::Instances( ConstPrimitivePtr primitive, const InternedStringVectorData *prototypeNames, const std::string &prototypeIndexName, const std::string &orientationName, const std::string &scaleName )
+	:	m_primitive( primitive ), m_p( NULL ), m_indices( NULL ), m_orientations( NULL ), m_scales( NULL ), m_uniformScales( NULL )
+{
+	if( prototypeNames )
+	{
+		const vector<InternedString> &names = prototypeNames->readable();
+		for( vector<InternedString>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+		{
+			m_prototypeRoots.push_back( ScenePath( 1, *it ) );
+		}
+	}
+	else
+	{
+		m_prototypeRoots.push_back( ScenePath() );
+	}
+
+	if( !m_primitive || m_prototypeRoots.empty() )
+	{
+		return;
+	}
+
+	const V3fVectorData *p = m_primitive->variableData<V3fVectorData>( "P" );
+	if( !p )
+	{
+		return;
+	}
+
+	m_p = &p->readable();
+	const size_t size = m_p->size();
+
+	if( prototypeNames )
+	{
+		m_indices = &prototypeIndices( m_primitive.get(), prototypeIndexName, size );
+	}
+	m_orientations = primitiveVariable<QuatfVectorData>( m_primitive.get(), orientationName, size );
+	m_scales = primitiveVariable<V3fVectorData>( m_primitive.get(), scaleName, size );
+	if( !m_scales )
+	{
+		m_uniformScales = primitiveVariable<FloatVectorData>( m_primitive.get(), scaleName, size );
+	}
+}
+
+Instancer::Instances::~Instances()
+{
+}
+
+size_t Instancer::Instances::numInstances() const
+{
+	return m_p ? m_p->size() : 0;
+}
+
+size_t Instancer::Instances::numPrototypes() const
+{
+	return m_prototypeRoots.size();
+}
+
+size_t Instancer::Instances::prototypeIndex( size_t instanceId ) const
+{
+	if( !m_indices || instanceId >= m_indices->size() )
+	{
+		return 0;
+	}
+	return wrapPrototypeIndex( (*m_indices)[instanceId], m_prototypeRoots.size() );
+}
+
+const Instancer::ScenePath &Instancer::Instances::prototypeRoot( size_t prototypeIndex ) const
+{
+	return m_prototypeRoots[prototypeIndex];
+}
+
+Imath::M44f Instancer::Instances::transform( size_t instanceId ) const
+{
+	M44f result;
+	if( m_orientations )
+	{
+		result = (*m_orientations)[instanceId].normalized().toMatrix44();
+	}
+	if( m_scales )
+	{
+		result = M44f().scale( (*m_scales)[instanceId] ) * result;
+	}
+	else if( m_uniformScales )
+	{
+		result = M44f().scale( V3f( (*m_uniformScales)[instanceId] ) ) * result;
+	}
+	const V3f &p = (*m_p)[instanceId];
+	result[3][0] = p.x;
+	result[3][1] = p.y;
+	result[3][2] = p.z;
+	return result;
+}
+
+void Instancer::Instances::memoryUsage( IECore::Object::MemoryAccumulator &accumulator ) const
+{
+	accumulator.accumulate( sizeof( Instances ) );
+	if( m_primitive )
+	{
+		accumulator.accumulate( m_primitive.get() );
+	}
+	for( vector<ScenePath>::const_iterator it = m_prototypeRoots.begin(), eIt = m_prototypeRoots.end(); it != eIt; ++it )
+	{
+		accumulator.accumulate( sizeof( ScenePath ) + it->capacity() * sizeof( InternedString ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Instancer
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( Instancer );
 
 size_t Instancer::g_firstPlugIndex = 0;
@@ -65,6 +427,11 @@ Instancer::Instancer( const std::string &name )
 	storeIndexOfNextChild( g_firstPlugIndex );
 	addChild( new StringPlug( "name", Plug::In, "instances" ) );
 	addChild( new ScenePlug( "instance" ) );
+	addChild( new StringPlug( "prototypeIndex", Plug::In, "" ) );
+	addChild( new StringPlug( "orientation", Plug::In, "" ) );
+	addChild( new StringPlug( "scale", Plug::In, "" ) );
+	addChild( new BoolPlug( "encapsulate", Plug::In, false ) );
+	addChild( new ObjectPlug( "__prototypeIdDependencies", Plug::Out, new IntVectorData ) );
 }
 
 Instancer::~Instancer()
@@ -91,13 +458,83 @@ const ScenePlug *Instancer::instancePlug() const
 	return getChild<ScenePlug>( g_firstPlugIndex + 1 );
 }
 
+Gaffer::StringPlug *Instancer::prototypeIndexPlug()
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 2 );
+}
+
+const Gaffer::StringPlug *Instancer::prototypeIndexPlug() const
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 2 );
+}
+
+Gaffer::StringPlug *Instancer::orientationPlug()
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 3 );
+}
+
+const Gaffer::StringPlug *Instancer::orientationPlug() const
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 3 );
+}
+
+Gaffer::StringPlug *Instancer::scalePlug()
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 4 );
+}
+
+const Gaffer::StringPlug *Instancer::scalePlug() const
+{
+	return getChild<StringPlug>( g_firstPlugIndex + 4 );
+}
+
+Gaffer::BoolPlug *Instancer::encapsulatePlug()
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 5 );
+}
+
+const Gaffer::BoolPlug *Instancer::encapsulatePlug() const
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 5 );
+}
+
+Gaffer::ObjectPlug *Instancer::prototypeIdDependenciesPlug()
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 6 );
+}
+
+const Gaffer::ObjectPlug *Instancer::prototypeIdDependenciesPlug() const
+{
+	return getChild<ObjectPlug>( g_firstPlugIndex + 6 );
+}
+
 void Instancer::affects( const Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	BranchCreator::affects( input, outputs );
 
 	if( input->parent<ScenePlug>() == instancePlug() )
 	{
+		outputs.push_back( prototypeIdDependenciesPlug() );
 		outputs.push_back( outPlug()->getChild<ValuePlug>( input->getName() ) );
+		if( input != instancePlug()->objectPlug() )
+		{
+			// The InstancerCapsule hash depends on the whole
+			// of the prototype hierarchies.
+			outputs.push_back( outPlug()->objectPlug() );
+		}
+		if( input == instancePlug()->childNamesPlug() )
+		{
+			// The children of the root are used as prototypes,
+			// so affect the placement of the instances, and
+			// which prototype provides their attributes.
+			outputs.push_back( outPlug()->boundPlug() );
+			outputs.push_back( outPlug()->transformPlug() );
+			outputs.push_back( outPlug()->attributesPlug() );
+		}
+		else if( input == instancePlug()->transformPlug() )
+		{
+			outputs.push_back( outPlug()->boundPlug() );
+		}
 	}
 	else if( input == namePlug() )
 	{
@@ -108,19 +545,93 @@ void Instancer::affects( const Plug *input, AffectedPlugsContainer &outputs ) co
 		outputs.push_back( outPlug()->childNamesPlug() );
 		outputs.push_back( outPlug()->boundPlug() );
 		outputs.push_back( outPlug()->transformPlug() );
+		// The prototype index primitive variable determines
+		// which prototype provides the attributes and object
+		// for each instance, and the points are also held by
+		// the InstancerCapsule when encapsulating.
+		outputs.push_back( outPlug()->attributesPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+	}
+	else if( input == prototypeIndexPlug() )
+	{
+		outputs.push_back( prototypeIdDependenciesPlug() );
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->transformPlug() );
+		outputs.push_back( outPlug()->attributesPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+		outputs.push_back( outPlug()->childNamesPlug() );
+	}
+	else if( input == orientationPlug() || input == scalePlug() )
+	{
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->transformPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+	}
+	else if( input == encapsulatePlug() )
+	{
+		outputs.push_back( outPlug()->objectPlug() );
+		outputs.push_back( outPlug()->childNamesPlug() );
+	}
+	else if( input == prototypeIdDependenciesPlug() )
+	{
+		outputs.push_back( outPlug()->boundPlug() );
+		outputs.push_back( outPlug()->transformPlug() );
+		outputs.push_back( outPlug()->attributesPlug() );
+		outputs.push_back( outPlug()->objectPlug() );
+		outputs.push_back( outPlug()->childNamesPlug() );
+	}
+}
+
+void Instancer::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	BranchCreator::hash( output, context, h );
+
+	if( output == prototypeIdDependenciesPlug() )
+	{
+		prototypeIndexPlug()->hash( h );
+		ContextPtr ic = new Context( *context, Context::Borrowed );
+		ic->set( g_idContextName, 0 );
+		Context::Scope scopedContext( ic.get() );
+		hashHierarchy( instancePlug(), ScenePath(), h );
+	}
+}
+
+void Instancer::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
+{
+	if( output == prototypeIdDependenciesPlug() )
+	{
+		IntVectorDataPtr resultData = new IntVectorData;
+		vector<int> &result = resultData->writable();
+		if( prototypeIndexPlug()->getValue().empty() )
+		{
+			result.push_back( idDependencies( instancePlug(), ScenePath() ) );
+		}
+		else
+		{
+			ConstInternedStringVectorDataPtr prototypeNames = instancePlug()->childNames( ScenePath() );
+			const vector<InternedString> &names = prototypeNames->readable();
+			for( vector<InternedString>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+			{
+				result.push_back( idDependencies( instancePlug(), ScenePath( 1, *it ) ) );
+			}
+		}
+		static_cast<ObjectPlug *>( output )->setValue( resultData );
+		return;
 	}
+
+	BranchCreator::compute( output, context );
 }
 
 struct Instancer::BoundHash
 {
 
-	BoundHash( const Instancer *instancer, const ScenePath &branchPath, const Context *c )
-		:	m_instancer( instancer ), m_branchPath( branchPath ), m_context( c ), m_hash()
+	BoundHash( const Instancer *instancer, const Instances *instances, const vector<int> &idDependencies, const Context *c )
+		:	m_instancer( instancer ), m_instances( instances ), m_idDependencies( idDependencies ), m_context( c ), m_hash()
 	{
 	}
 
 	BoundHash( const BoundHash &rhs, split )
-		:	m_instancer( rhs.m_instancer ), m_branchPath( rhs.m_branchPath ), m_context( rhs.m_context ), m_hash()
+		:	m_instancer( rhs.m_instancer ), m_instances( rhs.m_instances ), m_idDependencies( rhs.m_idDependencies ), m_context( rhs.m_context ), m_hash()
 	{
 	}
 
@@ -129,16 +640,19 @@ struct Instancer::BoundHash
 		ContextPtr ic = new Context( *m_context, Context::Borrowed );
 		Context::Scope scopedContext( ic.get() );
 
-		ScenePath branchChildPath( m_branchPath );
-		branchChildPath.push_back( InternedString() ); // where we'll place the instance index
-
 		for( size_t i=r.begin(); i!=r.end(); ++i )
 		{
-			branchChildPath[branchChildPath.size()-1] = InternedString( i );
-			m_instancer->fillInstanceContext( ic.get(), branchChildPath, i );
+			const size_t prototypeIndex = m_instances->prototypeIndex( i );
+			const ScenePath &prototypeRoot = m_instances->prototypeRoot( prototypeIndex );
+			m_instancer->fillInstanceContext( ic.get(), prototypeRoot, i, m_idDependencies[prototypeIndex], m_instancer->instancePlug()->boundPlug() );
 			m_instancer->instancePlug()->boundPlug()->hash( m_hash );
-			// no need to hash transform of instance because we know all
-			// root transforms are identity.
+			if( prototypeRoot.size() )
+			{
+				m_instancer->fillInstanceContext( ic.get(), prototypeRoot, i, m_idDependencies[prototypeIndex], m_instancer->instancePlug()->transformPlug() );
+				m_instancer->instancePlug()->transformPlug()->hash( m_hash );
+			}
+			// no need to hash transform of the instance root because we
+			// know all root transforms are identity.
 		}
 	}
 
@@ -155,7 +669,8 @@ struct Instancer::BoundHash
 	private :
 
 		const Instancer *m_instancer;
-		const ScenePath &m_branchPath;
+		const Instances *m_instances;
+		const vector<int> &m_idDependencies;
 		const Context *m_context;
 		MurmurHash m_hash;
 
@@ -169,29 +684,45 @@ void Instancer::hashBranchBound( const ScenePath &parentPath, const ScenePath &b
 
 		BranchCreator::hashBranchBound( parentPath, branchPath, context, h );
 
-		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
-		if( p )
+		ConstInstancesPtr instances = this->instances( parentPath );
+		if( instances->numInstances() )
 		{
-			p->hash( h );
+			hashInstances( parentPath, h );
 
-			ScenePath branchChildPath( branchPath );
-			if( branchChildPath.size() == 0 )
+			ConstIntVectorDataPtr idDependencies = prototypeIdDependencies( context );
+			if( !prototypesDependOnId( idDependencies->readable() ) )
 			{
-				branchChildPath.push_back( namePlug()->getValue() );
+				// All instances of each prototype share the same
+				// bound, so we only need to hash it once.
+				ContextPtr ic = new Context( *context, Context::Borrowed );
+				Context::Scope scopedContext( ic.get() );
+				for( size_t i = 0; i < instances->numPrototypes(); ++i )
+				{
+					const ScenePath &prototypeRoot = instances->prototypeRoot( i );
+					fillInstanceContext( ic.get(), prototypeRoot, 0, 0, instancePlug()->boundPlug() );
+					instancePlug()->boundPlug()->hash( h );
+					if( prototypeRoot.size() )
+					{
+						fillInstanceContext( ic.get(), prototypeRoot, 0, 0, instancePlug()->transformPlug() );
+						instancePlug()->transformPlug()->hash( h );
+					}
+				}
 			}
+			else
+			{
+				BoundHash hasher( this, instances.get(), idDependencies->readable(), context );
+				parallel_deterministic_reduce(
+					blocked_range<size_t>( 0, instances->numInstances(), 100 ),
+					hasher
+				);
 
-			BoundHash hasher( this, branchChildPath, context );
-			parallel_deterministic_reduce(
-				blocked_range<size_t>( 0, p->readable().size(), 100 ),
-				hasher
-			);
-
-			h.append( hasher.result() );
+				h.append( hasher.result() );
+			}
 		}
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->boundPlug() );
 		Context::Scope scopedContext( ic.get() );
 		h = instancePlug()->boundPlug()->hash();
 	}
@@ -200,32 +731,46 @@ void Instancer::hashBranchBound( const ScenePath &parentPath, const ScenePath &b
 struct Instancer::BoundUnion
 {
 
-	BoundUnion( const Instancer *instancer, const ScenePath &branchPath, const Context *c, const V3fVectorData *p )
-		:	m_instancer( instancer ), m_branchPath( branchPath ), m_context( c ), m_p( p ), m_union()
+	BoundUnion( const Instancer *instancer, const Instances *instances, const vector<int> &idDependencies, const Context *c, const vector<Box3f> *sharedBounds )
+		:	m_instancer( instancer ), m_instances( instances ), m_idDependencies( idDependencies ), m_context( c ), m_sharedBounds( sharedBounds ), m_union()
 	{
 	}
 
 	BoundUnion( const BoundUnion &rhs, split )
-		:	m_instancer( rhs.m_instancer ), m_branchPath( rhs.m_branchPath ), m_context( rhs.m_context ), m_p( rhs.m_p ), m_union()
+		:	m_instancer( rhs.m_instancer ), m_instances( rhs.m_instances ), m_idDependencies( rhs.m_idDependencies ), m_context( rhs.m_context ), m_sharedBounds( rhs.m_sharedBounds ), m_union()
 	{
 	}
 
 	void operator() ( const blocked_range<size_t> &r )
 	{
+		if( m_sharedBounds )
+		{
+			for( size_t i=r.begin(); i!=r.end(); ++i )
+			{
+				const Box3f &prototypeBound = (*m_sharedBounds)[m_instances->prototypeIndex( i )];
+				m_union.extendBy( transform( prototypeBound, m_instances->transform( i ) ) );
+			}
+			return;
+		}
+
 		ContextPtr ic = new Context( *m_context, Context::Borrowed );
 		Context::Scope scopedContext( ic.get() );
 
-		ScenePath branchChildPath( m_branchPath );
-		branchChildPath.push_back( InternedString() ); // where we'll place the instance index
-
 		for( size_t i=r.begin(); i!=r.end(); ++i )
 		{
-			branchChildPath[branchChildPath.size()-1] = InternedString( i );
-			m_instancer->fillInstanceContext( ic.get(), branchChildPath, i );
-
+			const size_t prototypeIndex = m_instances->prototypeIndex( i );
+			const ScenePath &prototypeRoot = m_instances->prototypeRoot( prototypeIndex );
+			m_instancer->fillInstanceContext( ic.get(), prototypeRoot, i, m_idDependencies[prototypeIndex], m_instancer->instancePlug()->boundPlug() );
 			Box3f branchChildBound = m_instancer->instancePlug()->boundPlug()->getValue();
-			branchChildBound = transform( branchChildBound, m_instancer->instanceTransform( m_p, i ) );
-			m_union.extendBy( branchChildBound );
+
+			M44f branchChildTransform = m_instances->transform( i );
+			if( prototypeRoot.size() )
+			{
+				m_instancer->fillInstanceContext( ic.get(), prototypeRoot, i, m_idDependencies[prototypeIndex], m_instancer->instancePlug()->transformPlug() );
+				branchChildTransform = m_instancer->instancePlug()->transformPlug()->getValue() * branchChildTransform;
+			}
+
+			m_union.extendBy( transform( branchChildBound, branchChildTransform ) );
 		}
 	}
 
@@ -242,9 +787,10 @@ struct Instancer::BoundUnion
 	private :
 
 		const Instancer *m_instancer;
-		const ScenePath &m_branchPath;
+		const Instances *m_instances;
+		const vector<int> &m_idDependencies;
 		const Context *m_context;
-		const V3fVectorData *m_p;
+		const vector<Box3f> *m_sharedBounds;
 		Box3f m_union;
 
 };
@@ -255,18 +801,35 @@ Imath::Box3f Instancer::computeBranchBound( const ScenePath &parentPath, const S
 	{
 		// "/" or "/name"
 		Box3f result;
-		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
-		if( p )
+		ConstInstancesPtr instances = this->instances( parentPath );
+		if( instances->numInstances() )
 		{
-			ScenePath branchChildPath( branchPath );
-			if( branchChildPath.size() == 0 )
+			// If all instances of a prototype share the same bound,
+			// compute it only once rather than once per instance.
+			vector<Box3f> sharedBounds;
+			ConstIntVectorDataPtr idDependencies = prototypeIdDependencies( context );
+			const bool shared = !prototypesDependOnId( idDependencies->readable() );
+			if( shared )
 			{
-				branchChildPath.push_back( namePlug()->getValue() );
+				ContextPtr ic = new Context( *context, Context::Borrowed );
+				Context::Scope scopedContext( ic.get() );
+				for( size_t i = 0; i < instances->numPrototypes(); ++i )
+				{
+					const ScenePath &prototypeRoot = instances->prototypeRoot( i );
+					fillInstanceContext( ic.get(), prototypeRoot, 0, 0, instancePlug()->boundPlug() );
+					Box3f b = instancePlug()->boundPlug()->getValue();
+					if( prototypeRoot.size() )
+					{
+						fillInstanceContext( ic.get(), prototypeRoot, 0, 0, instancePlug()->transformPlug() );
+						b = transform( b, instancePlug()->transformPlug()->getValue() );
+					}
+					sharedBounds.push_back( b );
+				}
 			}
 
-			BoundUnion unioner( this, branchChildPath, context, p.get() );
+			BoundUnion unioner( this, instances.get(), idDependencies->readable(), context, shared ? &sharedBounds : NULL );
 			parallel_reduce(
-				blocked_range<size_t>( 0, p->readable().size() ),
+				blocked_range<size_t>( 0, instances->numInstances() ),
 				unioner
 			);
 
@@ -277,7 +840,7 @@ Imath::Box3f Instancer::computeBranchBound( const ScenePath &parentPath, const S
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->boundPlug() );
 		Context::Scope scopedContext( ic.get() );
 		return instancePlug()->boundPlug()->getValue();
 	}
@@ -294,12 +857,24 @@ void Instancer::hashBranchTransform( const ScenePath &parentPath, const ScenePat
 	{
 		// "/name/instanceNumber"
 		BranchCreator::hashBranchTransform( parentPath, branchPath, context, h );
-		h.append( inPlug()->objectHash( parentPath ) );
-		h.append( instanceIndex( branchPath ) );
+		hashInstances( parentPath, h );
+		const int index = instanceIndex( branchPath );
+		h.append( index );
+
+		ConstInstancesPtr instances = this->instances( parentPath );
+		const size_t prototypeIndex = instances->prototypeIndex( index );
+		const ScenePath &prototypeRoot = instances->prototypeRoot( prototypeIndex );
+		if( prototypeRoot.size() )
+		{
+			ContextPtr ic = new Context( *context, Context::Borrowed );
+			fillInstanceContext( ic.get(), prototypeRoot, index, prototypeIdDependencies( context )->readable()[prototypeIndex], instancePlug()->transformPlug() );
+			Context::Scope scopedContext( ic.get() );
+			instancePlug()->transformPlug()->hash( h );
+		}
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->transformPlug() );
 		Context::Scope scopedContext( ic.get() );
 		h = instancePlug()->transformPlug()->hash();
 	}
@@ -315,13 +890,27 @@ Imath::M44f Instancer::computeBranchTransform( const ScenePath &parentPath, cons
 	else if( branchPath.size() == 2 )
 	{
 		// "/name/instanceNumber"
-		int index = instanceIndex( branchPath );
-		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
-		return instanceTransform( p.get(), index );
+		const int index = instanceIndex( branchPath );
+		ConstInstancesPtr instances = this->instances( parentPath );
+		M44f result = instances->transform( index );
+
+		// The transform of the prototype root is
+		// applied before that of the instance.
+		const size_t prototypeIndex = instances->prototypeIndex( index );
+		const ScenePath &prototypeRoot = instances->prototypeRoot( prototypeIndex );
+		if( prototypeRoot.size() )
+		{
+			ContextPtr ic = new Context( *context, Context::Borrowed );
+			fillInstanceContext( ic.get(), prototypeRoot, index, prototypeIdDependencies( context )->readable()[prototypeIndex], instancePlug()->transformPlug() );
+			Context::Scope scopedContext( ic.get() );
+			result = instancePlug()->transformPlug()->getValue() * result;
+		}
+
+		return result;
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->transformPlug() );
 		Context::Scope scopedContext( ic.get() );
 		return instancePlug()->transformPlug()->getValue();
 	}
@@ -336,7 +925,7 @@ void Instancer::hashBranchAttributes( const ScenePath &parentPath, const ScenePa
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->attributesPlug() );
 		Context::Scope scopedContext( ic.get() );
 		h = instancePlug()->attributesPlug()->hash();
 	}
@@ -351,7 +940,7 @@ IECore::ConstCompoundObjectPtr Instancer::computeBranchAttributes( const ScenePa
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->attributesPlug() );
 		Context::Scope scopedContext( ic.get() );
 		return instancePlug()->attributesPlug()->getValue();
 	}
@@ -359,14 +948,24 @@ IECore::ConstCompoundObjectPtr Instancer::computeBranchAttributes( const ScenePa
 
 void Instancer::hashBranchObject( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
-	if( branchPath.size() <= 1 )
+	if( branchPath.size() == 1 && encapsulatePlug()->getValue() )
+	{
+		// "/name", encapsulated
+		// The prototype hierarchies are hashed in full by hashPrototypes(),
+		// so capsules with equal hashes expand to identical instances.
+		BranchCreator::hashBranchObject( parentPath, branchPath, context, h );
+		hashInstances( parentPath, h );
+		ConstInstancesPtr instances = this->instances( parentPath );
+		hashPrototypes( instances.get(), context, h );
+	}
+	else if( branchPath.size() <= 1 )
 	{
 		// "/" or "/name"
 		h = outPlug()->objectPlug()->defaultValue()->Object::hash();
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->objectPlug() );
 		Context::Scope scopedContext( ic.get() );
 		h = instancePlug()->objectPlug()->hash();
 	}
@@ -374,14 +973,23 @@ void Instancer::hashBranchObject( const ScenePath &parentPath, const ScenePath &
 
 IECore::ConstObjectPtr Instancer::computeBranchObject( const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::Context *context ) const
 {
-	if( branchPath.size() <= 1 )
+	if( branchPath.size() == 1 && encapsulatePlug()->getValue() )
+	{
+		// "/name", encapsulated
+		return new InstancerCapsule(
+			instancePlug(), instances( parentPath ), context,
+			outPlug()->objectPlug()->hash(),
+			outPlug()->boundPlug()->getValue()
+		);
+	}
+	else if( branchPath.size() <= 1 )
 	{
 		// "/" or "/name"
 		return outPlug()->objectPlug()->defaultValue();
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->objectPlug() );
 		Context::Scope scopedContext( ic.get() );
 		return instancePlug()->objectPlug()->getValue();
 	}
@@ -399,12 +1007,17 @@ void Instancer::hashBranchChildNames( const ScenePath &parentPath, const ScenePa
 	{
 		// "/name"
 		BranchCreator::hashBranchChildNames( parentPath, branchPath, context, h );
-		h.append( inPlug()->objectHash( parentPath ) );
+		encapsulatePlug()->hash( h );
+		if( encapsulatePlug()->getValue() )
+		{
+			return;
+		}
+		hashInstances( parentPath, h );
 	}
 	else
 	{
 		// "/name/..."
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->childNamesPlug() );
 		Context::Scope scopedContext( ic.get() );
 		h = instancePlug()->childNamesPlug()->hash();
 	}
@@ -426,13 +1039,20 @@ IECore::ConstInternedStringVectorDataPtr Instancer::computeBranchChildNames( con
 	}
 	else if( branchPath.size() == 1 )
 	{
-		ConstV3fVectorDataPtr p = sourcePoints( parentPath );
-		if( !p || !p->readable().size() )
+		if( encapsulatePlug()->getValue() )
+		{
+			// The instances are represented by an InstancerCapsule
+			// rather than by child locations.
+			return outPlug()->childNamesPlug()->defaultValue();
+		}
+
+		ConstInstancesPtr instances = this->instances( parentPath );
+		if( !instances->numInstances() )
 		{
 			return outPlug()->childNamesPlug()->defaultValue();
 		}
 
-		const size_t s = p->readable().size();
+		const size_t s = instances->numInstances();
 		InternedStringVectorDataPtr resultData = new InternedStringVectorData();
 		vector<InternedString> &result = resultData->writable();
 		result.resize( s );
@@ -446,21 +1066,36 @@ IECore::ConstInternedStringVectorDataPtr Instancer::computeBranchChildNames( con
 	}
 	else
 	{
-		ContextPtr ic = instanceContext( context, branchPath );
+		ContextPtr ic = instanceContext( context, parentPath, branchPath, instancePlug()->childNamesPlug() );
 		Context::Scope scopedContext( ic.get() );
 		return instancePlug()->childNamesPlug()->getValue();
 	}
 }
 
-ConstV3fVectorDataPtr Instancer::sourcePoints( const ScenePath &parentPath ) const
+Instancer::ConstInstancesPtr Instancer::instances( const ScenePath &parentPath ) const
 {
 	ConstPrimitivePtr primitive = runTimeCast<const Primitive>( inPlug()->object( parentPath ) );
-	if( !primitive )
+
+	const std::string prototypeIndex = prototypeIndexPlug()->getValue();
+	ConstInternedStringVectorDataPtr prototypeNames;
+	if( !prototypeIndex.empty() )
 	{
-		return 0;
+		prototypeNames = instancePlug()->childNames( ScenePath() );
 	}
 
-	return primitive->variableData<V3fVectorData>( "P" );
+	return new Instances( primitive, prototypeNames.get(), prototypeIndex, orientationPlug()->getValue(), scalePlug()->getValue() );
+}
+
+void Instancer::hashInstances( const ScenePath &parentPath, IECore::MurmurHash &h ) const
+{
+	h.append( inPlug()->objectHash( parentPath ) );
+	prototypeIndexPlug()->hash( h );
+	orientationPlug()->hash( h );
+	scalePlug()->hash( h );
+	if( !prototypeIndexPlug()->getValue().empty() )
+	{
+		h.append( instancePlug()->childNamesHash( ScenePath() ) );
+	}
 }
 
 int Instancer::instanceIndex( const ScenePath &branchPath ) const
@@ -468,37 +1103,152 @@ int Instancer::instanceIndex( const ScenePath &branchPath ) const
 	return boost::lexical_cast<int>( branchPath[1].value() );
 }
 
-Gaffer::ContextPtr Instancer::instanceContext( const Gaffer::Context *parentContext, const ScenePath &branchPath ) const
+Gaffer::ContextPtr Instancer::instanceContext( const Gaffer::Context *parentContext, const ScenePath &parentPath, const ScenePath &branchPath, const Gaffer::ValuePlug *plug ) const
 {
 	assert( branchPath.size() >= 2 );
 
+	const int index = instanceIndex( branchPath );
+
+	// This is called for every location beneath every instance, so we
+	// avoid the cost of resolving all the primitive variables via
+	// instances(), and look up only the prototype for this instance.
+	ScenePath instancePath;
+	size_t prototypeIndex = 0;
+	const std::string prototypeIndexName = prototypeIndexPlug()->getValue();
+	if( !prototypeIndexName.empty() )
+	{
+		ConstPrimitivePtr primitive = runTimeCast<const Primitive>( inPlug()->object( parentPath ) );
+		const V3fVectorData *p = primitive ? primitive->variableData<V3fVectorData>( "P" ) : NULL;
+		ConstInternedStringVectorDataPtr prototypeNames = instancePlug()->childNames( ScenePath() );
+		if( !p || index < 0 || (size_t)index >= p->readable().size() || prototypeNames->readable().empty() )
+		{
+			throw IECore::Exception( boost::str( boost::format( "Instance %d does not exist" ) % index ) );
+		}
+
+		const vector<int> &indices = prototypeIndices( primitive.get(), prototypeIndexName, p->readable().size() );
+		const vector<InternedString> &names = prototypeNames->readable();
+		prototypeIndex = wrapPrototypeIndex( indices[index], names.size() );
+		instancePath.push_back( names[prototypeIndex] );
+	}
+	instancePath.insert( instancePath.end(), branchPath.begin() + 2, branchPath.end() );
+
 	ContextPtr result = new Context( *parentContext, Context::Borrowed );
-	fillInstanceContext( result.get(), branchPath );
+	fillInstanceContext( result.get(), instancePath, index, prototypeIdDependencies( parentContext )->readable()[prototypeIndex], plug );
 
 	return result;
 }
 
-void Instancer::fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &branchPath ) const
+void Instancer::fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &instancePath, int instanceId, int idDependencies, const Gaffer::ValuePlug *plug ) const
 {
-	assert( branchPath.size() >= 2 );
+	instanceContext->set( ScenePlug::scenePathContextName, instancePath );
 
-	fillInstanceContext( instanceContext, branchPath, instanceIndex( branchPath ) );
+	// Most prototypes don't vary per instance, in which case we
+	// evaluate every instance with the same id. This means that
+	// the prototype is computed only once and then shared via the
+	// cache, and it also gives identical hashes to identical
+	// instances, allowing renderers to instance them.
+	const bool dependsOnId = idDependencies & idDependency( instancePlug(), plug );
+	instanceContext->set( g_idContextName, dependsOnId ? instanceId : 0 );
 }
 
-void Instancer::fillInstanceContext( Gaffer::Context *instanceContext, const ScenePath &branchPath, int instanceId ) const
+IECore::ConstIntVectorDataPtr Instancer::prototypeIdDependencies( const Gaffer::Context *context ) const
 {
-	assert( branchPath.size() >= 2 );
-
-	ScenePath instancePath;
-	instancePath.insert( instancePath.end(), branchPath.begin() + 2, branchPath.end() );
-	instanceContext->set( ScenePlug::scenePathContextName, instancePath );
+	// The dependencies are the same for every location, so we
+	// remove the location from the context, allowing a single
+	// cached value to be shared by all of them.
+	ContextPtr c = new Context( *context, Context::Borrowed );
+	c->remove( ScenePlug::scenePathContextName );
+	Context::Scope scopedContext( c.get() );
+	return boost::static_pointer_cast<const IntVectorData>( prototypeIdDependenciesPlug()->getValue() );
+}
 
-	instanceContext->set( "instancer:id", instanceId );
+bool Instancer::prototypesDependOnId( const std::vector<int> &idDependencies ) const
+{
+	for( vector<int>::const_iterator it = idDependencies.begin(), eIt = idDependencies.end(); it != eIt; ++it )
+	{
+		if( *it & ( BoundDependsOnId | TransformDependsOnId ) )
+		{
+			return true;
+		}
+	}
+	return false;
 }
 
-Imath::M44f Instancer::instanceTransform( const IECore::V3fVectorData *p, int instanceId ) const
+struct Instancer::PrototypeHash
 {
-	M44f result;
-	result.translate( p->readable()[instanceId] );
-	return result;
+
+	PrototypeHash( const Instancer *instancer, const Instances *instances, size_t prototypeIndex, const Context *c )
+		:	m_instancer( instancer ), m_instances( instances ), m_prototypeIndex( prototypeIndex ), m_context( c ), m_hash()
+	{
+	}
+
+	PrototypeHash( const PrototypeHash &rhs, split )
+		:	m_instancer( rhs.m_instancer ), m_instances( rhs.m_instances ), m_prototypeIndex( rhs.m_prototypeIndex ), m_context( rhs.m_context ), m_hash()
+	{
+	}
+
+	void operator() ( const blocked_range<size_t> &r )
+	{
+		ContextPtr ic = new Context( *m_context, Context::Borrowed );
+		Context::Scope scopedContext( ic.get() );
+
+		const ScenePath &prototypeRoot = m_instances->prototypeRoot( m_prototypeIndex );
+		for( size_t i=r.begin(); i!=r.end(); ++i )
+		{
+			if( m_instances->prototypeIndex( i ) == m_prototypeIndex )
+			{
+				ic->set( g_idContextName, (int)i );
+				hashHierarchy( m_instancer->instancePlug(), prototypeRoot, m_hash );
+			}
+		}
+	}
+
+	void join( const PrototypeHash &rhs )
+	{
+		m_hash.append( rhs.m_hash );
+	}
+
+	const MurmurHash &result()
+	{
+		return m_hash;
+	}
+
+	private :
+
+		const Instancer *m_instancer;
+		const Instances *m_instances;
+		size_t m_prototypeIndex;
+		const Context *m_context;
+		MurmurHash m_hash;
+
+};
+
+void Instancer::hashPrototypes( const Instances *instances, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	ConstIntVectorDataPtr idDependencies = prototypeIdDependencies( context );
+
+	ContextPtr ic = new Context( *context, Context::Borrowed );
+	ic->set( g_idContextName, 0 );
+
+	for( size_t i = 0; i < instances->numPrototypes(); ++i )
+	{
+		const ScenePath &prototypeRoot = instances->prototypeRoot( i );
+
+		if( !idDependencies->readable()[i] )
+		{
+			// All instances share the same hash.
+			Context::Scope scopedContext( ic.get() );
+			hashHierarchy( instancePlug(), prototypeRoot, h );
+			continue;
+		}
+
+		// We have no choice but to hash every instance
+		// of the prototype.
+		PrototypeHash hasher( this, instances, i, context );
+		parallel_deterministic_reduce(
+			blocked_range<size_t>( 0, instances->numInstances(), 100 ),
+			hasher
+		);
+		h.append( hasher.result() );
+	}
 }
@@ -0,0 +1,184 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/format.hpp"
+
+#include "IECore/Renderer.h"
+#include "IECore/AttributeBlock.h"
+#include "IECore/Exception.h"
+
+#include "GafferScene/InstancerCapsule.h"
+#include "GafferScene/SceneProcedural.h"
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+using namespace Gaffer;
+using namespace GafferScene;
+
+IE_CORE_DEFINEOBJECTTYPEDESCRIPTION( InstancerCapsule );
+
+static InternedString g_idContextName( "instancer:id" );
+
+InstancerCapsule::InstancerCapsule()
+{
+}
+
+InstancerCapsule::InstancerCapsule( const ScenePlug *prototypesScene, Instancer::ConstInstancesPtr instances, const Gaffer::Context *context, const IECore::MurmurHash &hash, const Imath::Box3f &bound )
+	:	m_prototypesScene( prototypesScene ), m_instances( instances ), m_context( new Context( *context, Context::Copied, /* tracked = */ false ) ), m_hash( hash ), m_bound( bound )
+{
+}
+
+InstancerCapsule::~InstancerCapsule()
+{
+}
+
+const ScenePlug *InstancerCapsule::prototypesScene() const
+{
+	return m_prototypesScene.get();
+}
+
+size_t InstancerCapsule::numInstances() const
+{
+	return m_instances ? m_instances->numInstances() : 0;
+}
+
+const ScenePlug::ScenePath &InstancerCapsule::prototypeRoot( size_t instanceId ) const
+{
+	checkInstanceId( instanceId );
+	return m_instances->prototypeRoot( m_instances->prototypeIndex( instanceId ) );
+}
+
+Imath::M44f InstancerCapsule::instanceTransform( size_t instanceId ) const
+{
+	checkInstanceId( instanceId );
+	return m_instances->transform( instanceId );
+}
+
+Gaffer::ContextPtr InstancerCapsule::instanceContext( size_t instanceId ) const
+{
+	checkInstanceId( instanceId );
+	ContextPtr result = new Context( *m_context, Context::Copied, /* tracked = */ false );
+	result->set( g_idContextName, static_cast<int>( instanceId ) );
+	return result;
+}
+
+void InstancerCapsule::checkInstanceId( size_t instanceId ) const
+{
+	// A default constructed capsule has no instances,
+	// so this also protects against null dereferences.
+	if( instanceId >= numInstances() )
+	{
+		throw IECore::InvalidArgumentException( boost::str(
+			boost::format( "Instance id %d out of range (capsule has %d instances)" ) % instanceId % numInstances()
+		) );
+	}
+}
+
+void InstancerCapsule::render( IECore::Renderer *renderer ) const
+{
+	for( size_t i = 0, e = numInstances(); i < e; ++i )
+	{
+		AttributeBlock attributeBlock( renderer );
+		renderer->concatTransform( instanceTransform( i ) );
+		ContextPtr context = instanceContext( i );
+		renderer->procedural( new SceneProcedural( prototypesScene(), context.get(), prototypeRoot( i ) ) );
+	}
+}
+
+Imath::Box3f InstancerCapsule::bound() const
+{
+	return m_bound;
+}
+
+bool InstancerCapsule::isEqualTo( const IECore::Object *other ) const
+{
+	if( !VisibleRenderable::isEqualTo( other ) )
+	{
+		return false;
+	}
+
+	const InstancerCapsule *capsule = static_cast<const InstancerCapsule *>( other );
+	return m_prototypesScene == capsule->m_prototypesScene && m_hash == capsule->m_hash;
+}
+
+void InstancerCapsule::hash( IECore::MurmurHash &h ) const
+{
+	VisibleRenderable::hash( h );
+	h.append( m_hash );
+}
+
+void InstancerCapsule::copyFrom( const IECore::Object *other, IECore::Object::CopyContext *context )
+{
+	VisibleRenderable::copyFrom( other, context );
+
+	const InstancerCapsule *capsule = static_cast<const InstancerCapsule *>( other );
+	m_prototypesScene = capsule->m_prototypesScene;
+	m_instances = capsule->m_instances;
+	m_context = capsule->m_context;
+	m_hash = capsule->m_hash;
+	m_bound = capsule->m_bound;
+}
+
+void InstancerCapsule::save( IECore::Object::SaveContext *context ) const
+{
+	throw IECore::NotImplementedException( "InstancerCapsule::save" );
+}
+
+void InstancerCapsule::load( IECore::Object::LoadContextPtr context )
+{
+	throw IECore::NotImplementedException( "InstancerCapsule::load" );
+}
+
+void InstancerCapsule::memoryUsage( IECore::Object::MemoryAccumulator &accumulator ) const
+{
+	VisibleRenderable::memoryUsage( accumulator );
+	accumulator.accumulate( sizeof( InstancerCapsule ) );
+	if( m_instances )
+	{
+		m_instances->memoryUsage( accumulator );
+	}
+	if( m_context )
+	{
+		accumulator.accumulate( sizeof( Context ) );
+		vector<InternedString> names;
+		m_context->names( names );
+		for( vector<InternedString>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+		{
+			accumulator.accumulate( m_context->get<Data>( *it ) );
+		}
+	}
+}
@@ -52,6 +52,7 @@
 #include "GafferScene/SceneAlgo.h"
 #include "GafferScene/PathMatcherData.h"
 #include "GafferScene/SceneNode.h"
+#include "GafferScene/InstancerCapsule.h"
 
 using namespace std;
 using namespace Imath;
@@ -211,6 +212,8 @@ class InteractiveRender::SceneGraph
 			}
 
 			m_objectInterface = NULL;
+			m_capsule = NULL;
+			m_capsuleInterfaces.clear();
 			IECore::ConstObjectPtr object = objectPlug->getValue( &objectHash );
 			m_objectHash = objectHash;
 
@@ -235,9 +238,16 @@ class InteractiveRender::SceneGraph
 			{
 				m_objectInterface = renderer->light( name, nullObject ? NULL : object.get() );
 			}
+			else if( const InstancerCapsule *capsule = runTimeCast<const InstancerCapsule>( object.get() ) )
+			{
+				// The instances inherit our transform and attributes, so
+				// we defer their output until finalise().
+				m_capsule = capsule;
+				m_capsuleName = name;
+			}
 			else
 			{
-				m_objectInterface = renderer->object( name, object.get() );
+				m_objectInterface = renderer->instance( name, object.get(), objectHash );
 			}
 
 			m_pending = m_pending | ObjectPending;
@@ -281,8 +291,18 @@ class InteractiveRender::SceneGraph
 		// the situation where we update attributes, apply them
 		// to the current object, then replace the object and have
 		// to apply the attributes to the new object.
-		void finalise( IECoreScenePreview::Renderer *renderer )
+		void finalise( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals )
 		{
+			if( m_capsule && ( m_pending & ( TransformPending | AttributesPending | ObjectPending ) ) )
+			{
+				// The expanded instances can't be edited in place, because
+				// their transforms and attributes are combined with those of
+				// the prototypes. So we output them again from scratch,
+				// releasing the old ones first so that the names are free.
+				m_capsuleInterfaces.clear();
+				outputCapsule( m_capsule.get(), m_capsuleName, m_fullTransform, m_fullAttributes.get(), globals, renderer, m_capsuleInterfaces );
+			}
+
 			if( m_objectInterface )
 			{
 				if( m_pending & ( TransformPending | ObjectPending ) )
@@ -339,6 +359,8 @@ class InteractiveRender::SceneGraph
 		void clearObject()
 		{
 			m_objectInterface = NULL;
+			m_capsule = NULL;
+			m_capsuleInterfaces.clear();
 			m_objectHash = MurmurHash();
 		}
 
@@ -383,6 +405,11 @@ class InteractiveRender::SceneGraph
 
 		IECore::MurmurHash m_objectHash;
 		IECoreScenePreview::Renderer::ObjectInterfacePtr m_objectInterface;
+		// Used in place of m_objectInterface when the object
+		// is an InstancerCapsule.
+		ConstInstancerCapsulePtr m_capsule;
+		std::string m_capsuleName;
+		std::vector<IECoreScenePreview::Renderer::ObjectInterfacePtr> m_capsuleInterfaces;
 
 		IECore::MurmurHash m_attributesHash;
 		IECore::CompoundObjectPtr m_fullAttributes;
@@ -543,7 +570,7 @@ class InteractiveRender::SceneGraphUpdateTask : public tbb::task
 			// Finally give the SceneGraph an opportunity to finalise
 			// everything so the renderer is totally up to date.
 
-			m_sceneGraph->finalise( m_interactiveRender->m_renderer.get() );
+			m_sceneGraph->finalise( m_interactiveRender->m_renderer.get(), m_interactiveRender->m_globals.get() );
 
 			return NULL;
 		}
@@ -696,6 +723,11 @@ void InteractiveRender::setContext( Gaffer::ContextPtr context )
 	);
 }
 
+IECoreScenePreview::Renderer *InteractiveRender::renderer()
+{
+	return m_renderer.get();
+}
+
 void InteractiveRender::plugDirtied( const Gaffer::Plug *plug )
 {
 
@@ -36,8 +36,11 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "tbb/task.h"
+#include "tbb/parallel_for.h"
+#include "tbb/concurrent_vector.h"
 
 #include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
 
 #include "IECore/Interpolator.h"
 #include "IECore/NullObject.h"
@@ -48,6 +51,7 @@
 #include "GafferScene/ScenePlug.h"
 #include "GafferScene/SceneAlgo.h"
 #include "GafferScene/RendererAlgo.h"
+#include "GafferScene/InstancerCapsule.h"
 
 using namespace std;
 using namespace Imath;
@@ -202,17 +206,19 @@ struct LocationOutput
 	LocationOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals )
 		:	m_renderer( renderer ), m_attributes( globalAttributes( globals ) )
 	{
-		const BoolData *transformBlurData = globals->member<BoolData>( g_transformBlurOptionName );
-		m_options.transformBlur = transformBlurData ? transformBlurData->readable() : false;
-
-		const BoolData *deformationBlurData = globals->member<BoolData>( g_deformationBlurOptionName );
-		m_options.deformationBlur = deformationBlurData ? deformationBlurData->readable() : false;
-
-		m_options.shutter = GafferScene::shutter( globals );
-
+		initOptions( globals );
 		m_transformSamples.push_back( M44f() );
 	}
 
+	// Constructs an output which starts from the specified transform
+	// and attributes rather than from the root of the scene.
+	LocationOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, const M44f &transform, const IECore::CompoundObject *attributes )
+		:	m_renderer( renderer ), m_attributes( attributes )
+	{
+		initOptions( globals );
+		m_transformSamples.push_back( transform );
+	}
+
 	bool operator()( const ScenePlug *scene, const ScenePlug::ScenePath &path )
 	{
 		updateAttributes( scene );
@@ -277,6 +283,17 @@ struct LocationOutput
 
 	private :
 
+		void initOptions( const IECore::CompoundObject *globals )
+		{
+			const BoolData *transformBlurData = globals->member<BoolData>( g_transformBlurOptionName );
+			m_options.transformBlur = transformBlurData ? transformBlurData->readable() : false;
+
+			const BoolData *deformationBlurData = globals->member<BoolData>( g_deformationBlurOptionName );
+			m_options.deformationBlur = deformationBlurData ? deformationBlurData->readable() : false;
+
+			m_options.shutter = GafferScene::shutter( globals );
+		}
+
 		size_t motionSegments( bool motionBlur, const InternedString &attributeName, const InternedString &segmentsAttributeName ) const
 		{
 			if( !motionBlur )
@@ -475,11 +492,23 @@ struct LightOutput : public LocationOutput
 
 };
 
+const PathMatcher g_emptyPathMatcher;
+
 struct ObjectOutput : public LocationOutput
 {
 
+	typedef tbb::concurrent_vector<IECoreScenePreview::Renderer::ObjectInterfacePtr> ObjectInterfaces;
+
 	ObjectOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, const PathMatcher &cameraSet, const PathMatcher &lightSet )
-		:	LocationOutput( renderer, globals ), m_cameraSet( cameraSet ), m_lightSet( lightSet )
+		:	LocationOutput( renderer, globals ), m_cameraSet( cameraSet ), m_lightSet( lightSet ), m_inCapsule( false ), m_prototypeRootSize( 0 ), m_objectInterfaces( NULL )
+	{
+	}
+
+	// Constructs an output for expanding a capsule at a location with the
+	// specified transform and attributes. The interfaces for all objects
+	// output are stored in `objectInterfaces`.
+	ObjectOutput( IECoreScenePreview::Renderer *renderer, const IECore::CompoundObject *globals, const M44f &transform, const IECore::CompoundObject *attributes, ObjectInterfaces &objectInterfaces )
+		:	LocationOutput( renderer, globals, transform, attributes ), m_cameraSet( g_emptyPathMatcher ), m_lightSet( g_emptyPathMatcher ), m_inCapsule( false ), m_prototypeRootSize( 0 ), m_objectInterfaces( &objectInterfaces )
 	{
 	}
 
@@ -490,24 +519,34 @@ struct ObjectOutput : public LocationOutput
 			return false;
 		}
 
-		if( ( m_cameraSet.match( path ) & Filter::ExactMatch ) || ( m_lightSet.match( path ) & Filter::ExactMatch ) )
+		// The camera and light sets refer to paths in the main
+		// scene, so don't apply when we're inside a capsule.
+		if( !m_inCapsule && ( ( m_cameraSet.match( path ) & Filter::ExactMatch ) || ( m_lightSet.match( path ) & Filter::ExactMatch ) ) )
 		{
 			return true;
 		}
 
-		vector<ConstVisibleRenderablePtr> samples; set<float> sampleTimes;
-		objectSamples( scene, deformationSegments(), shutter(), samples, sampleTimes );
+		// We output objects as instances, identified by their hash, so that
+		// renderers can share a single copy between all the locations with
+		// identical objects (from Duplicate or Instancer, for example).
+		vector<ConstVisibleRenderablePtr> samples; set<float> sampleTimes; MurmurHash hash;
+		objectSamples( scene, deformationSegments(), shutter(), samples, sampleTimes, &hash );
 		if( !samples.size() )
 		{
 			return true;
 		}
 
-		std::string name;
-		ScenePlug::pathToString( path, name );
+		std::string name = this->name( path );
+		if( const InstancerCapsule *capsule = runTimeCast<const InstancerCapsule>( samples[0].get() ) )
+		{
+			outputCapsule( capsule, name );
+			return true;
+		}
+
 		IECoreScenePreview::Renderer::ObjectInterfacePtr objectInterface;
 		if( !sampleTimes.size() )
 		{
-			objectInterface = renderer()->object( name, samples[0].get() );
+			objectInterface = renderer()->instance( name, samples[0].get(), hash );
 		}
 		else
 		{
@@ -518,17 +557,98 @@ struct ObjectOutput : public LocationOutput
 			{
 				objectsVector.push_back( it->get() );
 			}
-			objectInterface = renderer()->object( name, objectsVector, timesVector );
+			objectInterface = renderer()->instance( name, objectsVector, timesVector, hash );
 		}
 
 		applyAttributes( objectInterface.get() );
 		applyTransform( objectInterface.get() );
 
+		if( m_objectInterfaces )
+		{
+			m_objectInterfaces->push_back( objectInterface );
+		}
+
 		return true;
 	}
 
-	const PathMatcher &m_cameraSet;
-	const PathMatcher &m_lightSet;
+	// Expands the instances held by an InstancerCapsule, outputting
+	// each prototype hierarchy beneath the capsule's location. Because
+	// objects are output via Renderer::instance(), the renderer need
+	// only hold a single copy of each distinct prototype object.
+	void outputCapsule( const InstancerCapsule *capsule, const std::string &name )
+	{
+		if( !capsule->prototypesScene() )
+		{
+			return;
+		}
+
+		CapsuleOutput capsuleOutput( capsule, name, *this );
+		tbb::parallel_for( tbb::blocked_range<size_t>( 0, capsule->numInstances() ), capsuleOutput );
+	}
+
+	private :
+
+		std::string name( const ScenePlug::ScenePath &path ) const
+		{
+			if( !m_inCapsule )
+			{
+				std::string result;
+				ScenePlug::pathToString( path, result );
+				return result;
+			}
+
+			std::string result = m_namePrefix;
+			for( ScenePlug::ScenePath::const_iterator it = path.begin() + m_prototypeRootSize, eIt = path.end(); it != eIt; ++it )
+			{
+				result += "/" + it->string();
+			}
+			return result;
+		}
+
+		struct CapsuleOutput
+		{
+
+			CapsuleOutput( const InstancerCapsule *capsule, const std::string &name, const ObjectOutput &parent )
+				:	m_capsule( capsule ), m_name( name ), m_parent( parent )
+			{
+			}
+
+			void operator()( const tbb::blocked_range<size_t> &r ) const
+			{
+				const ScenePlug *prototypesScene = m_capsule->prototypesScene();
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					const ScenePlug::ScenePath &prototypeRoot = m_capsule->prototypeRoot( i );
+
+					ObjectOutput instanceOutput( m_parent );
+					instanceOutput.m_inCapsule = true;
+					instanceOutput.m_namePrefix = m_name + "/" + boost::lexical_cast<std::string>( i );
+					instanceOutput.m_prototypeRootSize = prototypeRoot.size();
+					instanceOutput.concatenateTransform( m_capsule->instanceTransform( i ) );
+
+					Gaffer::ContextPtr context = m_capsule->instanceContext( i );
+					GafferScene::Filter::setInputScene( context.get(), prototypesScene );
+					LocationTask<ObjectOutput> *task = new( tbb::task::allocate_root() ) LocationTask<ObjectOutput>( prototypesScene, context.get(), prototypeRoot, instanceOutput );
+					tbb::task::spawn_root_and_wait( *task );
+				}
+			}
+
+			private :
+
+				const InstancerCapsule *m_capsule;
+				const std::string &m_name;
+				const ObjectOutput &m_parent;
+
+		};
+
+		const PathMatcher &m_cameraSet;
+		const PathMatcher &m_lightSet;
+
+		bool m_inCapsule;
+		std::string m_namePrefix;
+		size_t m_prototypeRootSize;
+
+		ObjectInterfaces *m_objectInterfaces;
 
 };
 
@@ -711,6 +831,14 @@ void outputObjects( const ScenePlug *scene, const IECore::CompoundObject *global
 	parallelProcessLocations( scene, output );
 }
 
+void outputCapsule( const InstancerCapsule *capsule, const std::string &name, const Imath::M44f &transform, const IECore::CompoundObject *attributes, const IECore::CompoundObject *globals, IECoreScenePreview::Renderer *renderer, std::vector<IECoreScenePreview::Renderer::ObjectInterfacePtr> &objectInterfaces )
+{
+	ObjectOutput::ObjectInterfaces outputInterfaces;
+	ObjectOutput output( renderer, globals, transform, attributes, outputInterfaces );
+	output.outputCapsule( capsule, name );
+	objectInterfaces.insert( objectInterfaces.end(), outputInterfaces.begin(), outputInterfaces.end() );
+}
+
 } // namespace Preview
 
 } // namespace GafferScene
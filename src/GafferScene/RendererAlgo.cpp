@@ -507,18 +507,23 @@ void outputTransform( const ScenePlug *scene, IECore::Renderer *renderer, size_t
 	}
 }
 
-void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &shutter, std::vector<IECore::ConstVisibleRenderablePtr> &samples, std::set<float> &sampleTimes )
+void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &shutter, std::vector<IECore::ConstVisibleRenderablePtr> &samples, std::set<float> &sampleTimes, IECore::MurmurHash *hash )
 {
 
 	// Static case
 
 	if( !segments )
 	{
-		ConstObjectPtr object = scene->objectPlug()->getValue();
+		const MurmurHash objectHash = scene->objectPlug()->hash();
+		ConstObjectPtr object = scene->objectPlug()->getValue( &objectHash );
 		if( const VisibleRenderable *renderable = runTimeCast<const VisibleRenderable>( object.get() ) )
 		{
 			samples.push_back( renderable );
 		}
+		if( hash )
+		{
+			*hash = objectHash;
+		}
 		return;
 	}
 
@@ -531,6 +536,8 @@ void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &s
 
 	bool moving = false;
 	MurmurHash lastHash;
+	MurmurHash firstHash;
+	MurmurHash combinedHash;
 	samples.reserve( sampleTimes.size() );
 	for( std::set<float>::const_iterator it = sampleTimes.begin(), eIt = sampleTimes.end(); it != eIt; ++it )
 	{
@@ -547,14 +554,26 @@ void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &s
 			{
 				moving = true;
 			}
+			if( samples.empty() )
+			{
+				firstHash = objectHash;
+			}
 			samples.push_back( primitive );
 			lastHash = objectHash;
+			combinedHash.append( objectHash );
+			combinedHash.append( *it );
 		}
 		else if( const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( object.get() ) )
 		{
 			// We can't motion blur these chappies, so just take the one
 			// sample.
+			if( samples.empty() )
+			{
+				firstHash = objectHash;
+			}
 			samples.push_back( renderable );
+			combinedHash.append( objectHash );
+			combinedHash.append( *it );
 			break;
 		}
 		else
@@ -570,6 +589,11 @@ void objectSamples( const ScenePlug *scene, size_t segments, const Imath::V2f &s
 		samples.resize( std::min<size_t>( samples.size(), 1 ) );
 		sampleTimes.clear();
 	}
+
+	if( hash )
+	{
+		*hash = moving ? combinedHash : firstHash;
+	}
 }
 
 void outputObject( const ScenePlug *scene, IECore::Renderer *renderer, size_t segments, const Imath::V2f &shutter )
@@ -309,6 +309,18 @@ void SceneNode::compute( ValuePlug *output, const Context *context ) const
 	}
 }
 
+ValuePlug::CachePolicy SceneNode::computeCachePolicy( const ValuePlug *output ) const
+{
+	if( const ScenePlug *scenePlug = output->parent<ScenePlug>() )
+	{
+		if( output == scenePlug->transformPlug() || output == scenePlug->attributesPlug() )
+		{
+			return ValuePlug::Standard;
+		}
+	}
+	return ComputeNode::computeCachePolicy( output );
+}
+
 Imath::Box3f SceneNode::computeBound( const ScenePath &path, const Gaffer::Context *context, const ScenePlug *parent ) const
 {
 	throw IECore::NotImplementedException( string( typeName() ) + "::computeBound" );
@@ -0,0 +1,108 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "boost/python.hpp"
+
+#include "IECorePython/RunTimeTypedBinding.h"
+
+#include "GafferBindings/DependencyNodeBinding.h"
+
+#include "GafferScene/Instancer.h"
+#include "GafferScene/InstancerCapsule.h"
+
+#include "GafferSceneBindings/InstancerBinding.h"
+
+using namespace boost::python;
+using namespace GafferScene;
+
+namespace
+{
+
+ScenePlugPtr prototypesScene( const InstancerCapsule &capsule )
+{
+	return const_cast<ScenePlug *>( capsule.prototypesScene() );
+}
+
+std::string prototypeRoot( const InstancerCapsule &capsule, size_t instanceId )
+{
+	if( instanceId >= capsule.numInstances() )
+	{
+		PyErr_SetString( PyExc_IndexError, "Instance id out of range" );
+		throw_error_already_set();
+	}
+
+	std::string result;
+	ScenePlug::pathToString( capsule.prototypeRoot( instanceId ), result );
+	return result;
+}
+
+Imath::M44f instanceTransform( const InstancerCapsule &capsule, size_t instanceId )
+{
+	if( instanceId >= capsule.numInstances() )
+	{
+		PyErr_SetString( PyExc_IndexError, "Instance id out of range" );
+		throw_error_already_set();
+	}
+
+	return capsule.instanceTransform( instanceId );
+}
+
+Gaffer::ContextPtr instanceContext( const InstancerCapsule &capsule, size_t instanceId )
+{
+	if( instanceId >= capsule.numInstances() )
+	{
+		PyErr_SetString( PyExc_IndexError, "Instance id out of range" );
+		throw_error_already_set();
+	}
+
+	return capsule.instanceContext( instanceId );
+}
+
+} // namespace
+
+void GafferSceneBindings::bindInstancer()
+{
+	GafferBindings::DependencyNodeClass<Instancer>();
+
+	IECorePython::RunTimeTypedClass<InstancerCapsule>()
+		.def( init<>() )
+		.def( "prototypesScene", &prototypesScene )
+		.def( "numInstances", &InstancerCapsule::numInstances )
+		.def( "prototypeRoot", &prototypeRoot )
+		.def( "instanceTransform", &instanceTransform )
+		.def( "instanceContext", &instanceContext )
+	;
+}
@@ -36,6 +36,8 @@
 
 #include "boost/python.hpp"
 
+#include "IECorePython/ScopedGILRelease.h"
+
 #include "Gaffer/Context.h"
 
 #include "GafferDispatchBindings/ExecutableNodeBinding.h"
@@ -44,7 +46,10 @@
 #include "GafferScene/InteractiveRender.h"
 #include "GafferScene/Preview/Render.h"
 #include "GafferScene/Preview/InteractiveRender.h"
+#include "GafferScene/Preview/RendererAlgo.h"
 #include "GafferScene/Private/IECoreScenePreview/Renderer.h"
+#include "GafferScene/Private/IECoreScenePreview/CapturingRenderer.h"
+#include "GafferScene/Private/IECoreScenePreview/NullRenderer.h"
 
 #include "GafferSceneBindings/RenderBinding.h"
 
@@ -124,6 +129,11 @@ ContextPtr previewInteractiveRenderGetContext( Preview::InteractiveRender &r )
 	return r.getContext();
 }
 
+IECoreScenePreview::RendererPtr previewInteractiveRenderRenderer( Preview::InteractiveRender &r )
+{
+	return r.renderer();
+}
+
 list rendererTypes()
 {
 	std::vector<IECore::InternedString> t = Renderer::types();
@@ -135,6 +145,12 @@ list rendererTypes()
 	return result;
 }
 
+void rendererAlgoOutputObjects( const ScenePlug &scene, const IECore::CompoundObject &globals, Renderer &renderer )
+{
+	IECorePython::ScopedGILRelease gilRelease;
+	Preview::outputObjects( &scene, &globals, &renderer );
+}
+
 IECoreScenePreview::Renderer::ObjectInterfacePtr rendererObject1( Renderer &renderer, const std::string &name, const IECore::Object *object )
 {
 	return renderer.object( name, object );
@@ -151,6 +167,100 @@ IECoreScenePreview::Renderer::ObjectInterfacePtr rendererObject2( Renderer &rend
 	return renderer.object( name, samples, times );
 }
 
+IECoreScenePreview::Renderer::ObjectInterfacePtr rendererInstance1( Renderer &renderer, const std::string &name, const IECore::Object *object, const IECore::MurmurHash &hash )
+{
+	return renderer.instance( name, object, hash );
+}
+
+IECoreScenePreview::Renderer::ObjectInterfacePtr rendererInstance2( Renderer &renderer, const std::string &name, object pythonSamples, object pythonTimes, const IECore::MurmurHash &hash )
+{
+	std::vector<const IECore::Object *> samples;
+	container_utils::extend_container( samples, pythonSamples );
+
+	std::vector<float> times;
+	container_utils::extend_container( times, pythonTimes );
+
+	return renderer.instance( name, samples, times, hash );
+}
+
+IECore::DataPtr capturingRendererCapturedOption( const CapturingRenderer &renderer, const IECore::InternedString &name )
+{
+	const IECore::Data *d = renderer.capturedOption( name );
+	return d ? d->copy() : NULL;
+}
+
+IECore::DisplayPtr capturingRendererCapturedOutput( const CapturingRenderer &renderer, const IECore::InternedString &name )
+{
+	const Renderer::Output *o = renderer.capturedOutput( name );
+	return o ? o->copy() : NULL;
+}
+
+CapturingRenderer::CapturedObjectPtr capturingRendererCapturedObject( const CapturingRenderer &renderer, const std::string &name )
+{
+	return const_cast<CapturingRenderer::CapturedObject *>( renderer.capturedObject( name ) );
+}
+
+list capturingRendererCapturedObjectNames( const CapturingRenderer &renderer )
+{
+	const std::vector<std::string> names = renderer.capturedObjectNames();
+	list result;
+	for( std::vector<std::string>::const_iterator it = names.begin(), eIt = names.end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+IECore::CompoundObjectPtr capturedAttributesAttributes( const CapturingRenderer::CapturedAttributes &attributes )
+{
+	return attributes.attributes()->copy();
+}
+
+list capturedObjectCapturedSamples( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	for( std::vector<IECore::ConstObjectPtr>::const_iterator it = object.capturedSamples().begin(), eIt = object.capturedSamples().end(); it != eIt; ++it )
+	{
+		result.append( (*it)->copy() );
+	}
+	return result;
+}
+
+list capturedObjectCapturedSampleTimes( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	for( std::vector<float>::const_iterator it = object.capturedSampleTimes().begin(), eIt = object.capturedSampleTimes().end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+list capturedObjectCapturedTransforms( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	for( std::vector<Imath::M44f>::const_iterator it = object.capturedTransforms().begin(), eIt = object.capturedTransforms().end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+list capturedObjectCapturedTransformTimes( const CapturingRenderer::CapturedObject &object )
+{
+	list result;
+	for( std::vector<float>::const_iterator it = object.capturedTransformTimes().begin(), eIt = object.capturedTransformTimes().end(); it != eIt; ++it )
+	{
+		result.append( *it );
+	}
+	return result;
+}
+
+CapturingRenderer::CapturedAttributesPtr capturedObjectCapturedAttributes( const CapturingRenderer::CapturedObject &object )
+{
+	return const_cast<CapturingRenderer::CapturedAttributes *>( object.capturedAttributes() );
+}
+
 void objectInterfaceTransform1( Renderer::ObjectInterface &objectInterface, const Imath::M44f &transform )
 {
 	objectInterface.transform( transform );
@@ -198,6 +308,7 @@ void GafferSceneBindings::bindRender()
 			scope s = GafferBindings::NodeClass<GafferScene::Preview::InteractiveRender>()
 				.def( "getContext", &previewInteractiveRenderGetContext )
 				.def( "setContext", &GafferScene::Preview::InteractiveRender::setContext )
+				.def( "renderer", &previewInteractiveRenderRenderer )
 			;
 
 			enum_<GafferScene::Preview::InteractiveRender::State>( "State" )
@@ -216,6 +327,15 @@ void GafferSceneBindings::bindRender()
 			;
 		}
 
+		{
+			object rendererAlgoModule( borrowed( PyImport_AddModule( "GafferScene.Preview.RendererAlgo" ) ) );
+			scope().attr( "RendererAlgo" ) = rendererAlgoModule;
+
+			scope rendererAlgoScope( rendererAlgoModule );
+
+			def( "outputObjects", &rendererAlgoOutputObjects );
+		}
+
 	}
 
 	{
@@ -265,11 +385,46 @@ void GafferSceneBindings::bindRender()
 			.def( "object", &rendererObject1 )
 			.def( "object", &rendererObject2 )
 
+			.def( "instance", &rendererInstance1 )
+			.def( "instance", &rendererInstance2 )
+
 			.def( "render", &Renderer::render )
 			.def( "pause", &Renderer::pause )
 
 		;
 
+		{
+			scope s = IECorePython::RefCountedClass<CapturingRenderer, Renderer>( "CapturingRenderer" )
+				.def( init<Renderer::RenderType, const std::string &>( ( arg( "renderType" ) = Renderer::Interactive, arg( "fileName" ) = "" ) ) )
+				.def( "capturedOption", &capturingRendererCapturedOption )
+				.def( "capturedOutput", &capturingRendererCapturedOutput )
+				.def( "capturedObject", &capturingRendererCapturedObject )
+				.def( "capturedObjectNames", &capturingRendererCapturedObjectNames )
+				.def( "numRenders", &CapturingRenderer::numRenders )
+			;
+
+			IECorePython::RefCountedClass<CapturingRenderer::CapturedAttributes, Renderer::AttributesInterface>( "CapturedAttributes" )
+				.def( "attributes", &capturedAttributesAttributes )
+			;
+
+			IECorePython::RefCountedClass<CapturingRenderer::CapturedObject, Renderer::ObjectInterface>( "CapturedObject" )
+				.def( "capturedName", &CapturingRenderer::CapturedObject::capturedName, return_value_policy<copy_const_reference>() )
+				.def( "capturedSamples", &capturedObjectCapturedSamples )
+				.def( "capturedSampleTimes", &capturedObjectCapturedSampleTimes )
+				.def( "capturedHash", &CapturingRenderer::CapturedObject::capturedHash, return_value_policy<copy_const_reference>() )
+				.def( "capturedTransforms", &capturedObjectCapturedTransforms )
+				.def( "capturedTransformTimes", &capturedObjectCapturedTransformTimes )
+				.def( "capturedAttributes", &capturedObjectCapturedAttributes )
+				.def( "numTransformEdits", &CapturingRenderer::CapturedObject::numTransformEdits )
+				.def( "numAttributeEdits", &CapturingRenderer::CapturedObject::numAttributeEdits )
+			;
+		}
+
+		IECorePython::RefCountedClass<NullRenderer, Renderer>( "NullRenderer" )
+			.def( init<Renderer::RenderType, const std::string &>( ( arg( "renderType" ) = Renderer::Batch, arg( "fileName" ) = "" ) ) )
+			.def( "statistics", &NullRenderer::statistics )
+		;
+
 	}
 
 }
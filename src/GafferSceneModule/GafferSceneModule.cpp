@@ -92,6 +92,7 @@
 #include "GafferSceneBindings/CoordinateSystemBinding.h"
 #include "GafferSceneBindings/DeleteGlobalsBinding.h"
 #include "GafferSceneBindings/ExternalProceduralBinding.h"
+#include "GafferSceneBindings/InstancerBinding.h"
 #include "GafferSceneBindings/GroupBinding.h"
 #include "GafferSceneBindings/ScenePathBinding.h"
 #include "GafferSceneBindings/SceneFilterPathFilterBinding.h"
@@ -121,7 +122,7 @@ BOOST_PYTHON_MODULE( _GafferScene )
 	GafferBindings::DependencyNodeClass<Plane>();
 	GafferBindings::DependencyNodeClass<BranchCreator>();
 	GafferBindings::DependencyNodeClass<Seeds>();
-	GafferBindings::DependencyNodeClass<Instancer>();
+	bindInstancer();
 	GafferBindings::DependencyNodeClass<ObjectToScene>();
 	GafferBindings::DependencyNodeClass<Camera>();
 	GafferBindings::DependencyNodeClass<GlobalsProcessor>();
@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2016, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/NullObject.h"
+
+#include "IECoreGL/CachedConverter.h"
+#include "IECoreGL/Group.h"
+
+#include "GafferScene/InstancerCapsule.h"
+
+#include "GafferSceneUI/ObjectVisualiser.h"
+
+using namespace std;
+using namespace Imath;
+using namespace Gaffer;
+using namespace GafferScene;
+using namespace GafferSceneUI;
+
+namespace
+{
+
+IECore::InternedString g_idContextName( "instancer:id" );
+
+IECoreGL::ConstRenderablePtr objectToRenderable( const IECore::Object *object )
+{
+	if( const ObjectVisualiser *visualiser = ObjectVisualiser::acquire( object->typeId() ) )
+	{
+		return visualiser->visualise( object );
+	}
+
+	try
+	{
+		IECore::ConstRunTimeTypedPtr glObject = IECoreGL::CachedConverter::defaultCachedConverter()->convert( object );
+		return IECore::runTimeCast<const IECoreGL::Renderable>( glObject.get() );
+	}
+	catch( ... )
+	{
+		return NULL;
+	}
+}
+
+// Converts the hierarchy below `path`, which must be evaluated
+// in the current context.
+IECoreGL::GroupPtr hierarchyToGroup( const ScenePlug *scene, ScenePlug::ScenePath &path )
+{
+	IECoreGL::GroupPtr result = new IECoreGL::Group;
+	result->setTransform( scene->transform( path ) );
+
+	IECore::ConstObjectPtr object = scene->object( path );
+	if( !IECore::runTimeCast<const IECore::NullObject>( object.get() ) )
+	{
+		if( IECoreGL::ConstRenderablePtr renderable = objectToRenderable( object.get() ) )
+		{
+			result->addChild( boost::const_pointer_cast<IECoreGL::Renderable>( renderable ) );
+		}
+	}
+
+	IECore::ConstInternedStringVectorDataPtr childNamesData = scene->childNames( path );
+	const vector<IECore::InternedString> &childNames = childNamesData->readable();
+	for( vector<IECore::InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
+	{
+		path.push_back( *it );
+		result->addChild( hierarchyToGroup( scene, path ) );
+		path.pop_back();
+	}
+
+	return result;
+}
+
+class InstancerCapsuleVisualiser : public ObjectVisualiser
+{
+
+	public :
+
+		typedef GafferScene::InstancerCapsule ObjectType;
+
+		InstancerCapsuleVisualiser()
+		{
+		}
+
+		virtual ~InstancerCapsuleVisualiser()
+		{
+		}
+
+		virtual IECoreGL::ConstRenderablePtr visualise( const IECore::Object *object ) const
+		{
+			const InstancerCapsule *capsule = IECore::runTimeCast<const InstancerCapsule>( object );
+
+			IECoreGL::GroupPtr result = new IECoreGL::Group();
+			const ScenePlug *prototypesScene = capsule->prototypesScene();
+			if( !prototypesScene )
+			{
+				return result;
+			}
+
+			// We convert each prototype once and share the result between
+			// all the instances which use it, unless the prototype reads
+			// "instancer:id", in which case it must be converted separately
+			// for each instance.
+			typedef map<ScenePlug::ScenePath, Prototype> PrototypeMap;
+			PrototypeMap prototypes;
+
+			for( size_t i = 0, e = capsule->numInstances(); i < e; ++i )
+			{
+				const ScenePlug::ScenePath &prototypeRoot = capsule->prototypeRoot( i );
+				ScenePlug::ScenePath path = prototypeRoot;
+
+				IECoreGL::GroupPtr prototypeGroup;
+				PrototypeMap::iterator it = prototypes.find( prototypeRoot );
+				if( it == prototypes.end() )
+				{
+					ContextPtr context = capsule->instanceContext( i );
+					Context::ReadRecorder readRecorder( context.get() );
+					Context::Scope scopedContext( context.get() );
+
+					Prototype &prototype = prototypes[prototypeRoot];
+					prototype.group = hierarchyToGroup( prototypesScene, path );
+					prototype.dependsOnId = readRecorder.read( g_idContextName );
+					prototypeGroup = prototype.group;
+				}
+				else if( it->second.dependsOnId )
+				{
+					ContextPtr context = capsule->instanceContext( i );
+					Context::Scope scopedContext( context.get() );
+					prototypeGroup = hierarchyToGroup( prototypesScene, path );
+				}
+				else
+				{
+					prototypeGroup = it->second.group;
+				}
+
+				IECoreGL::GroupPtr instanceGroup = new IECoreGL::Group();
+				instanceGroup->setTransform( capsule->instanceTransform( i ) );
+				instanceGroup->addChild( prototypeGroup );
+				result->addChild( instanceGroup );
+			}
+
+			return result;
+		}
+
+	protected :
+
+		static ObjectVisualiserDescription<InstancerCapsuleVisualiser> g_visualiserDescription;
+
+	private :
+
+		struct Prototype
+		{
+			Prototype() : dependsOnId( false ) {}
+			IECoreGL::GroupPtr group;
+			bool dependsOnId;
+		};
+
+};
+
+ObjectVisualiser::ObjectVisualiserDescription<InstancerCapsuleVisualiser> InstancerCapsuleVisualiser::g_visualiserDescription;
+
+} // namespace
@@ -37,6 +37,8 @@
 #include "boost/lexical_cast.hpp"
 
 #include "IECore/Timer.h"
+#include "IECore/VectorTypedData.h"
+#include "IECore/CompoundData.h"
 
 #include "Gaffer/Context.h"
 
@@ -145,3 +147,101 @@ void GafferTest::testScopingNullContext()
 		}
 	}
 }
+
+namespace
+{
+
+// Adds variables of the sort that make context hashing expensive - the
+// sort of thing a wedge or a long list of user options might introduce.
+void addLargeVariables( Context *context )
+{
+	StringVectorDataPtr strings = new StringVectorData;
+	for( int i = 0; i < 1000; ++i )
+	{
+		strings->writable().push_back( string( "wedgeValue" ) + lexical_cast<string>( i ) );
+	}
+	context->set( "wedge:values", strings.get() );
+
+	CompoundDataPtr dict = new CompoundData;
+	for( int i = 0; i < 100; ++i )
+	{
+		dict->writable()[string( "option" ) + lexical_cast<string>( i )] = new FloatVectorData( vector<float>( 100, i ) );
+	}
+	context->set( "wedge:dict", dict.get() );
+}
+
+} // namespace
+
+// Useful for assessing the performance of Context::hash() when
+// traversing a scene, where only "scene:path" is changed for
+// each location visited.
+void GafferTest::testScenePathContextHashing()
+{
+	ContextPtr base = new Context();
+	addLargeVariables( base.get() );
+	base->hash();
+
+	vector<InternedString> path;
+	path.push_back( "a" );
+	path.push_back( "b" );
+	path.push_back( InternedString() );
+
+	Timer t;
+	for( int i = 0; i < 100000; ++i )
+	{
+		ContextPtr tmp = new Context( *base, Context::Borrowed );
+		path.back() = InternedString( i );
+		tmp->set( "scene:path", path );
+		tmp->hash();
+	}
+
+	// uncomment to get timing information
+	//std::cerr << t.stop() << std::endl;
+
+	// Check that the incrementally computed hash matches that
+	// of a context built and hashed from scratch, which shares
+	// no cached hashes with `base`.
+	ContextPtr tmp = new Context( *base, Context::Borrowed );
+	tmp->set( "scene:path", path );
+	ContextPtr fresh = new Context();
+	addLargeVariables( fresh.get() );
+	fresh->set( "scene:path", path );
+	GAFFERTEST_ASSERT( tmp->hash() == fresh->hash() );
+	GAFFERTEST_ASSERT( tmp->hash() != base->hash() );
+}
+
+// Useful for assessing the performance of Context::hash() when
+// processing an image, where "image:tileOrigin" and "image:channelName"
+// are changed for each tile.
+void GafferTest::testImageTileContextHashing()
+{
+	ContextPtr base = new Context();
+	addLargeVariables( base.get() );
+	base->hash();
+
+	const char *channelNames[] = { "R", "G", "B", "A" };
+
+	Timer t;
+	for( int i = 0; i < 100000; ++i )
+	{
+		ContextPtr tmp = new Context( *base, Context::Borrowed );
+		tmp->set( "image:tileOrigin", Imath::V2i( i * 64, 0 ) );
+		tmp->set( "image:channelName", string( channelNames[i%4] ) );
+		tmp->hash();
+	}
+
+	// uncomment to get timing information
+	//std::cerr << t.stop() << std::endl;
+
+	ContextPtr tmp = new Context( *base, Context::Borrowed );
+	tmp->set( "image:tileOrigin", Imath::V2i( 64, 128 ) );
+	const MurmurHash h = tmp->hash();
+	tmp->set( "image:channelName", string( "R" ) );
+	GAFFERTEST_ASSERT( tmp->hash() != h );
+
+	ContextPtr fresh = new Context();
+	addLargeVariables( fresh.get() );
+	fresh->set( "image:channelName", string( "R" ) );
+	fresh->set( "image:tileOrigin", Imath::V2i( 64, 128 ) );
+	GAFFERTEST_ASSERT( tmp->hash() == fresh->hash() );
+}
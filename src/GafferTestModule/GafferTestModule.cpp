@@ -68,6 +68,8 @@ BOOST_PYTHON_MODULE( _GafferTest )
 	def( "testManySubstitutions", &testManySubstitutions );
 	def( "testManyEnvironmentSubstitutions", &testManyEnvironmentSubstitutions );
 	def( "testScopingNullContext", &testScopingNullContext );
+	def( "testScenePathContextHashing", &testScenePathContextHashing );
+	def( "testImageTileContextHashing", &testImageTileContextHashing );
 	def( "testComputeNodeThreading", &testComputeNodeThreading );
 	def( "testDownstreamIterator", &testDownstreamIterator );
 
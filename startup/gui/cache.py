@@ -45,6 +45,7 @@ preferences["cache"] = Gaffer.CompoundPlug()
 preferences["cache"]["enabled"] = Gaffer.BoolPlug( defaultValue = True )
 preferences["cache"]["memoryLimit"] = Gaffer.IntPlug( defaultValue = Gaffer.ValuePlug.getCacheMemoryLimit() / ( 1024 * 1024 ) )
 preferences["cache"]["imageReaderMemoryLimit"] = Gaffer.IntPlug( defaultValue = GafferImage.OpenImageIOReader.getCacheMemoryLimit() )
+preferences["cache"]["hashCacheSizeLimit"] = Gaffer.IntPlug( defaultValue = Gaffer.ValuePlug.getHashCacheSizeLimit() )
 
 Gaffer.Metadata.registerPlugValue(
     preferences["cache"]["memoryLimit"],
@@ -62,6 +63,15 @@ Gaffer.Metadata.registerPlugValue(
     """
 )
 
+Gaffer.Metadata.registerPlugValue(
+    preferences["cache"]["hashCacheSizeLimit"],
+    "description",
+    """
+    Controls the maximum number of entries in Gaffer's hash cache,
+    which is shared between all threads.
+    """
+)
+
 
 # update cache settings when they change
 
@@ -77,6 +87,7 @@ def __plugSet( plug ) :
 		imageReaderMemoryLimit = 0
 
 	Gaffer.ValuePlug.setCacheMemoryLimit( memoryLimit )
+	Gaffer.ValuePlug.setHashCacheSizeLimit( plug["hashCacheSizeLimit"].getValue() )
 	GafferImage.OpenImageIOReader.setCacheMemoryLimit( imageReaderMemoryLimit )
 
 application.__cachePlugSetConnection = preferences.plugSetSignal().connect( __plugSet )